@@ -1,183 +1,150 @@
 using namespace std;
 
-#include <cryptopp/filters.h>
+#include <cryptopp/cryptlib.h>
 using namespace CryptoPP;
 
 #include "AES_GCM.h"
 
 void AES_GCM::Enc(const string& Key,
                   const string& Nonce,
-                  const string& Header,
-                  const string& Message,
-                  string& C)
+                  const unsigned char* Header,
+                  size_t HeaderLength,
+                  const unsigned char* Message,
+                  size_t MessageLength,
+                  unsigned char* C,
+                  size_t& CLength)
 {
-    // Setup encryption
-    mEnc.SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
-                      (const unsigned char*)Nonce.data(), Nonce.size());
-    // AuthenticatedEncryptionFilter defines two
-    // channels: DEFAULT_CHANNEL and AAD_CHANNEL
-    // DEFAULT_CHANNEL is encrypted and authenticated
-    // AAD_CHANNEL is authenticated
-    AuthenticatedEncryptionFilter EF(mEnc, NULL, false, cTagSize);
-    // Authenticated data *must* be pushed before
-    // Confidential/Authenticated data. Otherwise
-    // we must catch the BadState exception
-    EF.ChannelPut(AAD_CHANNEL, (const unsigned char*)Header.data(), Header.size());
-    EF.ChannelMessageEnd(AAD_CHANNEL);
-    // Confidential data comes after authenticated data.
-    // This is a limitation due to CCM mode, not GCM mode.
-    EF.ChannelPut(DEFAULT_CHANNEL, (const unsigned char*)Message.data(), Message.size());
-    EF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    EF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t CipherSize = (size_t)-1;
-    // Ciphertext recovered
-    CipherSize = (size_t)EF.MaxRetrievable();
-    C.resize(CipherSize);
-    EF.Get((unsigned char*)C.data(), CipherSize);
+    if (CLength < GetCiphertextSize(HeaderLength, MessageLength))
+    {
+        throw runtime_error("Output buffer too small for the cipher");
+    }
+    // Setup encryption, the key schedule and the GHASH table are kept
+    // for the same key, the nonce is set by EncryptAndAuthenticate
+    SetupKey(Key, Nonce, mEnc, mEncKey);
+    // Cipher and tag are written directly behind each other,
+    // no filter and no intermediate buffer
+    mEnc.EncryptAndAuthenticate(C, C + MessageLength, cTagSize,
+                                (const unsigned char*)Nonce.data(), Nonce.size(),
+                                Header, HeaderLength, Message, MessageLength);
+    CLength = MessageLength + cTagSize;
     return;
 }
 
 bool AES_GCM::Dec(const string& Key,
                   const string& Nonce,
-                  const string& Header,
-                  const string& C,
-                  string& Message)
+                  const unsigned char* Header,
+                  size_t HeaderLength,
+                  const unsigned char* C,
+                  size_t CLength,
+                  unsigned char* Message,
+                  size_t& MessageLength)
 {
-    // Setup decryption
-    mDec.SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
-                      (const unsigned char*)Nonce.data(), Nonce.size());
+    if (CLength < cTagSize)
+    {
+        MessageLength = 0;
+        return false;
+    }
     // Break the cipher text out into it's
     // components: Encrypted and MAC
-    string Tag = C.substr(C.size() - cTagSize);
-    // Object *will* throw an exception
-    // during decryption\verification _if_
-    // verification fails.
-    AuthenticatedDecryptionFilter DF(mDec, NULL, AuthenticatedDecryptionFilter::MAC_AT_BEGIN | AuthenticatedDecryptionFilter::THROW_EXCEPTION, cTagSize);
-    // The order of the following calls are important
-    DF.ChannelPut(DEFAULT_CHANNEL, (unsigned char*)Tag.data(), Tag.size());
-    DF.ChannelPut(AAD_CHANNEL, (const unsigned char*)Header.data(), Header.size()); 
-    DF.ChannelPut(DEFAULT_CHANNEL, (unsigned char*)C.data(), C.size() - cTagSize);               
-    // If the object throws, it will most likely occur
-    // during ChannelMessageEnd()
-    DF.ChannelMessageEnd(AAD_CHANNEL);
-    DF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // If the object does not throw, here's the only
-    // opportunity to check the data's integrity
-    bool Success = false;
-    Success = DF.GetLastResult();
-    if (Success == false)
+    size_t CipherSize = CLength - cTagSize;
+    if (MessageLength < GetMaxPlaintextSize(CLength))
     {
-        return false;
+        throw runtime_error("Output buffer too small for the message");
     }
-    // Remove data from channel
-    size_t MessageSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    DF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    MessageSize = (size_t)DF.MaxRetrievable();
-    Message.resize(MessageSize);
-    if (MessageSize > 0)
+    // Setup decryption, the nonce is set by DecryptAndVerify
+    SetupKey(Key, Nonce, mDec, mDecKey);
+    bool Success = mDec.DecryptAndVerify(Message, C + CipherSize, cTagSize,
+                                         (const unsigned char*)Nonce.data(), Nonce.size(),
+                                         Header, HeaderLength, C, CipherSize);
+    if (!Success)
     {
-        DF.Get((unsigned char*)Message.data(), MessageSize);
+        memset(Message, 0x00, CipherSize);
+        MessageLength = 0;
+        return false;
     }
+    MessageLength = CipherSize;
     return true;
 }
 
 void AES_GCM::StartEnc(const std::string& Key,
                        const std::string& Nonce,
-                       const std::string& Header,
-                       const unsigned char* Message,
-                       uint32_t MessageLength)
+                       const unsigned char* Header,
+                       size_t HeaderLength)
 {
-    if (Message == NULL)
+    // Setup encryption, only the nonce is set for the same key
+    if (!SetupKey(Key, Nonce, mEnc, mEncKey))
     {
-        throw runtime_error("Null pointer for Message");
+        mEnc.Resynchronize((const unsigned char*)Nonce.data(), Nonce.size());
     }
-    // Reset Filter
-    mEF.Initialize();
-    // Setup encryption
-    mEnc.SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
-                      (const unsigned char*)Nonce.data(), Nonce.size());
     // Authenticated data *must* be pushed before
-    // Confidential/Authenticated data. Otherwise
-    // we must catch the BadState exception
-    mEF.ChannelPut(AAD_CHANNEL, (const unsigned char*)Header.data(), Header.size() );
-    mEF.ChannelMessageEnd(AAD_CHANNEL);
-    mEF.ChannelPut(DEFAULT_CHANNEL, Message, MessageLength);
+    // Confidential/Authenticated data
+    mEnc.Update(Header, HeaderLength);
     return;
 }
 
 void AES_GCM::UpdateEnc(const unsigned char* Message,
-                        uint32_t MessageLength)
+                        size_t MessageLength,
+                        unsigned char* Output,
+                        size_t& OutputLength)
 {
-    if (Message == NULL)
+    if (Message == NULL && MessageLength != 0)
     {
         throw runtime_error("Null pointer for Message");
     }
-    // Confidential data comes after authenticated data.
-    // This is a limitation due to CCM mode, not GCM mode.
-    mEF.ChannelPut(DEFAULT_CHANNEL, Message, MessageLength);
+    if (OutputLength < MessageLength)
+    {
+        throw runtime_error("Output buffer too small for the cipher");
+    }
+    // GCM is a stream mode, the cipher of every part is final
+    mEnc.ProcessData(Output, Message, MessageLength);
+    OutputLength = MessageLength;
     return;
 }
 
-void AES_GCM::FinishEnc(std::string& Output)
+void AES_GCM::FinishEnc(unsigned char* Output,
+                        size_t& OutputLength)
 {
-    mEF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    mEF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t CipherSize = (size_t)-1;
-    // Ciphertext recovered
-    CipherSize = (size_t)mEF.MaxRetrievable();
-    Output.resize(CipherSize);
-    mEF.Get((unsigned char*)Output.data(), CipherSize);
+    if (OutputLength < cTagSize)
+    {
+        throw runtime_error("Output buffer too small for the tag");
+    }
+    // Only the tag is left, C = C' || T
+    mEnc.TruncatedFinal(Output, cTagSize);
+    OutputLength = cTagSize;
     return;
 }
 
-bool AES_GCM::PDec(const std::string& Key,
-                   const std::string& Nonce,
-                   const std::string& Header,
-                   const unsigned char* Cipher,
-                   uint32_t CipherLength,
-                   string& Output)
+bool AES_GCM::SetupKey(const string& Key,
+                       const string& Nonce,
+                       AuthenticatedSymmetricCipher& Cipher,
+                       KeyContext& Context)
 {
-    if (Cipher == NULL)
-    {
-        throw runtime_error("Null pointer for Cipher");
-    }
-    // Reset Filter
-    mDF.IsolatedInitialize(MakeParameters
-            (Name::AuthenticatedDecryptionFilterFlags(), (word32)(AuthenticatedDecryptionFilter::MAC_AT_BEGIN | AuthenticatedDecryptionFilter::THROW_EXCEPTION)));
-    // Setup decryption
-    mDec.SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
-                      (const unsigned char*)Nonce.data(), Nonce.size());
-    // The order of the following calls are important
-    mDF.ChannelPut(DEFAULT_CHANNEL, (unsigned char*)(Cipher + CipherLength - cTagSize), cTagSize);
-    mDF.ChannelPut(AAD_CHANNEL, (const unsigned char*)Header.data(), Header.size());
-    mDF.ChannelPut(DEFAULT_CHANNEL, Cipher, CipherLength - cTagSize);
-    // If the object throws, it will most likely occur
-    // during ChannelMessageEnd()
-    mDF.ChannelMessageEnd(AAD_CHANNEL);
-    mDF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // If the object does not throw, here's the only
-    // opportunity to check the data's integrity
-    bool Success = false;
-    Success = mDF.GetLastResult();
-    if (Success == false)
-    {
-        return false;
-    }
-    // Remove data from channel
-    size_t MessageSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    mDF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    MessageSize = (size_t)mDF.MaxRetrievable();
-    Output.resize(MessageSize);
-    if (MessageSize > 0)
+    if (Context.NeedsKey(Key))
     {
-        mDF.Get((unsigned char*)Output.data(), MessageSize);
+        // GCM throws for a key without an IV
+        Cipher.SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
+                            (const unsigned char*)Nonce.data(), Nonce.size());
+        Context.SetKey(Key);
+        return true;
     }
-    mDF.SkipMessages(1);
-    return true;
+    return false;
+}
+
+size_t AES_GCM::GetCiphertextSize(size_t /* HeaderLength */,
+                                  size_t MessageLength)
+{
+    // GCM is a stream mode, C = C' || T
+    return MessageLength + cTagSize;
+}
+
+size_t AES_GCM::GetMaxPlaintextSize(size_t CLength)
+{
+    return CLength < cTagSize ? 0 : CLength - cTagSize;
+}
+
+IAEADScheme* AES_GCM::Clone() const
+{
+    return new AES_GCM();
 }
 
 const string& AES_GCM::GetClassDecription()
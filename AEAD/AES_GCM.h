@@ -7,6 +7,7 @@
 #include <cryptopp/aes.h>
 
 #include "IAEADScheme.h" 
+#include "../KeyContext.h"
 
 class AES_GCM : public IAEADScheme
 {
@@ -14,36 +15,42 @@ public:
     AES_GCM():
         mEnc(),
         mDec(),
-        mEF(mEnc, NULL, false, cTagSize),
-        mDF(mDec, NULL, 0, cTagSize),
         cClassDescription("AES_GCM[" + std::string(mEnc.AlgorithmName()) + "]")
     {};
     ~AES_GCM() {};
 
+    using IAEADScheme::Enc;
+    using IAEADScheme::Dec;
     void Enc(const std::string& Key,
              const std::string& Nonce,
-             const std::string& Header,
-             const std::string& Message,
-             std::string& C);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
+             unsigned char* C,
+             size_t& CLength);
     bool Dec(const std::string& Key,
              const std::string& Nonce,
-             const std::string& Header,
-             const std::string& C,
-             std::string& Message);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* C,
+             size_t CLength,
+             unsigned char* Message,
+             size_t& MessageLength);
     void StartEnc(const std::string& Key,
                   const std::string& Nonce,
-                  const std::string& Header,
-                  const unsigned char* Message,
-                  uint32_t MessageLength);
+                  const unsigned char* Header,
+                  size_t HeaderLength);
     void UpdateEnc(const unsigned char* Message,
-                   uint32_t MessageLength);
-    void FinishEnc(std::string& Output);
-    bool PDec(const std::string& Key,
-              const std::string& Nonce,
-              const std::string& Header,
-              const unsigned char* Cipher,
-              uint32_t CipherLength,
-              std::string& Output);
+                   size_t MessageLength,
+                   unsigned char* Output,
+                   size_t& OutputLength);
+    void FinishEnc(unsigned char* Output,
+                   size_t& OutputLength);
+    size_t GetCiphertextSize(size_t HeaderLength,
+                             size_t MessageLength);
+    size_t GetMaxPlaintextSize(size_t CLength);
+    IAEADScheme* Clone() const;
     const std::string& GetClassDecription();
     uint32_t GetKeySize();
     uint32_t GetBlockSize();
@@ -51,10 +58,22 @@ public:
     bool IsBlockCipher();
 
 private:
+    /// \brief Keys the cipher with the nonce if the key differs from the key of its context
+	/// \param Key for the cipher
+	/// \param Nonce for the cipher, GCM can not be keyed without one
+	/// \param Cipher the encryption or decryption
+	/// \param Context the key context of the cipher
+    /// \details Returns true if the cipher was keyed, otherwise the nonce is not set
+    bool SetupKey(const std::string& Key,
+                  const std::string& Nonce,
+                  CryptoPP::AuthenticatedSymmetricCipher& Cipher,
+                  KeyContext& Context);
+
     CryptoPP::GCM<CryptoPP::AES>::Encryption mEnc;
     CryptoPP::GCM<CryptoPP::AES>::Decryption mDec;
-    CryptoPP::AuthenticatedEncryptionFilter mEF;
-    CryptoPP::AuthenticatedDecryptionFilter mDF;
+    // Keys of the expanded keys and GHASH tables in mEnc and mDec
+    KeyContext mEncKey;
+    KeyContext mDecKey;
     const std::string cClassDescription;
     const uint32_t cTagSize = 16;
 };
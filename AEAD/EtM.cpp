@@ -1,191 +1,226 @@
+#include <algorithm>
 using namespace std;
 
-#include <cryptopp/filters.h>
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/misc.h>
 using namespace CryptoPP;
 
 #include "EtM.h"
+#include "../SchemeFactory.h"
 
 void EtM::Enc(const string& Key,
               const string& Nonce,
-              const string& Header,
-              const string& Message,
-              string& C)
+              const unsigned char* Header,
+              size_t HeaderLength,
+              const unsigned char* Message,
+              size_t MessageLength,
+              unsigned char* C,
+              size_t& CLength)
 {
-    // Setup for the hash and the encryption
-    string Key1 = Key.substr(0, mEnc->DefaultKeyLength());
-    string Key2 = Key.substr(mEnc->DefaultKeyLength());
-    mEnc->SetKeyWithIV((const unsigned char*)Key1.data(), Key1.size(),
-                       (const unsigned char*)Nonce.data(), Nonce.size());
-    mHash->SetKey((const unsigned char*)Key1.data(), Key2.size());
-    // Encrypt Message
-    StreamTransformationFilter TF(mEnc->Ref(), NULL);
-    TF.ChannelPut(DEFAULT_CHANNEL, (unsigned char*)Message.data(), Message.size());
-    TF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t CipherSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    TF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    CipherSize = (size_t)TF.MaxRetrievable();
-    C.resize(CipherSize);
-    if (CipherSize > 0)
+    if (CLength < GetCiphertextSize(HeaderLength, MessageLength))
     {
-        TF.Get((unsigned char*)C.data(), CipherSize);
+        throw runtime_error("Output buffer too small for the cipher");
     }
-    // Calculate tag
-    string T;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)C.data(), C.size());
-    T.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)T.data());
-    // Return C || T
-    C.append(T);
+    // One part of the incremental encryption, the full blocks are
+    // encrypted directly into C and the last block gets padded
+    StartEnc(Key, Nonce, Header, HeaderLength);
+    size_t CipherSize = CLength;
+    UpdateEnc(Message, MessageLength, C, CipherSize);
+    size_t RestSize = CLength - CipherSize;
+    FinishEnc(C + CipherSize, RestSize);
+    CLength = CipherSize + RestSize;
     return;
 }
 
 bool EtM::Dec(const string& Key,
               const string& Nonce,
-              const string& Header,
-              const string& C,
-              string& Message)
+              const unsigned char* Header,
+              size_t HeaderLength,
+              const unsigned char* C,
+              size_t CLength,
+              unsigned char* Message,
+              size_t& MessageLength)
 {
+    size_t BlockSize = mDec->MandatoryBlockSize();
+    if (CLength < GetTagSize() ||
+        (IsBlockCipher() && ((CLength - GetTagSize()) % BlockSize != 0 || CLength == GetTagSize())))
+    {
+        MessageLength = 0;
+        return false;
+    }
+    size_t CipherSize = CLength - GetTagSize();
+    if (MessageLength < GetMaxPlaintextSize(CLength))
+    {
+        throw runtime_error("Output buffer too small for the message");
+    }
     // Setup hash, decryption and split cipher
-    string Key1 = Key.substr(0, mDec->DefaultKeyLength());
-    string Key2 = Key.substr(mDec->DefaultKeyLength());
-    mDec->SetKeyWithIV((const unsigned char*)Key1.data(), Key1.size(),
-                       (const unsigned char*)Nonce.data(), Nonce.size());
-    mHash->SetKey((const unsigned char*)Key1.data(), Key2.size());
-    //string C1 = C.substr(0, C.size() - GetTagSize());
-    string T = C.substr(C.size() - GetTagSize());
+    SetupKeys(Key, Nonce, mDec, mDecKey);
     // Check the tag
-    string TNew;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)C.data(), C.size() - GetTagSize());
-    TNew.resize(mHash->DigestSize());
+    string TNew(mHash->DigestSize(), 0x00);
+    mHash->Update(Header, HeaderLength);
+    mHash->Update(C, CipherSize);
     mHash->Final((unsigned char*)TNew.data());
-    if (T.compare(TNew))
+    if (!VerifyBufsEqual(C + CipherSize, (const unsigned char*)TNew.data(), TNew.size()))
     {
+        MessageLength = 0;
         return false;
     }
-    // Decrypt cipher
-    StreamTransformationFilter TF(mDec->Ref(), NULL);
-    TF.ChannelPut(DEFAULT_CHANNEL, (unsigned char*)C.data(), C.size() - GetTagSize());
-    TF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t MessageSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    TF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    MessageSize = (size_t)TF.MaxRetrievable();
-    Message.resize(MessageSize);
-    if (MessageSize > 0)
+    // Decrypt cipher directly into the message
+    mDec->ProcessData(Message, C, CipherSize);
+    if (IsBlockCipher())
     {
-        TF.Get((unsigned char*)Message.data(), MessageSize);
+        // Remove and check the PKCS padding
+        size_t PadSize = Message[CipherSize - 1];
+        bool Valid = PadSize != 0 && PadSize <= BlockSize;
+        for (size_t i = 1; Valid && i <= PadSize; i++)
+        {
+            Valid = Message[CipherSize - i] == PadSize;
+        }
+        if (!Valid)
+        {
+            memset(Message, 0x00, CipherSize);
+            MessageLength = 0;
+            return false;
+        }
+        CipherSize -= PadSize;
     }
+    MessageLength = CipherSize;
     return true;
 }
 
 void EtM::StartEnc(const std::string& Key,
-                       const std::string& Nonce,
-                       const std::string& Header,
-                       const unsigned char* Message,
-                       uint32_t MessageLength)
+                   const std::string& Nonce,
+                   const unsigned char* Header,
+                   size_t HeaderLength)
 {
-    if (Message == NULL)
-    {
-        throw runtime_error("Null pointer for Message");
-    }
-    // Reset Filter
-    mTF.Initialize();
     // Setup for the hash and the encryption
-    string Key1 = Key.substr(0, mEnc->DefaultKeyLength());
-    string Key2 = Key.substr(mEnc->DefaultKeyLength());
-    mEnc->SetKeyWithIV((const unsigned char*)Key1.data(), Key1.size(),
-                       (const unsigned char*)Nonce.data(), Nonce.size());
-    mHash->SetKey((const unsigned char*)Key1.data(), Key2.size());
-    // Encrypt Message
-    mTF.ChannelPut(DEFAULT_CHANNEL, Message, MessageLength);
+    SetupKeys(Key, Nonce, mEnc, mEncKey);
+    mLastBlockSize = 0;
     // Input header to MAC
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
+    mHash->Update(Header, HeaderLength);
 }
 
 void EtM::UpdateEnc(const unsigned char* Message,
-                    uint32_t MessageLength)
+                    size_t MessageLength,
+                    unsigned char* Output,
+                    size_t& OutputLength)
 {
-    if (Message == NULL)
+    if (Message == NULL && MessageLength != 0)
     {
         throw runtime_error("Null pointer for Message");
     }
-    // Input message to cipher
-    mTF.ChannelPut(DEFAULT_CHANNEL, Message, MessageLength);
+    // A stream cipher needs no padding, block ciphers encrypt
+    // the full blocks and keep the rest for the next part
+    size_t BlockSize = IsBlockCipher() ? mEnc->MandatoryBlockSize() : 1;
+    size_t CipherSize = (mLastBlockSize + MessageLength) / BlockSize * BlockSize;
+    if (OutputLength < CipherSize)
+    {
+        throw runtime_error("Output buffer too small for the cipher");
+    }
+    size_t Written = 0;
+    if (mLastBlockSize != 0)
+    {
+        // Complete the block of the last part first
+        size_t Missing = min(BlockSize - mLastBlockSize, MessageLength);
+        memcpy(&mLastBlock[mLastBlockSize], Message, Missing);
+        mLastBlockSize += Missing;
+        Message += Missing;
+        MessageLength -= Missing;
+        if (mLastBlockSize == BlockSize)
+        {
+            mEnc->ProcessData(Output, (const unsigned char*)mLastBlock.data(), BlockSize);
+            mLastBlockSize = 0;
+            Written = BlockSize;
+        }
+    }
+    // Encrypt the full blocks of the message directly into the output
+    size_t FullSize = MessageLength - (MessageLength % BlockSize);
+    mEnc->ProcessData(Output + Written, Message, FullSize);
+    memcpy(&mLastBlock[mLastBlockSize], Message + FullSize, MessageLength - FullSize);
+    mLastBlockSize += MessageLength - FullSize;
+    // Input cipher to MAC
+    mHash->Update(Output, CipherSize);
+    OutputLength = CipherSize;
 }
 
-void EtM::FinishEnc(std::string& Output)
+void EtM::FinishEnc(unsigned char* Output,
+                    size_t& OutputLength)
 {
-    // Finish ciphertext
-    mTF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t CipherSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    mTF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    CipherSize = (size_t)mTF.MaxRetrievable();
-    Output.resize(CipherSize);
-    if (CipherSize > 0)
+    // PKCS padding for block ciphers like the StreamTransformationFilter
+    size_t CipherSize = IsBlockCipher() ? mEnc->MandatoryBlockSize() : 0;
+    if (OutputLength < CipherSize + GetTagSize())
     {
-        mTF.Get((unsigned char*)Output.data(), CipherSize);
+        throw runtime_error("Output buffer too small for the cipher");
     }
-    // Calculate tag
-    string T;
-    mHash->Update((const unsigned char*)Output.data(), Output.size());
-    T.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)T.data());
-    // Return C || T
-    Output.append(T);
+    if (CipherSize != 0)
+    {
+        // Last block with the rest of the message and the padding
+        size_t PadSize = CipherSize - mLastBlockSize;
+        memset(&mLastBlock[mLastBlockSize], (int)PadSize, PadSize);
+        mEnc->ProcessData(Output, (const unsigned char*)mLastBlock.data(), CipherSize);
+        mHash->Update(Output, CipherSize);
+        mLastBlockSize = 0;
+    }
+    // Calculate tag directly behind the cipher, C || T
+    mHash->Final(Output + CipherSize);
+    OutputLength = CipherSize + GetTagSize();
     return;
 }
 
-bool EtM::PDec(const std::string& Key,
-               const std::string& Nonce,
-               const std::string& Header,
-               const unsigned char* Cipher,
-               uint32_t CipherLength,
-               string& Output)
+void EtM::SetupKeys(const string& Key,
+                    const string& Nonce,
+                    SymmetricCipher* Cipher,
+                    KeyContext& Context)
 {
-    if (Cipher == NULL)
+    // Key = cipher key || MAC key, the key schedules are only
+    // run for a new key, otherwise only the nonce is set
+    size_t Key1Size = min<size_t>(Cipher->DefaultKeyLength(), Key.size());
+    if (Context.NeedsKey((const unsigned char*)Key.data(), Key1Size))
     {
-        throw runtime_error("Null pointer for Cipher");
+        Cipher->SetKeyWithIV((const unsigned char*)Key.data(), Key1Size,
+                             (const unsigned char*)Nonce.data(), Nonce.size());
+        Context.SetKey((const unsigned char*)Key.data(), Key1Size);
     }
-    // Setup hash, decryption and split cipher
-    string Key1 = Key.substr(0, mDec->DefaultKeyLength());
-    string Key2 = Key.substr(mDec->DefaultKeyLength());
-    mDec->SetKeyWithIV((const unsigned char*)Key1.data(), Key1.size(),
-                       (const unsigned char*)Nonce.data(), Nonce.size());
-    mHash->SetKey((const unsigned char*)Key1.data(), Key2.size());
-    //string C1 = C.substr(0, C.size() - GetTagSize());
-    string T((const char*)(Cipher + CipherLength - GetTagSize()), GetTagSize());
-    // Check the tag
-    string TNew;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update(Cipher, CipherLength - GetTagSize());
-    TNew.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)TNew.data());
-    if (T.compare(TNew))
+    else
     {
-        return false;
+        Cipher->Resynchronize((const unsigned char*)Nonce.data(), Nonce.size());
     }
-    // Decrypt cipher
-    StreamTransformationFilter TF(mDec->Ref(), NULL);
-    TF.ChannelPut(DEFAULT_CHANNEL, Cipher, CipherLength - GetTagSize());
-    TF.ChannelMessageEnd(DEFAULT_CHANNEL);
-    // Remove data from channel
-    size_t MessageSize = (size_t)-1;
-    // Plain text recovered from enc.data()
-    TF.SetRetrievalChannel(DEFAULT_CHANNEL);
-    MessageSize = (size_t)TF.MaxRetrievable();
-    Output.resize(MessageSize);
-    if (MessageSize > 0)
+    const unsigned char* Key2 = (const unsigned char*)Key.data() + Key1Size;
+    if (mHashKey.NeedsKey(Key2, Key.size() - Key1Size))
     {
-        TF.Get((unsigned char*)Output.data(), MessageSize);
+        mHash->SetKey(Key2, Key.size() - Key1Size);
+        mHashKey.SetKey(Key2, Key.size() - Key1Size);
     }
-    return true;
+    else
+    {
+        // Drops the state of an unfinished message
+        mHash->Restart();
+    }
+}
+
+size_t EtM::GetCiphertextSize(size_t /* HeaderLength */,
+                              size_t MessageLength)
+{
+    // Block ciphers always add 1 to block size bytes of PKCS padding
+    size_t CipherSize = MessageLength;
+    if (IsBlockCipher())
+    {
+        CipherSize += mEnc->MandatoryBlockSize() - (MessageLength % mEnc->MandatoryBlockSize());
+    }
+    return CipherSize + GetTagSize();
+}
+
+size_t EtM::GetMaxPlaintextSize(size_t CLength)
+{
+    // The padding is decrypted too and removed afterwards
+    return CLength < GetTagSize() ? 0 : CLength - GetTagSize();
+}
+
+IAEADScheme* EtM::Clone() const
+{
+    return new EtM(SchemeFactory::CreateMAC(mHash),
+                   SchemeFactory::CreateCipher(mEnc),
+                   SchemeFactory::CreateCipher(mDec));
 }
 
 const string& EtM::GetClassDecription()
@@ -6,6 +6,7 @@
 #include <cryptopp/cryptlib.h>
 
 #include "IAEADScheme.h" 
+#include "../KeyContext.h"
 
 class EtM : public IAEADScheme
 {
@@ -16,7 +17,8 @@ public:
             mEnc(Enc),
             mDec(Dec),
             mHash(Hash),
-            mTF(mEnc->Ref(), NULL),
+            mLastBlock(mEnc->MandatoryBlockSize(), 0x00),
+            mLastBlockSize(0),
             cClassDescription("EtM[" + std::string(mEnc->AlgorithmName()) + ", " + std::string(mHash->AlgorithmName()) + "]")
     {};
     ~EtM()
@@ -26,30 +28,38 @@ public:
         delete mHash;
     };
 
+    using IAEADScheme::Enc;
+    using IAEADScheme::Dec;
     void Enc(const std::string& Key,
              const std::string& Nonce,
-             const std::string& Header,
-             const std::string& Message,
-             std::string& C);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
+             unsigned char* C,
+             size_t& CLength);
     bool Dec(const std::string& Key,
              const std::string& Nonce,
-             const std::string& Header,
-             const std::string& C,
-             std::string& Message);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* C,
+             size_t CLength,
+             unsigned char* Message,
+             size_t& MessageLength);
     void StartEnc(const std::string& Key,
                   const std::string& Nonce,
-                  const std::string& Header,
-                  const unsigned char* Message,
-                  uint32_t MessageLength);
+                  const unsigned char* Header,
+                  size_t HeaderLength);
     void UpdateEnc(const unsigned char* Message,
-                   uint32_t MessageLength);
-    void FinishEnc(std::string& Output);
-    bool PDec(const std::string& Key,
-              const std::string& Nonce,
-              const std::string& Header,
-              const unsigned char* Cipher,
-              uint32_t CipherLength,
-              std::string& Output);
+                   size_t MessageLength,
+                   unsigned char* Output,
+                   size_t& OutputLength);
+    void FinishEnc(unsigned char* Output,
+                   size_t& OutputLength);
+    size_t GetCiphertextSize(size_t HeaderLength,
+                             size_t MessageLength);
+    size_t GetMaxPlaintextSize(size_t CLength);
+    IAEADScheme* Clone() const;
     const std::string& GetClassDecription();
     uint32_t GetKeySize();
     uint32_t GetBlockSize();
@@ -57,10 +67,26 @@ public:
     bool IsBlockCipher();
 
 private:
+    /// \brief Keys the cipher and the MAC if the keys differ from their contexts
+	/// \param Key cipher key and MAC key
+	/// \param Nonce for the cipher
+	/// \param Cipher the encryption or decryption
+	/// \param Context the key context of the cipher
+    void SetupKeys(const std::string& Key,
+                   const std::string& Nonce,
+                   CryptoPP::SymmetricCipher* Cipher,
+                   KeyContext& Context);
+
     CryptoPP::SymmetricCipher* mEnc;
     CryptoPP::SymmetricCipher* mDec;
     CryptoPP::MessageAuthenticationCode* mHash;
-    CryptoPP::StreamTransformationFilter mTF;
+    // Keys of the key schedules in mEnc, mDec and mHash
+    KeyContext mEncKey;
+    KeyContext mDecKey;
+    KeyContext mHashKey;
+    // Incomplete block of the message since StartEnc
+    std::string mLastBlock;
+    size_t mLastBlockSize;
     const std::string cClassDescription;
 
 };
@@ -3,7 +3,7 @@
 
 #include <string>
 
-#include <cryptopp/osrng.h>
+#include "../Random.h"
 
 /// \brief Interface for an AEAD scheme
 class IAEADScheme
@@ -17,10 +17,7 @@ public:
 	/// \brief Key generation of the scheme
     std::string Kg()
     {
-        CryptoPP::AutoSeededRandomPool Rnd;
-        string Key(GetKeySize(), '0');
-        Rnd.GenerateBlock((unsigned char*)Key.data(), Key.size());
-        return Key;
+        return RandomGenerator::Generate(GetKeySize());
     }
     /// \brief Authenticated encryption of the message with a header
 	/// \param Key for the encryption
@@ -28,47 +25,109 @@ public:
 	/// \param Header for the encryption
 	/// \param Message for the encryption
 	/// \param C reference outputs cipher with tag
-    virtual void Enc(const std::string& Key,
-                     const std::string& Nonce,
-                     const std::string& Header,
-                     const std::string& Message,
-                     std::string& C) = 0;
+    void Enc(const std::string& Key,
+             const std::string& Nonce,
+             const std::string& Header,
+             const std::string& Message,
+             std::string& C)
+    {
+        C.resize(GetCiphertextSize(Header.size(), Message.size()));
+        size_t CLength = C.size();
+        Enc(Key, Nonce, (const unsigned char*)Header.data(), Header.size(),
+            (const unsigned char*)Message.data(), Message.size(), (unsigned char*)C.data(), CLength);
+        C.resize(CLength);
+    }
     /// \brief Authenticated decryption of the cipher with a header
 	/// \param Key for the decryption 
 	/// \param Nonce for the decryption 
 	/// \param Header for the decryption 
 	/// \param C cipher for the decryption 
 	/// \param Message reference outputs decrypted message
+    bool Dec(const std::string& Key,
+             const std::string& Nonce,
+             const std::string& Header,
+             const std::string& C,
+             std::string& Message)
+    {
+        Message.resize(GetMaxPlaintextSize(C.size()));
+        size_t MessageLength = Message.size();
+        bool Success = Dec(Key, Nonce, (const unsigned char*)Header.data(), Header.size(),
+                           (const unsigned char*)C.data(), C.size(), (unsigned char*)Message.data(), MessageLength);
+        Message.resize(MessageLength);
+        return Success;
+    }
+    /// \brief Authenticated encryption into a caller buffer
+	/// \param Key for the encryption
+	/// \param Nonce for the encryption
+	/// \param Header pointer to the header for the encryption
+	/// \param HeaderLength length of the header
+	/// \param Message pointer to the message for the encryption
+	/// \param MessageLength length of the message
+	/// \param C outputs cipher with tag
+	/// \param CLength capacity of C, outputs the written length
+    /// \details C needs GetCiphertextSize(HeaderLength, MessageLength) bytes,
+    ///          otherwise a runtime_error is thrown
+    virtual void Enc(const std::string& Key,
+                     const std::string& Nonce,
+                     const unsigned char* Header,
+                     size_t HeaderLength,
+                     const unsigned char* Message,
+                     size_t MessageLength,
+                     unsigned char* C,
+                     size_t& CLength) = 0;
+    /// \brief Authenticated decryption into a caller buffer
+	/// \param Key for the decryption
+	/// \param Nonce for the decryption
+	/// \param Header pointer to the header for the decryption
+	/// \param HeaderLength length of the header
+	/// \param C pointer to the cipher with tag
+	/// \param CLength length of the cipher with tag
+	/// \param Message outputs the decrypted message
+	/// \param MessageLength capacity of Message, outputs the written length
+    /// \details Message needs at least GetMaxPlaintextSize(CLength) bytes,
+    ///          otherwise a runtime_error is thrown. On failure the written
+    ///          part is cleared and MessageLength is 0
     virtual bool Dec(const std::string& Key,
                      const std::string& Nonce,
-                     const std::string& Header,
-                     const std::string& C,
-                     std::string& Message) = 0;
+                     const unsigned char* Header,
+                     size_t HeaderLength,
+                     const unsigned char* C,
+                     size_t CLength,
+                     unsigned char* Message,
+                     size_t& MessageLength) = 0;
 
     //======================================================//
-    // We need to implement following functions to avoid string
-    // constructions during our calculations to avoid time losses
-    // for very larg strings
+    // Incremental encryption, the cipher is written while the
+    // message is streamed in, so the message never has to be
+    // in memory as a whole
 
-    /// \brief Start authenticated encryption and input provided data
+    /// \brief Start authenticated encryption with the header
 	/// \param Key for the encryption
 	/// \param Nonce for the encryption
-	/// \param Header for the encryption
-	/// \param Message pointer to input data for the encryption
-	/// \param MessageLength length of input data
+	/// \param Header pointer to the header for the encryption
+	/// \param HeaderLength length of the header
     virtual void StartEnc(const std::string& Key,
                           const std::string& Nonce,
-                          const std::string& Header,
-                          const unsigned char* Message,
-                          uint32_t MessageLength) = 0;
-    /// \brief Update the state of encryption with message
-	/// \param Message pointer to the input data
-	/// \param MessageLength length of the message
+                          const unsigned char* Header,
+                          size_t HeaderLength) = 0;
+    /// \brief Encrypt the next part of the message into a caller buffer
+	/// \param Message pointer to the next part of the message
+	/// \param MessageLength length of the part
+	/// \param Output receives the cipher of the part
+	/// \param OutputLength capacity of Output, outputs the written length
+    /// \details Block ciphers hold back an incomplete block, so less or more
+    ///          than MessageLength can be written. MessageLength plus one
+    ///          block is always enough, otherwise a runtime_error is thrown
     virtual void UpdateEnc(const unsigned char* Message,
-                           uint32_t MessageLength) = 0;
-    /// \brief Finish encryption and return ciphertext
-	/// \param Output receives ciphertext
-    virtual void FinishEnc(std::string& Output) = 0;
+                           size_t MessageLength,
+                           unsigned char* Output,
+                           size_t& OutputLength) = 0;
+    /// \brief Finish encryption into a caller buffer
+	/// \param Output receives the rest of the cipher and the tag
+	/// \param OutputLength capacity of Output, outputs the written length
+    /// \details Needs one block and the tag, otherwise a runtime_error is thrown
+    virtual void FinishEnc(unsigned char* Output,
+                           size_t& OutputLength) = 0;
     /// \brief Do authenticated decryption with a data pointer
 	/// \param Key for the decryption
 	/// \param Nonce for the decryption 
@@ -76,12 +135,38 @@ public:
 	/// \param Cipher pointer to input data for the decryption
 	/// \param CipherLength length of input data
 	/// \param Output receives decrypted message
-    virtual bool PDec(const std::string& Key,
-                      const std::string& Nonce,
-                      const std::string& Header,
-                      const unsigned char* Cipher,
-                      uint32_t CipherLength,
-                      std::string& Output) = 0;
+    bool PDec(const std::string& Key,
+              const std::string& Nonce,
+              const std::string& Header,
+              const unsigned char* Cipher,
+              uint32_t CipherLength,
+              std::string& Output)
+    {
+        if (Cipher == NULL)
+        {
+            throw runtime_error("Null pointer for Cipher");
+        }
+        Output.resize(GetMaxPlaintextSize(CipherLength));
+        size_t OutputLength = Output.size();
+        bool Success = Dec(Key, Nonce, (const unsigned char*)Header.data(), Header.size(),
+                           Cipher, CipherLength, (unsigned char*)Output.data(), OutputLength);
+        Output.resize(OutputLength);
+        return Success;
+    }
+    /// \brief Returns the size of the cipher with tag
+	/// \param HeaderLength length of the header
+	/// \param MessageLength length of the message
+    /// \details Exact for every message, so the output can be allocated once
+    virtual size_t GetCiphertextSize(size_t HeaderLength,
+                                     size_t MessageLength) = 0;
+    /// \brief Returns the capacity Dec needs for the message
+	/// \param CLength length of the cipher with tag
+    /// \details Includes the padding of block ciphers, Dec returns the
+    ///          exact length of the message
+    virtual size_t GetMaxPlaintextSize(size_t CLength) = 0;
+    /// \brief Returns a new instance with new components of the same types
+    /// \details Nothing is shared with this instance, the key contexts are empty
+    virtual IAEADScheme* Clone() const = 0;
     virtual const std::string& GetClassDecription() = 0;
     virtual uint32_t GetKeySize() = 0;
     virtual uint32_t GetBlockSize() = 0;
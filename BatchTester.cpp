@@ -0,0 +1,177 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+using namespace std;
+using namespace std::chrono;
+
+#include "BatchTester.h"
+
+BatchTester::BatchTester(uint32_t Iterations,
+                         string& Logfile,
+                         string& Key,
+                         string& Nonce,
+                         uint32_t HeaderSize,
+                         uint32_t MessageSize,
+                         vector<uint32_t>& BatchSizes,
+                         ICEScheme* CE):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mNonce(Nonce),
+    mHeaderSize(HeaderSize),
+    mMessageSize(MessageSize),
+    mBatchSizes(BatchSizes),
+    mBatchSize(0),
+    mCE(CE)
+{
+    if (mBatchSizes.empty() || mBatchSizes.front() == 0)
+    {
+        throw runtime_error("Need batch sizes above 0 for the batch test");
+    }
+    // Every message and header of the largest batch has its own random content
+    uint32_t MaxBatchSize = *max_element(mBatchSizes.begin(), mBatchSizes.end());
+    mRandomHeaders = RandomGenerator::Generate((size_t)MaxBatchSize * mHeaderSize);
+    mRandomMessages = RandomGenerator::Generate((size_t)MaxBatchSize * mMessageSize);
+    for (uint32_t i = 0; i < MaxBatchSize; i++)
+    {
+        mHeaders.push_back((const unsigned char*)mRandomHeaders.data() + (size_t)i * mHeaderSize);
+        mHeaderLengths.push_back(mHeaderSize);
+        mMessages.push_back((const unsigned char*)mRandomMessages.data() + (size_t)i * mMessageSize);
+        mMessageLengths.push_back(mMessageSize);
+    }
+    // The outputs are allocated once for the largest batch
+    mC1.resize((size_t)MaxBatchSize * mCE->GetCiphertextSize(mHeaderSize, mMessageSize));
+    mC1Lengths.resize(MaxBatchSize);
+    mC2.resize((size_t)MaxBatchSize * mCE->GetCommitmentSize());
+    mOutput.resize((size_t)MaxBatchSize * mCE->GetMaxPlaintextSize(mCE->GetCiphertextSize(mHeaderSize, mMessageSize)));
+    mOutputLengths.resize(MaxBatchSize);
+    mOutputs.resize(MaxBatchSize);
+    mKeyfs.resize(MaxBatchSize);
+    mValid.reset(new bool[MaxBatchSize]);
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Batch scheme: " + mCE->GetClassDecription(), true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(mNonce.size()), false);
+    HandleOutput("Header size: " + to_string(mHeaderSize), false);
+    HandleOutput("Message size: " + to_string(mMessageSize), false);
+    HandleOutput("Batch sizes: " + to_string(mBatchSizes.front()) + " to " +
+                 to_string(mBatchSizes.back()) + " (" + to_string(mBatchSizes.size()) + " points)", false);
+    // The defaults of ICEScheme call Enc, Dec and Ver for every message
+    if (!mCE->HasBatch())
+    {
+        HandleOutput("The scheme has no batch functions, every message is processed on its own", false);
+    }
+}
+
+bool BatchTester::TestRound()
+{
+    // Increase Nonce by the batch, message i uses the nonce increased i times
+    for (uint32_t i = 0; i < mBatchSize; i++)
+    {
+        IncreaseString(mNonce);
+    }
+    mCE->SetNonce(mNonce);
+    // Encryption
+    size_t C1Length = mC1.size();
+    StartTime(0);
+    mCE->EncBatch(mKey, mBatchSize, mHeaders.data(), mHeaderLengths.data(),
+                  mMessages.data(), mMessageLengths.data(),
+                  (unsigned char*)&mC1[0], C1Length, mC1Lengths.data(), (unsigned char*)&mC2[0]);
+    AddTime(0);
+    // Decryption with the nonces of the encryption, EncBatch left the nonce behind the batch
+    mCE->SetNonce(mNonce);
+    size_t OutputLength = mOutput.size();
+    StartTime(1);
+    size_t Valid = mCE->DecBatch(mKey, mBatchSize, mHeaders.data(), mHeaderLengths.data(),
+                                 (const unsigned char*)mC1.data(), mC1Lengths.data(), (const unsigned char*)mC2.data(),
+                                 (unsigned char*)&mOutput[0], OutputLength, mOutputLengths.data(),
+                                 mKeyfs.data(), mValid.get());
+    AddTime(1);
+    if (Valid != mBatchSize)
+    {
+        HandleOutput("Decryption has failed for " + to_string(mBatchSize - Valid) + " messages");
+        return false;
+    }
+    // The decrypted messages are behind each other in the output
+    size_t Offset = 0;
+    for (uint32_t i = 0; i < mBatchSize; i++)
+    {
+        mOutputs[i] = (const unsigned char*)mOutput.data() + Offset;
+        Offset += mOutputLengths[i];
+    }
+    // Verification
+    StartTime(2);
+    Valid = mCE->VerBatch(mBatchSize, mHeaders.data(), mHeaderLengths.data(),
+                          mOutputs.data(), mOutputLengths.data(), mKeyfs.data(),
+                          (const unsigned char*)mC2.data(), mValid.get());
+    AddTime(2);
+    if (Valid != mBatchSize)
+    {
+        HandleOutput("Verification has failed for " + to_string(mBatchSize - Valid) + " messages");
+        return false;
+    }
+    return true;
+}
+
+bool BatchTester::Run()
+{
+    HandleOutput("");
+    for (uint32_t BatchSize: mBatchSizes)
+    {
+        if (!RunBatchSize(BatchSize))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BatchTester::RunBatchSize(uint32_t BatchSize)
+{
+    mBatchSize = BatchSize;
+    // Every batch size processes about the same number of messages
+    uint32_t Iterations = max<uint32_t>(cMinBatchIterations, GetTestIterations() / BatchSize);
+    // Rounds to warm up, not measured
+    for (uint32_t i = 0; i < max<uint32_t>(GetWarmup(), 1); i++)
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+    }
+    ResetTime();
+    // Like Tester::Run the batch size stops early when the median converged
+    // or the time budget of the batch size is used up
+    uint32_t Rounds = 0;
+    steady_clock::time_point Start = steady_clock::now();
+    while (Rounds < Iterations && !IsFinished(Rounds, Start))
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+        Rounds++;
+    }
+    string Output = "Batch size: " + to_string(BatchSize) + ", Iterations: " + to_string(Rounds);
+    const vector<string> Phases = {"Encryption", "Decryption", "Verification"};
+    const vector<string> Prefixes = {"enc", "dec", "ver"};
+    ResultRecord Record = CreateRecord("batch", mCE, mHeaderSize, mMessageSize, mKey.size(),
+                                       mNonce.size(), Rounds);
+    Record.Add("batch_size", (uint64_t)BatchSize);
+    Record.Add("batch_path", string(mCE->HasBatch() ? "batch" : "per_message"));
+    for (uint8_t Phase = 0; Phase < Phases.size(); Phase++)
+    {
+        // The mean time is for a whole batch
+        double Seconds = GetHistogram(Phase).GetMean() / 1e9;
+        double MessagesPerSecond = Seconds > 0.0 ? BatchSize / Seconds : 0.0;
+        Output += " - " + Phases[Phase] + ": " + to_string(MessagesPerSecond) + " messages/s";
+        Record.Add(Prefixes[Phase] + "_messages_per_s", MessagesPerSecond);
+    }
+    HandleOutput(Output);
+    AddPhases(Record, (uint64_t)BatchSize * (mHeaderSize + mMessageSize));
+    WriteResult(Record);
+    return true;
+}
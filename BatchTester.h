@@ -0,0 +1,77 @@
+#ifndef BATCHTESTER_H
+#define BATCHTESTER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Tester.h"
+
+/// \brief BatchTester class which tests the batch functions of a CE scheme
+/// \details Small messages of a fixed size are encrypted, decrypted and verified
+/// in batches of growing size with EncBatch, DecBatch and VerBatch. Every message
+/// of a batch has its own random content and header. The messages per second of
+/// every batch size show how much of the per message setup the batch saves.
+class BatchTester: public Tester
+{
+public:
+	/// \brief Construct a BatchTester
+	/// \param Iterations number of messages for one batch size
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+	/// \param HeaderSize size of every header in bytes
+	/// \param MessageSize size of every message in bytes
+	/// \param BatchSizes grid of the batch sizes
+	/// \param CE reference to the scheme to test
+    BatchTester(uint32_t Iterations,
+                std::string& Logfile,
+                std::string& Key,
+                std::string& Nonce,
+                uint32_t HeaderSize,
+                uint32_t MessageSize,
+                std::vector<uint32_t>& BatchSizes,
+                ICEScheme* CE);
+    /// \brief Destruct a BatchTester
+    /// \details Need to delete the scheme provided by the SchemeFactory
+    ~BatchTester()
+    {
+        delete mCE;
+    }
+    /// \brief Calls enc, dec and ver of the scheme for one batch and measures time
+    bool TestRound();
+    /// \brief Tests every batch size and logs the messages per second
+    bool Run();
+
+private:
+	/// \brief Tests one batch size
+	/// \param BatchSize number of messages of one batch
+    bool RunBatchSize(uint32_t BatchSize);
+
+    std::string mKey;
+    std::string mNonce;
+    uint32_t mHeaderSize;
+    uint32_t mMessageSize;
+    std::vector<uint32_t> mBatchSizes;
+    uint32_t mBatchSize;
+    // Random headers and messages of the largest batch, behind each other
+    std::string mRandomHeaders;
+    std::string mRandomMessages;
+    std::vector<const unsigned char*> mHeaders;
+    std::vector<size_t> mHeaderLengths;
+    std::vector<const unsigned char*> mMessages;
+    std::vector<size_t> mMessageLengths;
+    // Contiguous outputs of the batch functions
+    std::string mC1;
+    std::vector<size_t> mC1Lengths;
+    std::string mC2;
+    std::string mOutput;
+    std::vector<size_t> mOutputLengths;
+    std::vector<const unsigned char*> mOutputs;
+    std::vector<std::string> mKeyfs;
+    std::unique_ptr<bool[]> mValid;
+    ICEScheme* mCE;
+    const uint32_t cMinBatchIterations = 5;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+/// \brief BoundedQueue class, a lock-free queue with a fixed capacity
+/// \details Multiple producers and consumers, every slot has a sequence number
+/// which tells if the slot is free for the producer of this turn or filled for
+/// the consumer of this turn (Vyukov). The slots are allocated once, so pushing
+/// and popping never allocates and never takes a lock.
+template<typename T>
+class BoundedQueue
+{
+public:
+	/// \brief Construct a BoundedQueue
+	/// \param Capacity number of slots, needs to be a power of two
+    BoundedQueue(uint32_t Capacity):
+        mSlots(Capacity),
+        mMask(Capacity - 1),
+        mHead(0),
+        mTail(0)
+    {
+        if (Capacity < 2 || (Capacity & (Capacity - 1)) != 0)
+        {
+            throw std::runtime_error("The capacity of a queue needs to be a power of two");
+        }
+        for (uint32_t i = 0; i < Capacity; i++)
+        {
+            mSlots[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+	/// \brief Destruct a BoundedQueue
+    ~BoundedQueue() {}
+	/// \brief Moves a value into the queue, returns false if the queue is full
+	/// \param Value the value to push
+    bool Push(T& Value)
+    {
+        uint64_t Position = mTail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& Current = mSlots[Position & mMask];
+            uint64_t Sequence = Current.Sequence.load(std::memory_order_acquire);
+            int64_t Difference = (int64_t)Sequence - (int64_t)Position;
+            if (Difference == 0)
+            {
+                if (mTail.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    Current.Value = std::move(Value);
+                    Current.Sequence.store(Position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = mTail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+	/// \brief Moves the oldest value out of the queue, returns false if the queue is empty
+	/// \param Value reference outputs the value
+    bool Pop(T& Value)
+    {
+        uint64_t Position = mHead.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& Current = mSlots[Position & mMask];
+            uint64_t Sequence = Current.Sequence.load(std::memory_order_acquire);
+            int64_t Difference = (int64_t)Sequence - (int64_t)(Position + 1);
+            if (Difference == 0)
+            {
+                if (mHead.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    Value = std::move(Current.Value);
+                    Current.Sequence.store(Position + mMask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = mHead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+	/// \brief Returns true if the queue was empty at the time of the call
+    bool Empty() const
+    {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    /// \brief One slot of the queue
+    struct Slot
+    {
+        std::atomic<uint64_t> Sequence;
+        T Value;
+    };
+
+    std::vector<Slot> mSlots;
+    const uint64_t mMask;
+    // Producers and consumers on different cache lines
+    alignas(64) std::atomic<uint64_t> mHead;
+    alignas(64) std::atomic<uint64_t> mTail;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef CECONTEXT_H
+#define CECONTEXT_H
+
+#include <string>
+
+#include "ICEScheme.h"
+#include "NonceSequencer.h"
+
+/// \brief CEContext class with the state of one caller of a shared CE scheme
+/// \details The scheme given to the constructor is only read by Clone. The context
+/// owns the clone with its components, the key contexts, the scratch buffers and
+/// the nonce, so every thread of a worker pool can frank with its own context of
+/// one parsed scheme without locks. The nonce is increased after every encryption
+/// or, for contexts of many threads under one key, taken from a NonceSequencer.
+class CEContext
+{
+public:
+	/// \brief Construct a CEContext with the nonce of the scheme, e.g. to only verify
+	/// \param Scheme the shared scheme, it is cloned
+    explicit CEContext(const ICEScheme& Scheme):
+        mCE(Scheme.Clone()),
+        mSequencer(NULL)
+    {}
+	/// \brief Construct a CEContext
+	/// \param Scheme the shared scheme, it is cloned
+	/// \param Nonce first nonce of this context
+    CEContext(const ICEScheme& Scheme,
+              const std::string& Nonce):
+        mCE(Scheme.Clone()),
+        mSequencer(NULL)
+    {
+        mCE->SetNonce(Nonce);
+    }
+	/// \brief Construct a CEContext which takes the nonces from a sequencer
+	/// \param Scheme the shared scheme, it is cloned
+	/// \param Sequencer shared by the contexts under one key, needs to outlive the context
+    CEContext(const ICEScheme& Scheme,
+              NonceSequencer& Sequencer):
+        mCE(Scheme.Clone()),
+        mSequencer(&Sequencer)
+    {}
+	/// \brief Destruct a CEContext
+    ~CEContext()
+    {
+        delete mCE;
+    }
+    CEContext(const CEContext&) = delete;
+    CEContext& operator=(const CEContext&) = delete;
+    /// \brief Encrypts the message with the nonce of the context
+	/// \param Key for the encryption
+	/// \param Header for the encryption
+	/// \param Message for the encryption
+	/// \param C1 reference outputs the cipher for the message
+	/// \param C2 reference outputs the commitment
+	/// \param Nonce outputs the used nonce for the decryption
+    void Enc(const std::string& Key,
+             const std::string& Header,
+             const std::string& Message,
+             std::string& C1,
+             std::string& C2,
+             std::string& Nonce)
+    {
+        if (mSequencer != NULL)
+        {
+            mSequencer->Next(mReservation, mNonce);
+            mCE->SetNonce(mNonce);
+        }
+        Nonce.assign(mCE->GetNonce());
+        mCE->Enc(Key, Header, Message, C1, C2);
+        mCE->IncreaseNonce();
+    }
+    /// \brief Decrypts the C1 and C2 with the Header
+	/// \param Key for the decryption
+	/// \param Nonce the nonce of the encryption
+	/// \param Header for the decryption
+	/// \param C1 the cipher for the message
+	/// \param C2 the commitment
+	/// \param Message outputs the decrypted message
+	/// \param Keyf outputs the opening key for verification
+    bool Dec(const std::string& Key,
+             const std::string& Nonce,
+             const std::string& Header,
+             const std::string& C1,
+             const std::string& C2,
+             std::string& Message,
+             std::string& Keyf)
+    {
+        mDecNonce.assign(mCE->GetNonce());
+        mCE->SetNonce(Nonce);
+        bool Success = mCE->Dec(Key, Header, C1, C2, Message, Keyf);
+        mCE->SetNonce(mDecNonce);
+        return Success;
+    }
+    /// \brief Verifies the Header and Message for a commitment
+	/// \param Header for the verification
+	/// \param Message for the verification
+	/// \param Keyf opening key for the verification
+	/// \param C2 the commitment to verify
+    bool Ver(const std::string& Header,
+             const std::string& Message,
+             const std::string& Keyf,
+             const std::string& C2)
+    {
+        return mCE->Ver(Header, Message, Keyf, C2);
+    }
+    /// \brief Returns the scheme of the context for the span, batch and incremental functions
+    ICEScheme& GetScheme()
+    {
+        return *mCE;
+    }
+
+private:
+    ICEScheme* mCE;
+    // Shared sequencer and the counters reserved by this context, if given
+    NonceSequencer* mSequencer;
+    NonceSequencer::Reservation mReservation;
+    std::string mNonce;
+    // Nonce of the next encryption while a decryption runs
+    std::string mDecNonce;
+};
+
+#endif
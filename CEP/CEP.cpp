@@ -1,156 +1,268 @@
 using namespace std;
 
 #include <cryptopp/cryptlib.h>
-#include <cryptopp/filters.h>
 using namespace CryptoPP;
 
 #include "CEP.h"
+#include "../SchemeFactory.h"
 
 void CEP::Enc(const string& Key,
-              const string& Header,
-              const string& Message,
-              string& C1,
-              string& C2)
+              const unsigned char* Header,
+              size_t HeaderLength,
+              const unsigned char* Message,
+              size_t MessageLength,
+              unsigned char* C1,
+              size_t& C1Length,
+              unsigned char* C2,
+              size_t& C2Length)
+{
+    if (C1Length < GetCiphertextSize(HeaderLength, MessageLength) || C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CEP");
+    }
+    // The whole message is one part, C is written to the start of C1
+    // and T directly behind it
+    StartEnc(Key, Header, HeaderLength);
+    size_t CipherSize = C1Length;
+    UpdateEnc(Message, MessageLength, C1, CipherSize);
+    size_t TagSize = C1Length - CipherSize;
+    FinishEnc(C1 + CipherSize, TagSize, C2, C2Length);
+    C1Length = CipherSize + TagSize;
+    return;
+}
+
+bool CEP::Dec(const string& Key,
+              const unsigned char* Header,
+              size_t HeaderLength,
+              const unsigned char* C1,
+              size_t C1Length,
+              const unsigned char* C2,
+              size_t C2Length,
+              unsigned char* Message,
+              size_t& MessageLength,
+              string& Keyf)
+{
+    if (C1Length < mHash->TagSize())
+    {
+        MessageLength = 0;
+        return false;
+    }
+    size_t CipherSize = C1Length - mHash->TagSize();
+    if (MessageLength < GetMaxPlaintextSize(C1Length))
+    {
+        throw runtime_error("Output buffer too small for the message");
+    }
+    // T is the end of C1 = C1' || T, the message is written directly to the output
+    StartDec(Key, Header, HeaderLength, C2, C2Length, C1 + CipherSize, mHash->TagSize());
+    UpdateDec(C1, CipherSize, Message, MessageLength);
+    size_t RestLength = 0;
+    if (!FinishDec(Message + MessageLength, RestLength, Keyf))
+    {
+        memset(Message, 0x00, CipherSize);
+        MessageLength = 0;
+        return false;
+    }
+    /* return (M, Keyf) */
+    return true;
+}
+
+bool CEP::Ver(const unsigned char* Header,
+              size_t HeaderLength,
+              const unsigned char* Message,
+              size_t MessageLength,
+              const string& Keyf,
+              const unsigned char* C2,
+              size_t C2Length)
+{
+    StartVer(Header, HeaderLength, Keyf, C2, C2Length);
+    UpdateVer(Message, MessageLength);
+    return FinishVer();
+}
+
+void CEP::StartEnc(const string& Key,
+                   const unsigned char* Header,
+                   size_t HeaderLength)
 {
     const uint32_t MACKEYSIZE = mHash->DefaultKeyLength();
     // Setup G
-    mG->SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
-                     (const unsigned char*)mNonce.data(), mNonce.size());
+    SetupG(Key);
     /* P <- G(K, N, |M| + 2*n), different than the paper */
     // Here we use the encryption that already xors the input
     // Thats why we get the ciphertext directly from the pad
-    uint32_t MessageSize = Message.size();
-    string Padding(2*MACKEYSIZE, 0x00);
-    string P0;
-    string P1;
-    StreamTransformationFilter Encryptor(mG->Ref(), NULL);
-    Encryptor.Put((unsigned char*)Padding.data(), Padding.size());
-    Encryptor.Put((unsigned char*)Message.data(), Message.size());
-    Encryptor.MessageEnd();
-    // Remove data from filter
-    size_t PadSize = (size_t)-1;
-    PadSize = Encryptor.MaxRetrievable();
-    // Split pad P into P0, P1 and C1
-    if (PadSize == MessageSize + 2*MACKEYSIZE)
-    {
-        P0.resize(MACKEYSIZE);
-        P1.resize(MACKEYSIZE);
-        C1.resize(MessageSize);
-        // Get P0
-        Encryptor.Get((unsigned char*)P0.data(), P0.size());
-        // Get P1
-        Encryptor.Get((unsigned char*)P1.data(), P1.size());
-        // Get C1 = (P2 || ... || Pm+1)
-        Encryptor.Get((unsigned char*)C1.data(), MessageSize);
-    }
+    // Split pad P into P0, P1 and C1 = (P2 || ... || Pm+1),
+    // the rest of the pad is generated with every part
+    mPad.assign(2*MACKEYSIZE, 0x00);
+    mG->ProcessData((unsigned char*)&mPad[0], (const unsigned char*)mPad.data(), mPad.size());
     // Setup F_cr with P0
-    mHashCr->SetKey((const unsigned char*)P0.data(), P0.size());
+    mHashCr->SetKey((const unsigned char*)mPad.data(), MACKEYSIZE);
     /* C2 <- F_cr(P0, H || M)  */
-    string C2_Part;
-    mHashCr->Update((const unsigned char*)Header.data(), Header.size());
-    mHashCr->Update((const unsigned char*)Message.data(), Message.size());
-    C2_Part.resize(mHashCr->DigestSize());
-    mHashCr->Final((unsigned char*)C2_Part.data());
+    mHashCr->Update(Header, HeaderLength);
+}
+
+void CEP::UpdateEnc(const unsigned char* Message,
+                    size_t MessageLength,
+                    unsigned char* C1,
+                    size_t& C1Length)
+{
+    if (C1Length < MessageLength)
+    {
+        throw runtime_error("Output buffer too small for CEP");
+    }
+    // Hash before the encryption, C1 may be the message buffer
+    mHashCr->Update(Message, MessageLength);
+    mG->ProcessData(C1, Message, MessageLength);
+    C1Length = MessageLength;
+}
+
+void CEP::FinishEnc(unsigned char* C1,
+                    size_t& C1Length,
+                    unsigned char* C2,
+                    size_t& C2Length)
+{
+    const uint32_t MACKEYSIZE = mHash->DefaultKeyLength();
+    if (C1Length < mHash->DigestSize() || C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CEP");
+    }
+    mHashCr->Final(C2);
+    C2Length = mHashCr->DigestSize();
     // Setup F with P1
-    mHash->SetKey((const unsigned char*)P1.data(), P1.size());
+    mHash->SetKey((const unsigned char*)mPad.data() + MACKEYSIZE, MACKEYSIZE);
     /* T <- F(P1, C2)  */
-    string T;
-    mHash->Update((const unsigned char*)C2_Part.data(), C2_Part.size());
-    T.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)T.data());
-    /* return (C1 || T, C2) */
-    C1.append(T);
-    C2.assign(C2_Part);
-    return;
+    mHash->Update(C2, C2Length);
+    /* return (C1 || T, C2), T is the end of C1 */
+    mHash->Final(C1);
+    C1Length = mHash->DigestSize();
 }
 
-bool CEP::Dec(const string& Key,
-              const string& Header,
-              const string& C1,
-              const string& C2,
-              string& Message,
-              string& Keyf)
+void CEP::SetupG(const string& Key)
 {
-    const uint32_t MACKEYSIZE = mHash->DefaultKeyLength();
-    // Setup G
+    // The key schedule is kept for the same key, only the nonce is set
+    if (!mGKey.NeedsKey(Key))
+    {
+        mG->Resynchronize((const unsigned char*)mNonce.data(), mNonce.size());
+        return;
+    }
     mG->SetKeyWithIV((const unsigned char*)Key.data(), Key.size(),
                      (const unsigned char*)mNonce.data(), mNonce.size());
+    mGKey.SetKey(Key);
+}
+
+void CEP::StartDec(const string& Key,
+                   const unsigned char* Header,
+                   size_t HeaderLength,
+                   const unsigned char* C2,
+                   size_t C2Length,
+                   const unsigned char* Trailer,
+                   size_t TrailerLength)
+{
+    if (TrailerLength != GetTrailerSize())
+    {
+        throw runtime_error("Wrong trailer length for CEP");
+    }
+    const uint32_t MACKEYSIZE = mHash->DefaultKeyLength();
+    // T is the end of C1 = C1' || T and C2 is checked at the end
+    mTag.assign((const char*)Trailer, TrailerLength);
+    mStreamC2.assign((const char*)C2, C2Length);
+    // Setup G
+    SetupG(Key);
     /* P <- G(K, N, |M| + 2*n), different than the paper */
     // Here we use the encryption that already xors the input
     // Thats why we get the message directly from the pad
-    uint32_t CipherSize = C1.size() - mHash->TagSize();
-    string Padding(2*MACKEYSIZE, 0x00);
-    string P0, P1;
-    StreamTransformationFilter Encryptor(mG->Ref(), NULL);
-    Encryptor.Put((unsigned char*)Padding.data(), Padding.size());
-    Encryptor.Put((unsigned char*)C1.data(), CipherSize);
-    Encryptor.MessageEnd();
-    // Remove data from filter
-    size_t PadSize = (size_t)-1;
-    PadSize = Encryptor.MaxRetrievable();
-    // Split pad P into P0, P1 and M
-    if (PadSize == CipherSize + 2*MACKEYSIZE)
-    {
-        P0.resize(MACKEYSIZE);
-        P1.resize(MACKEYSIZE);
-        Message.resize(CipherSize);
-        // Get P0
-        Encryptor.Get((unsigned char*)P0.data(), P0.size());
-        // Get P1
-        Encryptor.Get((unsigned char*)P1.data(), P1.size());
-        // Get M = (P2 || ... || Pm+1)
-        Encryptor.Get((unsigned char*)Message.data(), CipherSize);
-    }
+    // Split pad P into P0, P1 and M = (P2 || ... || Pm+1)
+    mPad.assign(2*MACKEYSIZE, 0x00);
+    mG->ProcessData((unsigned char*)&mPad[0], (const unsigned char*)mPad.data(), mPad.size());
     // Setup F_cr with P0
-    mHashCr->SetKey((const unsigned char*)P0.data(), P0.size());
+    mHashCr->SetKey((const unsigned char*)mPad.data(), MACKEYSIZE);
     /* C2' <- F_cr(P0, H || M)  */
-    string C2New;
-    mHashCr->Update((const unsigned char*)Header.data(), Header.size());
-    // Message M is (P2 || ... || Pm+1)
-    mHashCr->Update((const unsigned char*)Message.data(), Message.size());
-    C2New.resize(mHashCr->DigestSize());
-    mHashCr->Final((unsigned char*)C2New.data());
+    mHashCr->Update(Header, HeaderLength);
+}
+
+void CEP::UpdateDec(const unsigned char* C1,
+                    size_t C1Length,
+                    unsigned char* Message,
+                    size_t& MessageLength)
+{
+    if (MessageLength < C1Length)
+    {
+        throw runtime_error("Output buffer too small for the message");
+    }
+    mG->ProcessData(Message, C1, C1Length);
+    mHashCr->Update(Message, C1Length);
+    MessageLength = C1Length;
+}
+
+bool CEP::FinishDec(unsigned char* /* Message */,
+                    size_t& MessageLength,
+                    string& Keyf)
+{
+    const uint32_t MACKEYSIZE = mHash->DefaultKeyLength();
+    // The whole message is already written by UpdateDec
+    MessageLength = 0;
+    mC2New.resize(mHashCr->DigestSize());
+    mHashCr->Final((unsigned char*)&mC2New[0]);
     // Setup F with P1
-    mHash->SetKey((const unsigned char*)P1.data(), P1.size());
+    mHash->SetKey((const unsigned char*)mPad.data() + MACKEYSIZE, MACKEYSIZE);
     /* T' <- F(P1, C2')  */
-    string TNew;
-    mHash->Update((const unsigned char*)C2New.data(), C2New.size());
-    TNew.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)TNew.data());
-    // Extract T from C1 = C1' || T
-    string T = C1.substr(C1.size() - mHash->TagSize());
+    mTNew.resize(mHash->DigestSize());
+    mHash->Update((const unsigned char*)mC2New.data(), mC2New.size());
+    mHash->Final((unsigned char*)&mTNew[0]);
     // If T != T′ or C2' != C2 then Return 0
-    if (T.compare(TNew) || C2.compare(C2New))
+    if (mTag.compare(0, string::npos, mTNew, 0, mTag.size()) || mStreamC2 != mC2New)
     {
-        memset(Message.data(), 0x00, Message.size());
         return false;
     }
-    /* return (M, Keyf) */
-    Keyf.assign(P0);
+    /* return (M, Keyf), M already written */
+    Keyf.assign(mPad, 0, MACKEYSIZE);
     return true;
 }
 
-bool CEP::Ver(const string& Header,
-              const string& Message,
-              const string& Keyf,
-              const string& C2)
+void CEP::StartVer(const unsigned char* Header,
+                   size_t HeaderLength,
+                   const string& Keyf,
+                   const unsigned char* C2,
+                   size_t C2Length)
 {
+    mStreamC2.assign((const char*)C2, C2Length);
     // Setup F_cr
     mHashCr->SetKey((const unsigned char*)Keyf.data(), Keyf.size());
     /* C2' <- F_cr(Kf, H || M)  */
-    string C2New;
-    mHashCr->Update((const unsigned char*)Header.data(), Header.size());
-    mHashCr->Update((const unsigned char*)Message.data(), Message.size());
-    C2New.resize(mHashCr->DigestSize());
-    mHashCr->Final((unsigned char*)C2New.data());
+    mHashCr->Update(Header, HeaderLength);
+}
+
+void CEP::UpdateVer(const unsigned char* Message,
+                    size_t MessageLength)
+{
+    mHashCr->Update(Message, MessageLength);
+}
+
+bool CEP::FinishVer()
+{
+    mC2New.resize(mHashCr->DigestSize());
+    mHashCr->Final((unsigned char*)&mC2New[0]);
     // If C2' != C2 then Return 0
-    if (C2.compare(C2New))
+    if (mStreamC2 != mC2New)
     {
         return false;
     }
     return true;
 }
 
+size_t CEP::GetTrailerSize()
+{
+    // T is the end of C1
+    return mHash->TagSize();
+}
+
+ICEScheme* CEP::Clone() const
+{
+    CEP* Copy = new CEP(SchemeFactory::CreateMAC(mHash),
+                        SchemeFactory::CreateMAC(mHashCr),
+                        SchemeFactory::CreateCipher(mG));
+    Copy->mNonce = mNonce;
+    return Copy;
+}
+
 const string& CEP::GetClassDecription()
 {
     return cClassDescription;
@@ -165,3 +277,20 @@ uint32_t CEP::GetNonceSize()
 {
     return mG->IVSize();
 }
+
+size_t CEP::GetCiphertextSize(size_t /* HeaderLength */,
+                              size_t MessageLength)
+{
+    // C1 = C || T
+    return MessageLength + mHash->DigestSize();
+}
+
+size_t CEP::GetCommitmentSize()
+{
+    return mHashCr->DigestSize();
+}
+
+size_t CEP::GetMaxPlaintextSize(size_t C1Length)
+{
+    return C1Length < mHash->TagSize() ? 0 : C1Length - mHash->TagSize();
+}
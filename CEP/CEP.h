@@ -7,6 +7,7 @@
 #include <cryptopp/hmac.h>
 
 #include "../ICEScheme.h"
+#include "../KeyContext.h"
 
 class CEP: public ICEScheme
 {
@@ -27,31 +28,98 @@ public:
     {
         delete mHash;
         delete mHashCr;
+        delete mG;
     }
 
+    using ICEScheme::Enc;
+    using ICEScheme::Dec;
+    using ICEScheme::Ver;
     void Enc(const std::string& Key,
-             const std::string& Header,
-             const std::string& Message,
-             std::string& C1,
-             std::string& C2);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
+             unsigned char* C1,
+             size_t& C1Length,
+             unsigned char* C2,
+             size_t& C2Length);
     bool Dec(const std::string& Key,
-             const std::string& Header,
-             const std::string& C1,
-             const std::string& C2,
-             std::string& Message,
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* C1,
+             size_t C1Length,
+             const unsigned char* C2,
+             size_t C2Length,
+             unsigned char* Message,
+             size_t& MessageLength,
              std::string& Keyf);
-    bool Ver(const std::string& Header,
-             const std::string& Message,
+    bool Ver(const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
              const std::string& Keyf,
-             const std::string& C2);
+             const unsigned char* C2,
+             size_t C2Length);
+    void StartEnc(const std::string& Key,
+                  const unsigned char* Header,
+                  size_t HeaderLength);
+    void UpdateEnc(const unsigned char* Message,
+                   size_t MessageLength,
+                   unsigned char* C1,
+                   size_t& C1Length);
+    void FinishEnc(unsigned char* C1,
+                   size_t& C1Length,
+                   unsigned char* C2,
+                   size_t& C2Length);
+    void StartDec(const std::string& Key,
+                  const unsigned char* Header,
+                  size_t HeaderLength,
+                  const unsigned char* C2,
+                  size_t C2Length,
+                  const unsigned char* Trailer,
+                  size_t TrailerLength);
+    void UpdateDec(const unsigned char* C1,
+                   size_t C1Length,
+                   unsigned char* Message,
+                   size_t& MessageLength);
+    bool FinishDec(unsigned char* Message,
+                   size_t& MessageLength,
+                   std::string& Keyf);
+    void StartVer(const unsigned char* Header,
+                  size_t HeaderLength,
+                  const std::string& Keyf,
+                  const unsigned char* C2,
+                  size_t C2Length);
+    void UpdateVer(const unsigned char* Message,
+                   size_t MessageLength);
+    bool FinishVer();
+    size_t GetTrailerSize();
+    ICEScheme* Clone() const;
     const std::string& GetClassDecription();
     uint32_t GetKeySize();
     uint32_t GetNonceSize();
+    size_t GetCiphertextSize(size_t HeaderLength,
+                             size_t MessageLength);
+    size_t GetCommitmentSize();
+    size_t GetMaxPlaintextSize(size_t C1Length);
 
 private:
+    /// \brief Sets the key and the nonce of G
+	/// \param Key for G
+    /// \details Only the nonce is set if G already has the key
+    void SetupG(const std::string& Key);
+
     CryptoPP::MessageAuthenticationCode* mHash;
     CryptoPP::MessageAuthenticationCode* mHashCr;
     CryptoPP::SymmetricCipher* mG;
+    // Key of the key schedule in G
+    KeyContext mGKey;
+    // P0 || P1 and T of the incremental functions
+    std::string mPad;
+    std::string mTag;
+    // Recomputed C2 and T, kept to avoid allocations per message
+    std::string mC2New;
+    std::string mTNew;
     const std::string cClassDescription;
 };
 #endif
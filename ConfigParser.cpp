@@ -3,18 +3,25 @@
 #include <fstream>
 using namespace std;
 
-#include <cryptopp/osrng.h>
-using namespace CryptoPP;
-
 #include "ConfigParser.h"
+#include "Random.h"
+#include "RandomBuffer.h"
 #include "ICEScheme.h"
 #include "Tester.h"
+#include "ThroughputTester.h"
+#include "SweepTester.h"
+#include "MatrixTester.h"
+#include "OpenLoopTester.h"
+#include "ReplayTester.h"
+#include "StreamTester.h"
+#include "BatchTester.h"
+#include "VerificationTester.h"
 
 /* A really simple "kind of" xml parser 
  * for creating the tester to test different schemes
  * ConfigName: Path to the config file to read
 */
-SchemeTester* ConfigParser::ReadConfig(const string& ConfigName)
+Tester* ConfigParser::ReadConfig(const string& ConfigName)
 {
     ifstream ConfigFile;
     ConfigFile.open(ConfigName);
@@ -44,20 +51,347 @@ SchemeTester* ConfigParser::ReadConfig(const string& ConfigName)
         {
             Nonce = GenerateRandomString(Nonce);
         }
-        string Header = ReadToken(Content, {"Header"});
-        string Message = ReadToken(Content, {"Message"});
-        ICEScheme* Scheme = ReadScheme(Content);
-        return new SchemeTester(Iterations,
-                                Logfile,
-                                Key,
-                                Nonce,
-                                Header,
-                                Message,
-                                Scheme);
+        Tester* Test = NULL;
+        vector<string> Schemes = ExpandSchemes(Content);
+        vector<string> Messages = ReadTokens(Content, "Message");
+        if (HasToken(Content, "Sweep"))
+        {
+            // Messages and headers are generated for every point of the grid
+            Test = ReadSweep(Content, Iterations, Logfile, Key, Nonce);
+        }
+        else if (HasToken(Content, "OpenLoop"))
+        {
+            // Requests at a planned rate instead of back to back
+            Test = ReadOpenLoop(Content, Iterations, Logfile, Key, Nonce);
+        }
+        else if (HasToken(Content, "Workload"))
+        {
+            // Messages and headers are generated from the workload file
+            uint64_t Seed = HasToken(Content, "Seed") ? StringToInt(ReadToken(Content, {"Seed"})) : 0;
+            Test = new ReplayTester(Iterations,
+                                    Logfile,
+                                    Key,
+                                    Nonce,
+                                    ReadToken(Content, {"Workload"}),
+                                    ReadScheme(Content),
+                                    Seed);
+        }
+        else if (HasToken(Content, "Stream"))
+        {
+            // The message file is streamed in chunks, C1 goes to a file
+            string StreamConfig = ReadToken(Content, {"Stream"});
+            string Header = ReadToken(Content, {"Header"});
+            Test = new StreamTester(Iterations,
+                                    Logfile,
+                                    Key,
+                                    Nonce,
+                                    Header,
+                                    ReadToken(Content, {"Message"}),
+                                    ReadToken(StreamConfig, {"Cipherfile"}),
+                                    StringToInt(ReadToken(StreamConfig, {"Chunksize"})),
+                                    ReadScheme(Content));
+        }
+        else if (HasToken(Content, "Batch"))
+        {
+            // Small messages in batches of growing size
+            string BatchConfig = ReadToken(Content, {"Batch"});
+            vector<uint32_t> BatchSizes = SweepTester::GeometricGrid(StringToInt(ReadToken(BatchConfig, {"MinBatchSize"})),
+                                                                     StringToInt(ReadToken(BatchConfig, {"MaxBatchSize"})),
+                                                                     StringToInt(ReadToken(BatchConfig, {"BatchFactor"})));
+            Test = new BatchTester(Iterations,
+                                   Logfile,
+                                   Key,
+                                   Nonce,
+                                   StringToInt(ReadToken(BatchConfig, {"Headersize"})),
+                                   StringToInt(ReadToken(BatchConfig, {"Messagesize"})),
+                                   BatchSizes,
+                                   ReadScheme(Content));
+        }
+        else if (HasToken(Content, "Verification"))
+        {
+            // Bursts of reports of mixed sizes on the verification engine
+            string VerificationConfig = ReadToken(Content, {"Verification"});
+            Test = new VerificationTester(Iterations,
+                                          Logfile,
+                                          Key,
+                                          Nonce,
+                                          StringToInt(ReadToken(VerificationConfig, {"Headersize"})),
+                                          StringToInt(ReadToken(VerificationConfig, {"MinMessageSize"})),
+                                          StringToInt(ReadToken(VerificationConfig, {"MaxMessageSize"})),
+                                          StringToInt(ReadToken(VerificationConfig, {"Reports"})),
+                                          StringToInt(ReadToken(VerificationConfig, {"Threads"})),
+                                          ReadScheme(Content));
+        }
+        else if (HasToken(Content, "Threads"))
+        {
+            string Header = ReadToken(Content, {"Header"});
+            string Message = ReadToken(Content, {"Message"});
+            // Every thread gets its own context of the scheme
+            Test = new ThroughputTester(Iterations,
+                                        Logfile,
+                                        Key,
+                                        Nonce,
+                                        Header,
+                                        Message,
+                                        ReadScheme(Content),
+                                        StringToInt(ReadToken(Content, {"Threads"})));
+        }
+        else if (Schemes.size() * Messages.size() > 1)
+        {
+            // Every scheme is tested with every message in one run
+            Test = ReadMatrix(Content, Iterations, Logfile, Key, Nonce, Schemes, Messages);
+        }
+        else
+        {
+            string Header = ReadToken(Content, {"Header"});
+            string Message = ReadToken(Content, {"Message"});
+            ICEScheme* Scheme = ReadScheme(Content);
+            Test = new SchemeTester(Iterations,
+                                    Logfile,
+                                    Key,
+                                    Nonce,
+                                    Header,
+                                    Message,
+                                    Scheme);
+        }
+        // Optional warmup rounds which are not part of the results
+        if (HasToken(Content, "Warmup"))
+        {
+            Test->SetWarmup(StringToInt(ReadToken(Content, {"Warmup"})));
+        }
+        // Optional stop before all iterations are done, <Iterations> is the maximum
+        if (HasToken(Content, "Convergence"))
+        {
+            string Convergence = ReadToken(Content, {"Convergence"});
+            double RelativeError = 0.0;
+            uint32_t TimeBudget = 0;
+            if (HasToken(Convergence, "RelativeError"))
+            {
+                // Given in percent
+                RelativeError = StringToDouble(ReadToken(Convergence, {"RelativeError"})) / 100.0;
+            }
+            if (HasToken(Convergence, "TimeBudget"))
+            {
+                TimeBudget = StringToInt(ReadToken(Convergence, {"TimeBudget"}));
+            }
+            Test->SetConvergence(RelativeError, TimeBudget);
+        }
+        // Optional hardware performance counters for the main thread
+        if (HasToken(Content, "PerfCounters") && StringToInt(ReadToken(Content, {"PerfCounters"})) != 0)
+        {
+            if (!Test->EnablePerfCounters())
+            {
+                Test->HandleOutput("Performance counters are not available (" +
+                                   Test->GetPerfCountersError() + "), only times are measured");
+            }
+        }
+        // Optional ring of random blocks for the opening keys, filled by a background thread
+        if (HasToken(Content, "RandomBuffer"))
+        {
+            RandomBuffer::Start(StringToInt(ReadToken(Content, {"RandomBuffer"})));
+        }
+        // Optional machine readable results, CSV or JSON lines
+        if (HasToken(Content, "Results"))
+        {
+            Test->SetResultWriter(make_shared<ResultWriter>(ReadToken(Content, {"Results"})));
+        }
+        return Test;
     }
     throw runtime_error("Could not open file: " + ConfigName);
 }
 
+Tester* ConfigParser::ReadSweep(const string& ConfigString,
+                                uint32_t Iterations,
+                                string& Logfile,
+                                string& Key,
+                                string& Nonce)
+{
+    string SweepConfig = ReadToken(ConfigString, {"Sweep"});
+    vector<uint32_t> MessageSizes = SweepTester::GeometricGrid(StringToInt(ReadToken(SweepConfig, {"MinMessageSize"})),
+                                                               StringToInt(ReadToken(SweepConfig, {"MaxMessageSize"})),
+                                                               StringToInt(ReadToken(SweepConfig, {"MessageFactor"})));
+    vector<uint32_t> HeaderSizes = SweepTester::GeometricGrid(StringToInt(ReadToken(SweepConfig, {"MinHeaderSize"})),
+                                                              StringToInt(ReadToken(SweepConfig, {"MaxHeaderSize"})),
+                                                              StringToInt(ReadToken(SweepConfig, {"HeaderFactor"})));
+    uint64_t BytesPerPoint = (uint64_t)StringToInt(ReadToken(SweepConfig, {"MegabytesPerPoint"})) << 20;
+    ICEScheme* Scheme = ReadScheme(ConfigString);
+    return new SweepTester(Iterations,
+                           Logfile,
+                           Key,
+                           Nonce,
+                           MessageSizes,
+                           HeaderSizes,
+                           BytesPerPoint,
+                           Scheme);
+}
+
+Tester* ConfigParser::ReadOpenLoop(const string& ConfigString,
+                                   uint32_t Iterations,
+                                   string& Logfile,
+                                   string& Key,
+                                   string& Nonce)
+{
+    string OpenLoopConfig = ReadToken(ConfigString, {"OpenLoop"});
+    string Header = ReadToken(ConfigString, {"Header"});
+    string Message = ReadToken(ConfigString, {"Message"});
+    string Arrival = ReadToken(OpenLoopConfig, {"Arrival"});
+    if ("Poisson" != Arrival && "Constant" != Arrival)
+    {
+        throw runtime_error("Not a valid arrival: " + Arrival);
+    }
+    vector<double> Rates = OpenLoopTester::GeometricRates(StringToDouble(ReadToken(OpenLoopConfig, {"MinRate"})),
+                                                          StringToDouble(ReadToken(OpenLoopConfig, {"MaxRate"})),
+                                                          StringToInt(ReadToken(OpenLoopConfig, {"RateSteps"})));
+    double SecondsPerRate = StringToDouble(ReadToken(OpenLoopConfig, {"SecondsPerRate"}));
+    uint32_t LatencyBudget = StringToInt(ReadToken(OpenLoopConfig, {"LatencyBudget"}));
+    // Every worker gets its own context of the scheme
+    return new OpenLoopTester(Iterations,
+                              Logfile,
+                              Key,
+                              Nonce,
+                              Header,
+                              Message,
+                              ReadScheme(ConfigString),
+                              StringToInt(ReadToken(OpenLoopConfig, {"Workers"})),
+                              "Poisson" == Arrival,
+                              Rates,
+                              SecondsPerRate,
+                              LatencyBudget);
+}
+
+Tester* ConfigParser::ReadMatrix(const string& ConfigString,
+                                 uint32_t Iterations,
+                                 string& Logfile,
+                                 string& Key,
+                                 string& Nonce,
+                                 vector<string>& Schemes,
+                                 vector<string>& Messages)
+{
+    string Header = ReadToken(ConfigString, {"Header"});
+    uint64_t Seed = 0;
+    if (HasToken(ConfigString, "Seed"))
+    {
+        Seed = StringToInt(ReadToken(ConfigString, {"Seed"}));
+    }
+    vector<SchemeTester*> Cells;
+    try
+    {
+        for (string& Message: Messages)
+        {
+            for (string& Scheme: Schemes)
+            {
+                Cells.push_back(new SchemeTester(Iterations,
+                                                 Logfile,
+                                                 Key,
+                                                 Nonce,
+                                                 Header,
+                                                 Message,
+                                                 ReadScheme(Scheme)));
+            }
+        }
+    }
+    catch (...)
+    {
+        for (SchemeTester* Cell: Cells)
+        {
+            delete Cell;
+        }
+        throw;
+    }
+    return new MatrixTester(Iterations, Logfile, Cells, Seed);
+}
+
+vector<string> ConfigParser::ExpandSchemes(const string& ConfigString)
+{
+    const vector<string> ListTokens{"HFC", "Hash", "HashCr", "PRG", "Encryption"};
+    const vector<string> AEADTokens{"EtM", "AES_GCM"};
+    // Stack of configs which can contain lists, the first scheme on top
+    vector<string> Open;
+    vector<string> SchemeStrings = ReadTokens(ConfigString, "Scheme");
+    for (auto It = SchemeStrings.rbegin(); It != SchemeStrings.rend(); It++)
+    {
+        Open.push_back("<Scheme>" + *It + "</Scheme>");
+    }
+    vector<string> Schemes;
+    while (!Open.empty())
+    {
+        string Config = Open.back();
+        Open.pop_back();
+        // An AEAD with more than one scheme inside is a list, it is expanded
+        // first, so the lists inside an EtM are only expanded for the EtM
+        size_t ListBegin = string::npos;
+        size_t ListEnd = string::npos;
+        vector<string> Items;
+        size_t AEADBegin = Config.find("<AEAD>");
+        size_t AEADEnd = Config.find("</AEAD>");
+        if (AEADBegin != string::npos && AEADEnd != string::npos)
+        {
+            AEADBegin += 6;
+            string AEADString = Config.substr(AEADBegin, AEADEnd - AEADBegin);
+            vector<string> AEADs;
+            for (const string& Token: AEADTokens)
+            {
+                for (string& AEAD: ReadTokens(AEADString, Token))
+                {
+                    AEADs.push_back("<" + Token + ">" + AEAD + "</" + Token + ">");
+                }
+            }
+            if (AEADs.size() > 1)
+            {
+                ListBegin = AEADBegin;
+                ListEnd = AEADEnd;
+                Items = AEADs;
+            }
+        }
+        // Otherwise search the first list in the config, by position as <Hash>
+        // can be used by the scheme and by the AEAD
+        if (Items.empty())
+        {
+            for (const string& Token: ListTokens)
+            {
+                size_t First = Config.find("<" + Token + ">");
+                while (First != string::npos)
+                {
+                    First += Token.size() + 2;
+                    size_t Last = Config.find("</" + Token + ">", First);
+                    if (Last == string::npos)
+                    {
+                        break;
+                    }
+                    string Content = Config.substr(First, Last - First);
+                    if (Content.find(',') != string::npos && First < ListBegin)
+                    {
+                        ListBegin = First;
+                        ListEnd = Last;
+                        Items.clear();
+                        stringstream ListStream(Content);
+                        string Item;
+                        while (getline(ListStream, Item, ','))
+                        {
+                            Item.erase(0, Item.find_first_not_of(" \t\r\n"));
+                            Item.erase(Item.find_last_not_of(" \t\r\n") + 1);
+                            Items.push_back(Item);
+                        }
+                        break;
+                    }
+                    First = Config.find("<" + Token + ">", Last);
+                }
+            }
+        }
+        if (ListBegin == string::npos)
+        {
+            Schemes.push_back(Config);
+            continue;
+        }
+        // Keep the order of the list for the results
+        for (auto It = Items.rbegin(); It != Items.rend(); It++)
+        {
+            Open.push_back(Config.substr(0, ListBegin) + *It + Config.substr(ListEnd));
+        }
+    }
+    return Schemes;
+}
+
 string ConfigParser::RemoveXMLComments(const string& ConfigString)
 {
     string ReturnConfig = ConfigString;
@@ -119,6 +453,33 @@ string ConfigParser::ReadToken(const string& ConfigString,
     throw runtime_error("Could not find " + TokenString + " in config file");
 }
 
+vector<string> ConfigParser::ReadTokens(const string& ConfigString,
+                                        const string& Token)
+{
+    vector<string> Contents;
+    size_t First = ConfigString.find("<" + Token + ">");
+    while (First != string::npos)
+    {
+        First += Token.size() + 2;
+        size_t Last = ConfigString.find("</" + Token + ">", First);
+        if (Last == string::npos)
+        {
+            break;
+        }
+        Contents.push_back(ConfigString.substr(First, Last - First));
+        First = ConfigString.find("<" + Token + ">", Last);
+    }
+    return Contents;
+}
+
+bool ConfigParser::HasToken(const string& ConfigString,
+                            const string& Token)
+{
+    size_t First = ConfigString.find("<" + Token + ">");
+    size_t Last = ConfigString.find("</" + Token + ">");
+    return First != string::npos && Last != string::npos && First < Last;
+}
+
 ICEScheme* ConfigParser::ReadScheme(const string& ConfigString)
 {
     vector<string> SchemeToken{"CEP", "CtE1", "CtE2", "CETransform"};
@@ -183,12 +544,7 @@ IAEADScheme* ConfigParser::ReadAEAD(const string& ConfigString)
 
 string ConfigParser::GenerateRandomString(const string& NumberString)
 {
-    AutoSeededRandomPool Rnd;
-    uint32_t Size = StringToInt(NumberString);
-    SecByteBlock Buffer(0x00, Size);
-    Rnd.GenerateBlock(Buffer, Buffer.size());
-    string Key((const char*)Buffer.data(), Buffer.size());
-    return Key;
+    return RandomGenerator::Generate(StringToInt(NumberString));
 }
 
 uint32_t ConfigParser::StringToInt(const string& NumberString)
@@ -204,6 +560,22 @@ uint32_t ConfigParser::StringToInt(const string& NumberString)
     return stoi(NumberString);
 }
 
+double ConfigParser::StringToDouble(const string& NumberString)
+{
+    size_t Point = NumberString.find('.');
+    if (Point == string::npos)
+    {
+        return StringToInt(NumberString);
+    }
+    string Integer = NumberString.substr(0, Point);
+    string Fraction = NumberString.substr(Point + 1);
+    if ((!Integer.empty() && !Is_Number(Integer)) || !Is_Number(Fraction))
+    {
+        throw runtime_error("Not a valid number");
+    }
+    return stod(NumberString);
+}
+
 bool ConfigParser::Is_Number(const string& NumberString)
 {
     string::const_iterator It = NumberString.begin();
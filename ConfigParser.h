@@ -7,7 +7,7 @@
 #include "SchemeFactory.h"
 class ICEScheme;
 class IAEADScheme;
-class SchemeTester;
+class Tester;
 
 /// \brief ConfigParser class which parses a provided config file
 /// \details It parses the config file and returns a fitting Tester
@@ -23,9 +23,62 @@ public:
     ~ConfigParser() {}
 	/// \brief Reads a config file and returns a Tester reference
 	/// \param ConfigName path to the config file
-    SchemeTester* ReadConfig(const std::string& ConfigName);
+    /// \details Returns a SweepTester if the config contains <Sweep>,
+    /// a ThroughputTester if the config contains <Threads>, an OpenLoopTester
+    /// if the config contains <OpenLoop>, a ReplayTester if the config
+    /// contains <Workload>, a StreamTester if the config contains <Stream>,
+    /// a BatchTester if the config contains <Batch>, a VerificationTester
+    /// if the config contains <Verification>, a MatrixTester
+    /// if the config contains more than one scheme or message
+    /// and a SchemeTester otherwise
+    Tester* ReadConfig(const std::string& ConfigName);
 
 private:
+	/// \brief Returns a SweepTester from the provided config
+	/// \param ConfigString a string with a xml config
+	/// \param Iterations maximal number of iterations per point
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+    /// \details Searches for the <Sweep> tag and parses the grids inside
+    Tester* ReadSweep(const std::string& ConfigString,
+                      uint32_t Iterations,
+                      std::string& Logfile,
+                      std::string& Key,
+                      std::string& Nonce);
+	/// \brief Returns an OpenLoopTester from the provided config
+	/// \param ConfigString a string with a xml config
+	/// \param Iterations maximal number of requests per rate
+	/// \param Logfile path of the logfile
+	/// \param Key for the schemes to test
+	/// \param Nonce for the schemes to test
+    /// \details Searches for the <OpenLoop> tag and parses the workers and rates inside
+    Tester* ReadOpenLoop(const std::string& ConfigString,
+                         uint32_t Iterations,
+                         std::string& Logfile,
+                         std::string& Key,
+                         std::string& Nonce);
+	/// \brief Returns a MatrixTester for every scheme and message
+	/// \param ConfigString a string with a xml config
+	/// \param Iterations number of iterations per cell
+	/// \param Logfile path of the logfile
+	/// \param Key for the schemes to test
+	/// \param Nonce for the schemes to test
+	/// \param Schemes the single scheme configs from ExpandSchemes
+	/// \param Messages the content of every <Message> tag
+    Tester* ReadMatrix(const std::string& ConfigString,
+                       uint32_t Iterations,
+                       std::string& Logfile,
+                       std::string& Key,
+                       std::string& Nonce,
+                       std::vector<std::string>& Schemes,
+                       std::vector<std::string>& Messages);
+	/// \brief Returns the config of every single scheme in the config
+	/// \param ConfigString a string with a xml config
+    /// \details Every <Scheme> tag is expanded to the cross product of its
+    /// comma separated lists (e.g. <HFC>SHA256_HFC, SHA3_HFC</HFC>) and the
+    /// children of its <AEAD> tags, every result contains one <Scheme> tag
+    std::vector<std::string> ExpandSchemes(const std::string& ConfigString);
 	/// \brief Removes the comments in the string
 	/// \param ConfigString a string with a xml config
     /// \details A recognized comment starts with <!- and ends with ->
@@ -45,6 +98,16 @@ private:
     std::string ReadToken(const std::string& ConfigString,
                           std::vector<std::string> Tokens,
                           std::string& SuccessToken);
+	/// \brief Returns the content of every found token in order
+	/// \param ConfigString a string with a xml config
+	/// \param Token the token to search for without brackets
+    std::vector<std::string> ReadTokens(const std::string& ConfigString,
+                                        const std::string& Token);
+	/// \brief Returns true if the token is inside the config
+	/// \param ConfigString a string with a xml config
+	/// \param Token the token to search for without brackets
+    bool HasToken(const std::string& ConfigString,
+                  const std::string& Token);
 	/// \brief Returns a CE scheme from the provided config
 	/// \param ConfigString a string with a xml config
     /// \details Searches for the <Scheme> tag and parses the
@@ -61,6 +124,9 @@ private:
 	/// \brief Converts string to an integer
 	/// \param NumberString string of a number
     uint32_t StringToInt(const std::string& NumberString);
+	/// \brief Converts string to a floating point number
+	/// \param NumberString string of a number with an optional decimal point
+    double StringToDouble(const std::string& NumberString);
 	/// \brief Returns true if string is a number
 	/// \param NumberString string of a number
     bool Is_Number(const std::string& NumberString);
@@ -1,96 +1,150 @@
 using namespace std;
 
-#include <cryptopp/osrng.h>
+#include <cryptopp/cryptlib.h>
 using namespace CryptoPP;
 
 #include "CtE1.h"
+#include "../SchemeFactory.h"
 
 void CtE1::Enc(const string& Key,
-               const string& Header,
-               const string& Message,
-               string& C1,
-               string& C2)
+               const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* Message,
+               size_t MessageLength,
+               unsigned char* C1,
+               size_t& C1Length,
+               unsigned char* C2,
+               size_t& C2Length)
 {
+    if (C1Length < GetCiphertextSize(HeaderLength, MessageLength) || C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CtE1");
+    }
     // (Kf, C2) <-$ Com(H || M), we do Com with HMAC
-    AutoSeededRandomPool Rnd;
-    SecByteBlock Keyf(0x00, mHash->DefaultKeyLength());
+    mKeyf.resize(mHash->DefaultKeyLength());
     /* Kf <-$ {0, 1}^n */
-    Rnd.GenerateBlock(Keyf, Keyf.size());
+    GenerateRandom(mKeyf, mKeyf.size());
     // Setup HMAC
-    mHash->SetKey(Keyf, Keyf.size());
+    mHash->SetKey(mKeyf, mKeyf.size());
     /* C2 <- HMAC(Keyf, H || M || Keyf) */
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    mHash->Update(Keyf.BytePtr(), Keyf.size());
-    C2.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2.data());
+    mHash->Update(Header, HeaderLength);
+    mHash->Update(Message, MessageLength);
+    mHash->Update(mKeyf.BytePtr(), mKeyf.size());
+    mHash->Final(C2);
+    C2Length = mHash->DigestSize();
     /* C1 <- Enc(Key, C2, M || Keyf), with AEAD scheme C1 = C || T */
-    mAEAD->StartEnc(Key, mNonce, C2, (unsigned char*)Message.data(), Message.size());
-    mAEAD->UpdateEnc((unsigned char*)Keyf.data(), Keyf.size());
-    mAEAD->FinishEnc(C1);
+    // C2 is the associated data, so the AEAD can only start after the
+    // whole message is hashed and there is no incremental encryption
+    mAEAD->StartEnc(Key, mNonce, C2, C2Length);
+    size_t CipherSize = C1Length;
+    mAEAD->UpdateEnc(Message, MessageLength, C1, CipherSize);
+    size_t KeyfCipherSize = C1Length - CipherSize;
+    mAEAD->UpdateEnc(mKeyf.BytePtr(), mKeyf.size(), C1 + CipherSize, KeyfCipherSize);
+    CipherSize += KeyfCipherSize;
+    size_t TagSize = C1Length - CipherSize;
+    mAEAD->FinishEnc(C1 + CipherSize, TagSize);
+    C1Length = CipherSize + TagSize;
     /* Return (C || T, C2), already created */
     return;
 }
 
 bool CtE1::Dec(const string& Key,
-               const string& Header,
-               const string& C1,
-               const string& C2,
-               string& Message,
+               const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* C1,
+               size_t C1Length,
+               const unsigned char* C2,
+               size_t C2Length,
+               unsigned char* Message,
+               size_t& MessageLength,
                string& Keyf)
 {
     /* M || Keyf <- Dec(Key, C2, C1), with AEAD scheme */
-    bool Success = mAEAD->PDec(Key, mNonce, C2, (unsigned char*)C1.data(), C1.size(), Message);
+    size_t OutputLength = MessageLength;
+    bool Success = mAEAD->Dec(Key, mNonce, C2, C2Length, C1, C1Length, Message, OutputLength);
     /* If M = 0 then Return 0 */
-    if (!Success)
+    size_t KeyfSize = mHash->DefaultKeyLength();
+    if (!Success || OutputLength < KeyfSize)
     {
-        memset(Message.data(), 0x00, Message.size());
+        MessageLength = 0;
         return false;
     }
-    // Setup HMAC with Keyf
-    string KeyfString = (Message.substr(Message.size() - mHash->DefaultKeyLength()));
-    mHash->SetKey((const unsigned char*)KeyfString.data(), KeyfString.size());
+    // Setup HMAC with Keyf, it is the end of the output
+    const unsigned char* KeyfPointer = Message + OutputLength - KeyfSize;
+    mHash->SetKey(KeyfPointer, KeyfSize);
     /* b <- VerC(Keyf, C2, H || M), here with HMAC */
     /* HMAC(Keyf, H || M || Keyf) */
-    string C2New;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    C2New.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2New.data());
+    mC2New.resize(mHash->DigestSize());
+    mHash->Update(Header, HeaderLength);
+    mHash->Update(Message, OutputLength);
+    mHash->Final((unsigned char*)&mC2New[0]);
     /* If C2 != HMAC(Keyf, H || M || Keyf) then Return 0 */
-    if (C2.compare(C2New))
+    if (C2Length != mC2New.size() || memcmp(C2, mC2New.data(), mC2New.size()))
     {
-        memset(Message.data(), 0x00, Message.size());
+        memset(Message, 0x00, OutputLength);
+        MessageLength = 0;
         return false;
     }
     /* Return (M, Keyf) */
-    Message.resize(Message.size() - KeyfString.size());
-    Keyf.assign(KeyfString);
+    Keyf.assign((const char*)KeyfPointer, KeyfSize);
+    MessageLength = OutputLength - KeyfSize;
     return true;
 }
 
-bool CtE1::Ver(const string& Header,
-               const string& Message,
+bool CtE1::Ver(const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* Message,
+               size_t MessageLength,
                const string& Keyf,
-               const string& C2)
+               const unsigned char* C2,
+               size_t C2Length)
+{
+    StartVer(Header, HeaderLength, Keyf, C2, C2Length);
+    UpdateVer(Message, MessageLength);
+    return FinishVer();
+}
+
+void CtE1::StartVer(const unsigned char* Header,
+                    size_t HeaderLength,
+                    const string& Keyf,
+                    const unsigned char* C2,
+                    size_t C2Length)
 {
+    mStreamKey.assign(Keyf);
+    mStreamC2.assign((const char*)C2, C2Length);
     // Setup HMAC
     mHash->SetKey((const unsigned char*)Keyf.data(), Keyf.size());
     /* C2' <- HMAC(Keyf, H || M || Keyf) */
-    string C2New;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    mHash->Update((const unsigned char*)Keyf.data(), Keyf.size());
-    C2New.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2New.data());
+    mHash->Update(Header, HeaderLength);
+}
+
+void CtE1::UpdateVer(const unsigned char* Message,
+                     size_t MessageLength)
+{
+    mHash->Update(Message, MessageLength);
+}
+
+bool CtE1::FinishVer()
+{
+    mC2New.resize(mHash->DigestSize());
+    mHash->Update((const unsigned char*)mStreamKey.data(), mStreamKey.size());
+    mHash->Final((unsigned char*)&mC2New[0]);
     /* If C2 != C2' then Return 0 */
-    if (C2.compare(C2New))
+    if (mStreamC2 != mC2New)
     {
         return false;
     }
     return true;
 }
 
+ICEScheme* CtE1::Clone() const
+{
+    CtE1* Copy = new CtE1(SchemeFactory::CreateMAC(mHash),
+                          mAEAD->Clone());
+    Copy->mNonce = mNonce;
+    return Copy;
+}
+
 const string& CtE1::GetClassDecription()
 {
     return cClassDescription;
@@ -105,3 +159,21 @@ uint32_t CtE1::GetNonceSize()
 {
     return mAEAD->GetBlockSize();
 }
+
+size_t CtE1::GetCiphertextSize(size_t /* HeaderLength */,
+                               size_t MessageLength)
+{
+    // C1 is the AEAD cipher of M || Keyf, C2 is the associated data
+    return mAEAD->GetCiphertextSize(GetCommitmentSize(), MessageLength + mHash->DefaultKeyLength());
+}
+
+size_t CtE1::GetCommitmentSize()
+{
+    return mHash->DigestSize();
+}
+
+size_t CtE1::GetMaxPlaintextSize(size_t C1Length)
+{
+    // M || Keyf is decrypted into the output, Keyf is cut off afterwards
+    return mAEAD->GetMaxPlaintextSize(C1Length);
+}
@@ -1,97 +1,185 @@
 using namespace std;
 
 #include <cryptopp/cryptlib.h>
-#include <cryptopp/osrng.h>
 using namespace CryptoPP;
 
 #include "CtE2.h"
+#include "../SchemeFactory.h"
 
 void CtE2::Enc(const string& Key,
-               const string& Header,
-               const string& Message,
-               string& C1,
-               string& C2)
+               const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* Message,
+               size_t MessageLength,
+               unsigned char* C1,
+               size_t& C1Length,
+               unsigned char* C2,
+               size_t& C2Length)
 {
-    // (Kf, C2) <-$ Com(H || M), we do Com with HMAC
-    AutoSeededRandomPool Rnd;
-    SecByteBlock Keyf(0x00, mHash->DefaultKeyLength());
-    /* Kf <-$ {0, 1}^n */
-    Rnd.GenerateBlock(Keyf, Keyf.size());
-    // Setup HMAC
-    mHash->SetKey(Keyf, Keyf.size());
-    /* C2 <- HMAC(Keyf, H || M || Keyf) */
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    mHash->Update(Keyf.BytePtr(), Keyf.size());
-    C2.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2.data());
-    /* C1 <- Enc(Key, C2, M || Keyf), with AEAD scheme C1 = C || T */
-    mAEAD->StartEnc(Key, mNonce, Header, (const unsigned char*)Message.data(), Message.size());
-    mAEAD->UpdateEnc((const unsigned char*)Keyf.data(), Keyf.size());
-    mAEAD->FinishEnc(C1);
-    /* Return (C || T, C2), alread created before */
+    if (C1Length < GetCiphertextSize(HeaderLength, MessageLength) || C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CtE2");
+    }
+    // The whole message is one part
+    StartEnc(Key, Header, HeaderLength);
+    size_t CipherSize = C1Length;
+    UpdateEnc(Message, MessageLength, C1, CipherSize);
+    size_t RestSize = C1Length - CipherSize;
+    FinishEnc(C1 + CipherSize, RestSize, C2, C2Length);
+    C1Length = CipherSize + RestSize;
+    /* Return (C || T, C2) */
     return;
 }
 
 bool CtE2::Dec(const string& Key,
-               const string& Header,
-               const string& C1,
-               const string& C2,
-               string& Message,
+               const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* C1,
+               size_t C1Length,
+               const unsigned char* C2,
+               size_t C2Length,
+               unsigned char* Message,
+               size_t& MessageLength,
                string& Keyf)
 {
-    /* M || Keyf <- Dec(Key, C2, C1), with AEAD scheme */
-    bool Success = mAEAD->PDec(Key, mNonce, Header, (unsigned char*)C1.data(), C1.size(), Message);
+    /* M || Keyf <- Dec(Key, H, C1), with AEAD scheme */
+    size_t OutputLength = MessageLength;
+    bool Success = mAEAD->Dec(Key, mNonce, Header, HeaderLength, C1, C1Length, Message, OutputLength);
     /* If M = 0 then Return 0 */
-    if (!Success)
+    size_t KeyfSize = mHash->DefaultKeyLength();
+    if (!Success || OutputLength < KeyfSize)
     {
-        memset(Message.data(), 0x00, Message.size());
+        MessageLength = 0;
         return false;
     }
-    /* Setup HMAC with Keyf */
-    string KeyfString = (Message.substr(Message.size() - mHash->DefaultKeyLength()));
-    mHash->SetKey((const unsigned char*)KeyfString.data(), KeyfString.size());
+    /* Setup HMAC with Keyf, it is the end of the output */
+    const unsigned char* KeyfPointer = Message + OutputLength - KeyfSize;
+    mHash->SetKey(KeyfPointer, KeyfSize);
     /* b <- VerC(Keyf, C2, H || M), here with HMAC */
     /* HMAC(Keyf, M || Keyf) */
-    string C2New;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    C2New.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2New.data());
+    mC2New.resize(mHash->DigestSize());
+    mHash->Update(Header, HeaderLength);
+    mHash->Update(Message, OutputLength);
+    mHash->Final((unsigned char*)&mC2New[0]);
     /* If C2 != HMAC(Keyf, H || M || Keyf) then Return 0 */
-    if (C2.compare(C2New))
+    if (C2Length != mC2New.size() || memcmp(C2, mC2New.data(), mC2New.size()))
     {
-        memset(Message.data(), 0x00, Message.size());
+        memset(Message, 0x00, OutputLength);
+        MessageLength = 0;
         return false;
     }
     /* Return (M, Keyf) */
-    Message.resize(Message.size() - KeyfString.size());
-    Keyf.assign(KeyfString);
+    Keyf.assign((const char*)KeyfPointer, KeyfSize);
+    MessageLength = OutputLength - KeyfSize;
     return true;
 }
 
-bool CtE2::Ver(const string& Header,
-               const string& Message,
+bool CtE2::Ver(const unsigned char* Header,
+               size_t HeaderLength,
+               const unsigned char* Message,
+               size_t MessageLength,
                const string& Keyf,
-               const string& C2)
+               const unsigned char* C2,
+               size_t C2Length)
 {
+    StartVer(Header, HeaderLength, Keyf, C2, C2Length);
+    UpdateVer(Message, MessageLength);
+    return FinishVer();
+}
+
+void CtE2::StartVer(const unsigned char* Header,
+                    size_t HeaderLength,
+                    const string& Keyf,
+                    const unsigned char* C2,
+                    size_t C2Length)
+{
+    mStreamKey.assign(Keyf);
+    mStreamC2.assign((const char*)C2, C2Length);
     // Setup HMAC
     mHash->SetKey((const unsigned char*)Keyf.data(), Keyf.size());
     /* C2' <- HMAC(Keyf, H || M || Keyf) */
-    string C2New;
-    mHash->Update((const unsigned char*)Header.data(), Header.size());
-    mHash->Update((const unsigned char*)Message.data(), Message.size());
-    mHash->Update((const unsigned char*)Keyf.data(), Keyf.size());
-    C2New.resize(mHash->DigestSize());
-    mHash->Final((unsigned char*)C2New.data());
+    mHash->Update(Header, HeaderLength);
+}
+
+void CtE2::UpdateVer(const unsigned char* Message,
+                     size_t MessageLength)
+{
+    mHash->Update(Message, MessageLength);
+}
+
+bool CtE2::FinishVer()
+{
+    mC2New.resize(mHash->DigestSize());
+    mHash->Update((const unsigned char*)mStreamKey.data(), mStreamKey.size());
+    mHash->Final((unsigned char*)&mC2New[0]);
     /* If C2 != C2' then Return 0 */
-    if (C2.compare(C2New))
+    if (mStreamC2 != mC2New)
     {
         return false;
     }
     return true;
 }
 
+void CtE2::StartEnc(const string& Key,
+                    const unsigned char* Header,
+                    size_t HeaderLength)
+{
+    // (Kf, C2) <-$ Com(H || M), we do Com with HMAC
+    mKeyf.resize(mHash->DefaultKeyLength());
+    /* Kf <-$ {0, 1}^n */
+    GenerateRandom(mKeyf, mKeyf.size());
+    // Setup HMAC
+    mHash->SetKey(mKeyf, mKeyf.size());
+    /* C2 <- HMAC(Keyf, H || M || Keyf) */
+    mHash->Update(Header, HeaderLength);
+    /* C1 <- Enc(Key, H, M || Keyf), with AEAD scheme C1 = C || T */
+    mAEAD->StartEnc(Key, mNonce, Header, HeaderLength);
+}
+
+void CtE2::UpdateEnc(const unsigned char* Message,
+                     size_t MessageLength,
+                     unsigned char* C1,
+                     size_t& C1Length)
+{
+    // Hash before the encryption, C1 may be the message buffer
+    mHash->Update(Message, MessageLength);
+    mAEAD->UpdateEnc(Message, MessageLength, C1, C1Length);
+}
+
+void CtE2::FinishEnc(unsigned char* C1,
+                     size_t& C1Length,
+                     unsigned char* C2,
+                     size_t& C2Length)
+{
+    if (C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CtE2");
+    }
+    mHash->Update(mKeyf.BytePtr(), mKeyf.size());
+    mHash->Final(C2);
+    C2Length = mHash->DigestSize();
+    // Keyf is the last part of the AEAD message, followed by the tag
+    size_t KeyfCipherSize = C1Length;
+    mAEAD->UpdateEnc(mKeyf.BytePtr(), mKeyf.size(), C1, KeyfCipherSize);
+    size_t TagSize = C1Length - KeyfCipherSize;
+    mAEAD->FinishEnc(C1 + KeyfCipherSize, TagSize);
+    C1Length = KeyfCipherSize + TagSize;
+}
+
+size_t CtE2::GetStreamBlockSize()
+{
+    // The AEAD holds back at most one block
+    return mAEAD->GetBlockSize();
+}
+
+ICEScheme* CtE2::Clone() const
+{
+    CtE2* Copy = new CtE2(SchemeFactory::CreateMAC(mHash),
+                          mAEAD->Clone());
+    Copy->mNonce = mNonce;
+    return Copy;
+}
+
 const string& CtE2::GetClassDecription()
 {
     return cClassDescription;
@@ -106,3 +194,21 @@ uint32_t CtE2::GetNonceSize()
 {
     return mAEAD->GetBlockSize();
 }
+
+size_t CtE2::GetCiphertextSize(size_t HeaderLength,
+                               size_t MessageLength)
+{
+    // C1 is the AEAD cipher of M || Keyf, the header is the associated data
+    return mAEAD->GetCiphertextSize(HeaderLength, MessageLength + mHash->DefaultKeyLength());
+}
+
+size_t CtE2::GetCommitmentSize()
+{
+    return mHash->DigestSize();
+}
+
+size_t CtE2::GetMaxPlaintextSize(size_t C1Length)
+{
+    // M || Keyf is decrypted into the output, Keyf is cut off afterwards
+    return mAEAD->GetMaxPlaintextSize(C1Length);
+}
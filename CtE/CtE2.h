@@ -4,6 +4,7 @@
 #include <string>
 
 #include <cryptopp/cryptlib.h>
+#include <cryptopp/secblock.h>
 
 #include "../ICEScheme.h" 
 #include "../AEAD/IAEADScheme.h" 
@@ -24,28 +25,70 @@ public:
         delete mAEAD;
     }
 
+    using ICEScheme::Enc;
+    using ICEScheme::Dec;
+    using ICEScheme::Ver;
     void Enc(const std::string& Key,
-             const std::string& Header,
-             const std::string& Message,
-             std::string& C1,
-             std::string& C2);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
+             unsigned char* C1,
+             size_t& C1Length,
+             unsigned char* C2,
+             size_t& C2Length);
     bool Dec(const std::string& Key,
-             const std::string& Header,
-             const std::string& C1,
-             const std::string& C2,
-             std::string& Message,
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* C1,
+             size_t C1Length,
+             const unsigned char* C2,
+             size_t C2Length,
+             unsigned char* Message,
+             size_t& MessageLength,
              std::string& Keyf);
-    bool Ver(const std::string& Header,
-             const std::string& Message,
+    bool Ver(const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
              const std::string& Keyf,
-             const std::string& C2);
+             const unsigned char* C2,
+             size_t C2Length);
+    void StartEnc(const std::string& Key,
+                  const unsigned char* Header,
+                  size_t HeaderLength);
+    void UpdateEnc(const unsigned char* Message,
+                   size_t MessageLength,
+                   unsigned char* C1,
+                   size_t& C1Length);
+    void FinishEnc(unsigned char* C1,
+                   size_t& C1Length,
+                   unsigned char* C2,
+                   size_t& C2Length);
+    void StartVer(const unsigned char* Header,
+                  size_t HeaderLength,
+                  const std::string& Keyf,
+                  const unsigned char* C2,
+                  size_t C2Length);
+    void UpdateVer(const unsigned char* Message,
+                   size_t MessageLength);
+    bool FinishVer();
+    size_t GetStreamBlockSize();
+    ICEScheme* Clone() const;
     const std::string& GetClassDecription();
     uint32_t GetKeySize();
     uint32_t GetNonceSize();
+    size_t GetCiphertextSize(size_t HeaderLength,
+                             size_t MessageLength);
+    size_t GetCommitmentSize();
+    size_t GetMaxPlaintextSize(size_t C1Length);
 
 private:
     CryptoPP::MessageAuthenticationCode* mHash;
     IAEADScheme* mAEAD;
+    // Keyf of the incremental encryption and the recomputed C2
+    CryptoPP::SecByteBlock mKeyf;
+    std::string mC2New;
     const std::string cClassDescription;
 };
 #endif
@@ -3,40 +3,21 @@
 
 #include <string>
 
-#include <cryptopp/sha.h>
+#include "SHA256_HFC.h"
 
-#include "IHFCScheme.h" 
-
-class AltPad_SHA256_HFC : public IHFCScheme
+/// \brief Compression of the HFC of SHA256 with the header in the part of
+/// the message blocks after the message, only the rest of the header gets
+/// own blocks
+struct AltPadSHA256Compression : public SHA256Compression
 {
-public:
-    void EC(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* Message, 
-            uint32_t MessageSize, 
-            std::string& CEC,
-            std::string& BEC);
-    bool DO(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* CEC, 
-            uint32_t CECSize, 
-            const std::string& BEC,
-            std::string& Message);
-    bool EVer(const std::string& Header,
-              const std::string& Message,
-              const std::string& KEC,
-              const std::string& BEC);
-    const std::string& GetClassDecription();
-    uint32_t GetBlockSize();
-    uint32_t GetStateSize();
-
-protected:
-    const std::string mIV = std::string(GetStateSize(), '0');
+    static const bool cHeaderInMessage = true;
+    static std::string Name()
+    {
+        return "AltPad_" + SHA256Compression::Name();
+    }
+};
 
-private:
-    const std::string cClassDescription = std::string("HFC[") +
-                                          "AltPad_" + CryptoPP::SHA256::StaticAlgorithmName() +
-                                          "]";
+extern template class HFC<AltPadSHA256Compression, 64, 32, CryptoPP::word32>;
 
-};
+typedef HFC<AltPadSHA256Compression, 64, 32, CryptoPP::word32> AltPad_SHA256_HFC;
 #endif
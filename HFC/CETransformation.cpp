@@ -1,78 +1,104 @@
 using namespace std;
 
 #include <cryptopp/cryptlib.h>
-#include <cryptopp/filters.h>
-#include <cryptopp/osrng.h>
 using namespace CryptoPP;
 
 #include "CETransformation.h"
 
 void CETransformation::Enc(const string& Key,
-                           const string& Header,
-                           const string& Message,
-                           string& C1,
-                           string& C2)
+                           const unsigned char* Header,
+                           size_t HeaderLength,
+                           const unsigned char* Message,
+                           size_t MessageLength,
+                           unsigned char* C1,
+                           size_t& C1Length,
+                           unsigned char* C2,
+                           size_t& C2Length)
 {
+    if (C1Length < GetCiphertextSize(HeaderLength, MessageLength) || C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CETransformation");
+    }
     /* Kf <-$ {0, 1}^n */
-    string Keyf = mEC->EKg();
-    // (CEC, BEC) <- EC(KEC, H, M)
-    mEC->EC(Keyf, Header, (unsigned char*)Message.data(), Message.size(), C1, C2);
+    mKeyf.resize(mEC->GetBlockSize());
+    GenerateRandom((unsigned char*)&mKeyf[0], mKeyf.size());
+    // (CEC, BEC) <- EC(KEC, H, M), CEC is written to the start of C1
+    mEC->EC(mKeyf, Header, HeaderLength, Message, MessageLength, C1, mBEC);
+    memcpy(C2, mBEC.data(), mBEC.size());
+    C2Length = mBEC.size();
     /* C_AE <- AEAD.Enc(K, C2, Keyf) */
-    string C;
-    mAEAD->Enc(Key, mNonce, C2, Keyf, C);
+    // C_AE is written directly behind CEC
+    size_t CAELength = C1Length - MessageLength;
+    mAEAD->Enc(Key, mNonce, C2, C2Length, (const unsigned char*)mKeyf.data(), mKeyf.size(),
+               C1 + MessageLength, CAELength);
     /* Return (CEC || C_AE, BEC) */
-    C1.append(C);
+    C1Length = MessageLength + CAELength;
     return;
 }
 
 bool CETransformation::Dec(const string& Key,
-                           const string& Header,
-                           const string& C1, 
-                           const string& C2,
-                           string& Message,
+                           const unsigned char* Header,
+                           size_t HeaderLength,
+                           const unsigned char* C1, 
+                           size_t C1Length,
+                           const unsigned char* C2,
+                           size_t C2Length,
+                           unsigned char* Message,
+                           size_t& MessageLength,
                            string& Keyf)
 {
-    // Get size of cipher with keyf (block size of encryptment scheme) plus padding
-    // From the cryptopp library (m_cipher is the encryption used in the aead scheme):
-    // bool IsBlockCipher = (m_cipher.MandatoryBlockSize() > 1 && m_cipher.MinLastBlockSize() == 0);
-    // Padding = IsBlockCipher ? PKCS_PADDING : NO_PADDING;
-    uint32_t KeyfCipherSize = mEC->GetBlockSize();
-    if (mAEAD->IsBlockCipher())
+    // C1 = CEC || C_AE and C_AE = Keyf || padding || AEAD.tag
+    size_t KeyfCipherSize = mAEAD->GetCiphertextSize(0, mEC->GetBlockSize());
+    if (C1Length < KeyfCipherSize)
+    {
+        MessageLength = 0;
+        return false;
+    }
+    size_t CECSize = C1Length - KeyfCipherSize;
+    if (MessageLength < GetMaxPlaintextSize(C1Length))
     {
-        KeyfCipherSize += (mAEAD->GetBlockSize() - (KeyfCipherSize % mAEAD->GetBlockSize()));
+        throw runtime_error("Output buffer too small for the message");
     }
-    // C1 = CEC || C_AE and C_AE = Keyf || padding || AEAD.tag
-    uint32_t CECSize = C1.size() - KeyfCipherSize - mAEAD->GetTagSize();
     /* Keyf <- AEAD.Dec(K, C2, C_AE) */
-    string RKeyf;
-    bool Success = mAEAD->PDec(Key, mNonce, C2, (const unsigned char*)(C1.data() + CECSize), C1.size() - CECSize, RKeyf);
+    mKeyf.resize(mAEAD->GetMaxPlaintextSize(KeyfCipherSize));
+    size_t KeyfLength = mKeyf.size();
+    bool Success = mAEAD->Dec(Key, mNonce, C2, C2Length, C1 + CECSize, KeyfCipherSize,
+                              (unsigned char*)&mKeyf[0], KeyfLength);
     /* If KEC = 0 then Return 0 */
     if (!Success)
     {
+        MessageLength = 0;
         return false;
     }
+    mKeyf.resize(KeyfLength);
     // Here we use a pointer to the CEC to avoid splitting the large ciphertext
-    // and do not need to create a new large string
+    // and the message is written directly to the output
     /* M <- DO(KEC, H, CEC, BEC) */
-    Success = mEC->DO(RKeyf, Header, (const unsigned char*)C1.data(), CECSize, C2, Message);
-    /* If M = 0 then Return 0 */
+    mBEC.assign((const char*)C2, C2Length);
+    Success = mEC->DO(mKeyf, Header, HeaderLength, C1, CECSize, mBEC, Message);
+    /* If M = 0 then Return 0, DO already cleared M */
     if (!Success)
     {
-        memset(Message.data(), 0x00, Message.size());
+        MessageLength = 0;
         return false;
     }
     /* Return (M, KEC), M already assigned */
-    Keyf.assign(RKeyf);
+    MessageLength = CECSize;
+    Keyf.assign(mKeyf);
     return true;
 }
 
-bool CETransformation::Ver(const string& Header,
-                           const string& Message,
+bool CETransformation::Ver(const unsigned char* Header,
+                           size_t HeaderLength,
+                           const unsigned char* Message,
+                           size_t MessageLength,
                            const string& Keyf,
-                           const string& C2)
+                           const unsigned char* C2,
+                           size_t C2Length)
 {
     // b <- EVer(H, M, KEC, BEC)
-    bool Success = mEC->EVer(Header, Message, Keyf, C2);
+    mBEC.assign((const char*)C2, C2Length);
+    bool Success = mEC->EVer(Header, HeaderLength, Message, MessageLength, Keyf, mBEC);
     if (!Success)
     {
         return false;
@@ -80,6 +106,340 @@ bool CETransformation::Ver(const string& Header,
     return true;
 }
 
+bool CETransformation::HasBatch()
+{
+    // EC, DO and EVer of a batch run in the batch functions of the HFC
+    return true;
+}
+
+void CETransformation::EncBatch(const string& Key,
+                                size_t Count,
+                                const unsigned char* const* Headers,
+                                const size_t* HeaderLengths,
+                                const unsigned char* const* Messages,
+                                const size_t* MessageLengths,
+                                unsigned char* C1,
+                                size_t& C1Length,
+                                size_t* C1Lengths,
+                                unsigned char* C2)
+{
+    size_t Written = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        C1Lengths[i] = GetCiphertextSize(HeaderLengths[i], MessageLengths[i]);
+        Written += C1Lengths[i];
+    }
+    if (C1Length < Written)
+    {
+        throw runtime_error("Output buffer too small for CETransformation");
+    }
+    ResizeBatch(Count);
+    Written = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        /* Kf <-$ {0, 1}^n */
+        mBatchKeyfs[i].resize(mEC->GetBlockSize());
+        GenerateRandom((unsigned char*)&mBatchKeyfs[i][0], mBatchKeyfs[i].size());
+        mBatchOutputs[i] = C1 + Written;
+        Written += C1Lengths[i];
+    }
+    // (CEC, BEC) <- EC(KEC, H, M) of every message in one batch,
+    // every CEC is written to the start of its C1
+    mEC->ECBatch(Count, mBatchKeyfs.data(), Headers, HeaderLengths, Messages, MessageLengths,
+                 mBatchOutputs.data(), mBatchBECs.data());
+    // Message i uses the nonce increased i times, the nonce stays behind the last one
+    for (size_t i = 0; i < Count; i++)
+    {
+        unsigned char* Commitment = C2 + i * GetCommitmentSize();
+        memcpy(Commitment, mBatchBECs[i].data(), mBatchBECs[i].size());
+        /* C_AE <- AEAD.Enc(K, C2, Keyf) */
+        // C_AE is written directly behind CEC
+        size_t CAELength = C1Lengths[i] - MessageLengths[i];
+        try
+        {
+            mAEAD->Enc(Key, mNonce, Commitment, mBatchBECs[i].size(),
+                       (const unsigned char*)mBatchKeyfs[i].data(), mBatchKeyfs[i].size(),
+                       mBatchOutputs[i] + MessageLengths[i], CAELength);
+        }
+        catch (...)
+        {
+            IncreaseNonce();
+            throw;
+        }
+        IncreaseNonce();
+    }
+    /* Return (CEC || C_AE, BEC) of every message */
+    C1Length = Written;
+}
+
+size_t CETransformation::DecBatch(const string& Key,
+                                  size_t Count,
+                                  const unsigned char* const* Headers,
+                                  const size_t* HeaderLengths,
+                                  const unsigned char* C1,
+                                  const size_t* C1Lengths,
+                                  const unsigned char* C2,
+                                  unsigned char* Message,
+                                  size_t& MessageLength,
+                                  size_t* MessageLengths,
+                                  string* Keyfs,
+                                  bool* Valid)
+{
+    // C1 = CEC || C_AE and C_AE = Keyf || padding || AEAD.tag
+    size_t KeyfCipherSize = mAEAD->GetCiphertextSize(0, mEC->GetBlockSize());
+    size_t Written = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        Written += GetMaxPlaintextSize(C1Lengths[i]);
+    }
+    if (MessageLength < Written)
+    {
+        throw runtime_error("Output buffer too small for the message");
+    }
+    ResizeBatch(Count);
+    // Every cipher with a valid C_AE gets a job for the batch of DO
+    size_t Jobs = 0;
+    size_t Read = 0;
+    Written = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        const unsigned char* Commitment = C2 + i * GetCommitmentSize();
+        const unsigned char* Cipher = C1 + Read;
+        Read += C1Lengths[i];
+        Valid[i] = false;
+        MessageLengths[i] = 0;
+        if (C1Lengths[i] >= KeyfCipherSize)
+        {
+            size_t CECSize = C1Lengths[i] - KeyfCipherSize;
+            /* Keyf <- AEAD.Dec(K, C2, C_AE) */
+            string& Keyf = mBatchKeyfs[Jobs];
+            Keyf.resize(mAEAD->GetMaxPlaintextSize(KeyfCipherSize));
+            size_t KeyfLength = Keyf.size();
+            /* If KEC = 0 then Return 0 */
+            Valid[i] = mAEAD->Dec(Key, mNonce, Commitment, GetCommitmentSize(), Cipher + CECSize, KeyfCipherSize,
+                                  (unsigned char*)&Keyf[0], KeyfLength);
+            if (Valid[i])
+            {
+                Keyf.resize(KeyfLength);
+                mBatchBECs[Jobs].assign((const char*)Commitment, GetCommitmentSize());
+                mBatchHeaders[Jobs] = Headers[i];
+                mBatchHeaderLengths[Jobs] = HeaderLengths[i];
+                mBatchInputs[Jobs] = Cipher;
+                mBatchInputLengths[Jobs] = CECSize;
+                mBatchOutputs[Jobs] = Message + Written;
+                MessageLengths[i] = CECSize;
+                Written += CECSize;
+                Jobs++;
+            }
+        }
+        IncreaseNonce();
+    }
+    /* M <- DO(KEC, H, CEC, BEC) of every job in one batch */
+    mEC->DOBatch(Jobs, mBatchKeyfs.data(), mBatchHeaders.data(), mBatchHeaderLengths.data(),
+                 mBatchInputs.data(), mBatchInputLengths.data(), mBatchBECs.data(),
+                 mBatchOutputs.data(), mBatchValid.get());
+    // The messages of invalid ciphers are dropped, the others stay behind each other
+    size_t ValidCount = 0;
+    size_t Job = 0;
+    Written = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        if (!Valid[i])
+        {
+            continue;
+        }
+        /* If M = 0 then Return 0, DO already cleared M */
+        Valid[i] = mBatchValid[Job];
+        if (Valid[i])
+        {
+            if (mBatchOutputs[Job] != Message + Written)
+            {
+                memmove(Message + Written, mBatchOutputs[Job], MessageLengths[i]);
+            }
+            /* Return (M, KEC), M already assigned */
+            Keyfs[i].assign(mBatchKeyfs[Job]);
+            Written += MessageLengths[i];
+            ValidCount++;
+        }
+        else
+        {
+            MessageLengths[i] = 0;
+        }
+        Job++;
+    }
+    MessageLength = Written;
+    return ValidCount;
+}
+
+size_t CETransformation::VerBatch(size_t Count,
+                                  const unsigned char* const* Headers,
+                                  const size_t* HeaderLengths,
+                                  const unsigned char* const* Messages,
+                                  const size_t* MessageLengths,
+                                  const string* Keyfs,
+                                  const unsigned char* C2,
+                                  bool* Valid)
+{
+    ResizeBatch(Count);
+    for (size_t i = 0; i < Count; i++)
+    {
+        mBatchBECs[i].assign((const char*)C2 + i * GetCommitmentSize(), GetCommitmentSize());
+    }
+    // b <- EVer(H, M, KEC, BEC) of every message in one batch
+    return mEC->EVerBatch(Count, Headers, HeaderLengths, Messages, MessageLengths,
+                          Keyfs, mBatchBECs.data(), Valid);
+}
+
+void CETransformation::StartEnc(const string& Key,
+                                const unsigned char* Header,
+                                size_t HeaderLength)
+{
+    // The key is needed for C_AE at the end
+    mStreamKey.assign(Key);
+    /* Kf <-$ {0, 1}^n */
+    mKeyf.resize(mEC->GetBlockSize());
+    GenerateRandom((unsigned char*)&mKeyf[0], mKeyf.size());
+    // (CEC, BEC) <- EC(KEC, H, M), the chain is sequential over the message
+    mEC->StartChain(IHFCScheme::ChainEC, mKeyf, Header, HeaderLength);
+}
+
+void CETransformation::UpdateEnc(const unsigned char* Message,
+                                 size_t MessageLength,
+                                 unsigned char* C1,
+                                 size_t& C1Length)
+{
+    mEC->UpdateChain(Message, MessageLength, C1, C1Length);
+}
+
+void CETransformation::FinishEnc(unsigned char* C1,
+                                 size_t& C1Length,
+                                 unsigned char* C2,
+                                 size_t& C2Length)
+{
+    if (C2Length < GetCommitmentSize())
+    {
+        throw runtime_error("Output buffer too small for CETransformation");
+    }
+    // The rest of CEC is written to the start of C1
+    size_t CECSize = C1Length;
+    mEC->FinishChain(C1, CECSize, mBEC);
+    memcpy(C2, mBEC.data(), mBEC.size());
+    C2Length = mBEC.size();
+    /* C_AE <- AEAD.Enc(K, C2, Keyf) */
+    // C_AE is written directly behind CEC
+    size_t CAELength = C1Length - CECSize;
+    mAEAD->Enc(mStreamKey, mNonce, C2, C2Length, (const unsigned char*)mKeyf.data(), mKeyf.size(),
+               C1 + CECSize, CAELength);
+    /* Return (CEC || C_AE, BEC) */
+    C1Length = CECSize + CAELength;
+}
+
+void CETransformation::StartDec(const string& Key,
+                                const unsigned char* Header,
+                                size_t HeaderLength,
+                                const unsigned char* C2,
+                                size_t C2Length,
+                                const unsigned char* Trailer,
+                                size_t TrailerLength)
+{
+    // C1 = CEC || C_AE, C_AE is the trailer and is needed for the chain key
+    if (TrailerLength != GetTrailerSize())
+    {
+        throw runtime_error("Wrong trailer length for CETransformation");
+    }
+    mStreamC2.assign((const char*)C2, C2Length);
+    /* Keyf <- AEAD.Dec(K, C2, C_AE) */
+    mKeyf.resize(mAEAD->GetMaxPlaintextSize(TrailerLength));
+    size_t KeyfLength = mKeyf.size();
+    mStreamFailed = !mAEAD->Dec(Key, mNonce, C2, C2Length, Trailer, TrailerLength,
+                                (unsigned char*)&mKeyf[0], KeyfLength);
+    /* If KEC = 0 then Return 0, in FinishDec */
+    if (mStreamFailed)
+    {
+        return;
+    }
+    mKeyf.resize(KeyfLength);
+    /* M <- DO(KEC, H, CEC, BEC) */
+    mEC->StartChain(IHFCScheme::ChainDO, mKeyf, Header, HeaderLength);
+}
+
+void CETransformation::UpdateDec(const unsigned char* C1,
+                                 size_t C1Length,
+                                 unsigned char* Message,
+                                 size_t& MessageLength)
+{
+    if (mStreamFailed)
+    {
+        MessageLength = 0;
+        return;
+    }
+    mEC->UpdateChain(C1, C1Length, Message, MessageLength);
+}
+
+bool CETransformation::FinishDec(unsigned char* Message,
+                                 size_t& MessageLength,
+                                 string& Keyf)
+{
+    if (mStreamFailed)
+    {
+        MessageLength = 0;
+        return false;
+    }
+    /* If M = 0 then Return 0 */
+    if (!mEC->FinishChain(Message, MessageLength, mStreamC2))
+    {
+        return false;
+    }
+    /* Return (M, KEC), M already written */
+    Keyf.assign(mKeyf);
+    return true;
+}
+
+void CETransformation::StartVer(const unsigned char* Header,
+                                size_t HeaderLength,
+                                const string& Keyf,
+                                const unsigned char* C2,
+                                size_t C2Length)
+{
+    mStreamC2.assign((const char*)C2, C2Length);
+    // b <- EVer(H, M, KEC, BEC)
+    mEC->StartChain(IHFCScheme::ChainEVer, Keyf, Header, HeaderLength);
+}
+
+void CETransformation::UpdateVer(const unsigned char* Message,
+                                 size_t MessageLength)
+{
+    // EVer has no output
+    size_t OutputLength = 0;
+    mEC->UpdateChain(Message, MessageLength, NULL, OutputLength);
+}
+
+bool CETransformation::FinishVer()
+{
+    size_t OutputLength = 0;
+    return mEC->FinishChain(NULL, OutputLength, mStreamC2);
+}
+
+size_t CETransformation::GetTrailerSize()
+{
+    // C_AE is the AEAD cipher of Keyf
+    return mAEAD->GetCiphertextSize(0, mEC->GetBlockSize());
+}
+
+size_t CETransformation::GetStreamBlockSize()
+{
+    // The chain holds back the last state block
+    return mEC->GetStateSize();
+}
+
+ICEScheme* CETransformation::Clone() const
+{
+    CETransformation* Copy = new CETransformation(mEC->Clone(),
+                                                  mAEAD->Clone());
+    Copy->mNonce = mNonce;
+    return Copy;
+}
+
 const string& CETransformation::GetClassDecription()
 {
     return cClassDescription;
@@ -94,3 +454,41 @@ uint32_t CETransformation::GetNonceSize()
 {
     return mAEAD->GetBlockSize();
 }
+
+size_t CETransformation::GetCiphertextSize(size_t HeaderLength,
+                                           size_t MessageLength)
+{
+    // C1 = CEC || C_AE with C_AE the AEAD cipher of Keyf
+    return mEC->GetCiphertextSize(HeaderLength, MessageLength) +
+           mAEAD->GetCiphertextSize(0, mEC->GetBlockSize());
+}
+
+size_t CETransformation::GetCommitmentSize()
+{
+    return mEC->GetCommitmentSize();
+}
+
+size_t CETransformation::GetMaxPlaintextSize(size_t C1Length)
+{
+    size_t KeyfCipherSize = mAEAD->GetCiphertextSize(0, mEC->GetBlockSize());
+    return C1Length < KeyfCipherSize ? 0 : C1Length - KeyfCipherSize;
+}
+
+void CETransformation::ResizeBatch(size_t Count)
+{
+    if (mBatchKeyfs.size() < Count)
+    {
+        mBatchKeyfs.resize(Count);
+        mBatchBECs.resize(Count);
+        mBatchHeaders.resize(Count);
+        mBatchHeaderLengths.resize(Count);
+        mBatchInputs.resize(Count);
+        mBatchInputLengths.resize(Count);
+        mBatchOutputs.resize(Count);
+    }
+    if (mBatchValidSize < Count)
+    {
+        mBatchValid.reset(new bool[Count]);
+        mBatchValidSize = Count;
+    }
+}
@@ -2,6 +2,8 @@
 #define CETRANSFORMATION_H
 
 #include <string>
+#include <vector>
+#include <memory>
 
 #include "../ICEScheme.h" 
 #include "../AEAD/IAEADScheme.h" 
@@ -23,28 +25,132 @@ public:
         delete mAEAD;
     }
 
+    using ICEScheme::Enc;
+    using ICEScheme::Dec;
+    using ICEScheme::Ver;
     void Enc(const std::string& Key,
-             const std::string& Header,
-             const std::string& Message,
-             std::string& C1,
-             std::string& C2);
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
+             unsigned char* C1,
+             size_t& C1Length,
+             unsigned char* C2,
+             size_t& C2Length);
     bool Dec(const std::string& Key,
-             const std::string& Header,
-             const std::string& C1, 
-             const std::string& C2,
-             std::string& Message,
+             const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* C1,
+             size_t C1Length,
+             const unsigned char* C2,
+             size_t C2Length,
+             unsigned char* Message,
+             size_t& MessageLength,
              std::string& Keyf);
-    bool Ver(const std::string& Header,
-             const std::string& Message,
+    bool Ver(const unsigned char* Header,
+             size_t HeaderLength,
+             const unsigned char* Message,
+             size_t MessageLength,
              const std::string& Keyf,
-             const std::string& C2);
+             const unsigned char* C2,
+             size_t C2Length);
+    bool HasBatch();
+    void EncBatch(const std::string& Key,
+                  size_t Count,
+                  const unsigned char* const* Headers,
+                  const size_t* HeaderLengths,
+                  const unsigned char* const* Messages,
+                  const size_t* MessageLengths,
+                  unsigned char* C1,
+                  size_t& C1Length,
+                  size_t* C1Lengths,
+                  unsigned char* C2);
+    size_t DecBatch(const std::string& Key,
+                    size_t Count,
+                    const unsigned char* const* Headers,
+                    const size_t* HeaderLengths,
+                    const unsigned char* C1,
+                    const size_t* C1Lengths,
+                    const unsigned char* C2,
+                    unsigned char* Message,
+                    size_t& MessageLength,
+                    size_t* MessageLengths,
+                    std::string* Keyfs,
+                    bool* Valid);
+    size_t VerBatch(size_t Count,
+                    const unsigned char* const* Headers,
+                    const size_t* HeaderLengths,
+                    const unsigned char* const* Messages,
+                    const size_t* MessageLengths,
+                    const std::string* Keyfs,
+                    const unsigned char* C2,
+                    bool* Valid);
+    void StartEnc(const std::string& Key,
+                  const unsigned char* Header,
+                  size_t HeaderLength);
+    void UpdateEnc(const unsigned char* Message,
+                   size_t MessageLength,
+                   unsigned char* C1,
+                   size_t& C1Length);
+    void FinishEnc(unsigned char* C1,
+                   size_t& C1Length,
+                   unsigned char* C2,
+                   size_t& C2Length);
+    void StartDec(const std::string& Key,
+                  const unsigned char* Header,
+                  size_t HeaderLength,
+                  const unsigned char* C2,
+                  size_t C2Length,
+                  const unsigned char* Trailer,
+                  size_t TrailerLength);
+    void UpdateDec(const unsigned char* C1,
+                   size_t C1Length,
+                   unsigned char* Message,
+                   size_t& MessageLength);
+    bool FinishDec(unsigned char* Message,
+                   size_t& MessageLength,
+                   std::string& Keyf);
+    void StartVer(const unsigned char* Header,
+                  size_t HeaderLength,
+                  const std::string& Keyf,
+                  const unsigned char* C2,
+                  size_t C2Length);
+    void UpdateVer(const unsigned char* Message,
+                   size_t MessageLength);
+    bool FinishVer();
+    size_t GetTrailerSize();
+    size_t GetStreamBlockSize();
+    ICEScheme* Clone() const;
     const std::string& GetClassDecription();
     uint32_t GetKeySize();
     uint32_t GetNonceSize();
+    size_t GetCiphertextSize(size_t HeaderLength,
+                             size_t MessageLength);
+    size_t GetCommitmentSize();
+    size_t GetMaxPlaintextSize(size_t C1Length);
 
 private:
+	/// \brief Grows the buffers of the batch functions
+	/// \param Count number of messages of the batch
+    void ResizeBatch(size_t Count);
+
     IHFCScheme* mEC;
     IAEADScheme* mAEAD;
+    // Keyf and BEC, kept to avoid allocations per message,
+    // and if C_AE of the incremental decryption was invalid
+    std::string mKeyf;
+    std::string mBEC;
+    bool mStreamFailed = false;
+    // Keyfs, commitments and pointers of the batch functions
+    std::vector<std::string> mBatchKeyfs;
+    std::vector<std::string> mBatchBECs;
+    std::vector<const unsigned char*> mBatchHeaders;
+    std::vector<size_t> mBatchHeaderLengths;
+    std::vector<const unsigned char*> mBatchInputs;
+    std::vector<size_t> mBatchInputLengths;
+    std::vector<unsigned char*> mBatchOutputs;
+    std::unique_ptr<bool[]> mBatchValid;
+    size_t mBatchValidSize = 0;
     const std::string cClassDescription;
 
 };
@@ -0,0 +1,702 @@
+#ifndef HFC_H
+#define HFC_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+#include <cryptopp/misc.h>
+
+#include "IHFCScheme.h"
+
+/// \brief Defaults of the compression traits of the HFC template
+/// \details A traits struct derives from HFCCompression and has the name of the
+/// hash and Compress, the compression function f(V, block) on a full block. The
+/// flags and Chain are only declared again where a HFC differs from the default
+struct HFCCompression
+{
+    // The blocks are xored into the state (sponge), the message part of a block
+    // is the whole block and the header and message blocks are not xored with K_EC
+    static const bool cSponge = false;
+    // The first message blocks carry the header in the part after the message (AltPad)
+    static const bool cHeaderInMessage = false;
+    /// \brief Chains full message blocks with a faster kernel, returns the chained blocks
+	/// \param State the state of the chain
+	/// \param Key pointer to K_EC
+	/// \param Input pointer to the message (EC, EVer) or to CEC (DO)
+	/// \param Output outputs CEC (EC) or the message (DO), not used by EVer
+	/// \param Blocks number of blocks
+	/// \param Mode function of the chain
+    template <class Word>
+    static uint64_t Chain(Word* /* State */,
+                          const uint8_t* /* Key */,
+                          const uint8_t* /* Input */,
+                          uint8_t* /* Output */,
+                          uint64_t /* Blocks */,
+                          IHFCScheme::ChainMode /* Mode */)
+    {
+        return 0;
+    }
+};
+
+/// \brief HFC class, the HFC of a compression function with the sizes known at compile time
+/// \details EC, DO, EVer and the incremental chain run the same chain:
+/// V0 = f(IV, K_EC), the header blocks K_EC xor H_i, the message blocks
+/// (K_EC xor M_i') and the two suffix blocks with the last message block and
+/// the sizes of the header and the message. A message block is StateSize bytes
+/// of the message followed by the rest of K_EC (BlockSize bytes of the message
+/// for a sponge). The sizes are template parameters, so all buffers have a fixed
+/// size and the xor of the key and the padding have constant lengths. A new HFC
+/// is a traits struct (see HFCCompression) and a typedef of the template.
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+class HFC : public IHFCScheme
+{
+public:
+    using IHFCScheme::EC;
+    using IHFCScheme::DO;
+    using IHFCScheme::EVer;
+    void EC(const std::string& KEC,
+            const unsigned char* Header,
+            uint64_t HeaderSize,
+            const unsigned char* Message,
+            uint64_t MessageSize,
+            unsigned char* CEC,
+            std::string& BEC);
+    bool DO(const std::string& KEC,
+            const unsigned char* Header,
+            uint64_t HeaderSize,
+            const unsigned char* CEC,
+            uint64_t CECSize,
+            const std::string& BEC,
+            unsigned char* Message);
+    bool EVer(const unsigned char* Header,
+              uint64_t HeaderSize,
+              const unsigned char* Message,
+              uint64_t MessageSize,
+              const std::string& KEC,
+              const std::string& BEC);
+    void StartChain(ChainMode Mode,
+                    const std::string& KEC,
+                    const unsigned char* Header,
+                    uint64_t HeaderSize);
+    void UpdateChain(const unsigned char* Input,
+                     size_t InputSize,
+                     unsigned char* Output,
+                     size_t& OutputSize);
+    bool FinishChain(unsigned char* Output,
+                     size_t& OutputSize,
+                     std::string& BEC);
+    IHFCScheme* Clone() const;
+    const std::string& GetClassDecription();
+    uint32_t GetBlockSize();
+    uint32_t GetStateSize();
+    size_t GetCommitmentSize();
+
+    static constexpr uint32_t cStateUnits = StateSize / sizeof(Word);
+    // Bytes of the message in a block
+    static constexpr uint32_t cChunkSize = Compression::cSponge ? BlockSize : StateSize;
+    // Bytes of the header in a message block (AltPad)
+    static constexpr uint32_t cPadSize = BlockSize - StateSize;
+    // Both suffix blocks start with K_EC xor PadSuf, for a block cipher based
+    // hash only BlockSize / sizeof(Word) bytes of them as in the first HFCs
+    static constexpr uint32_t cSuffixKeySize = Compression::cSponge ? BlockSize : BlockSize / sizeof(Word);
+
+    //======================================================//
+    // The blocks of the chain. The functions below compress them one after
+    // the other, the multi-buffer engines (MultiBuffer_HFC.cpp) compress the
+    // blocks of independent chains together
+
+    /// \brief Builds a header block, K_EC xor H_i (H_i for a sponge)
+	/// \param Key pointer to K_EC
+	/// \param Header pointer to the header block
+	/// \param Size size of the header block, up to BlockSize
+	/// \param Block outputs the block, the last header block is padded with K_EC (zeros)
+    static void HeaderBlock(const uint8_t* Key,
+                            const uint8_t* Header,
+                            uint64_t Size,
+                            uint8_t* Block);
+    /// \brief Sets the part of a message block after the message to K_EC
+	/// \param Key pointer to K_EC
+	/// \param Block the block, only the part after cChunkSize bytes is set
+    static void MessageKeyBlock(const uint8_t* Key,
+                                uint8_t* Block);
+    /// \brief Builds a full message block, it is not the last block of the message
+	/// \param State the state of the chain before the block
+	/// \param Key pointer to K_EC
+	/// \param Input pointer to the block of the message (EC, EVer) or of CEC (DO)
+	/// \param Output outputs the block of CEC (EC) or of the message (DO), not used by EVer
+	/// \param Block outputs the block for f, the part after the message is already set
+    template <ChainMode Mode>
+    static void MessageBlock(const Word* State,
+                             const uint8_t* Key,
+                             const uint8_t* Input,
+                             uint8_t* Output,
+                             uint8_t* Block);
+    /// \brief Builds the two suffix blocks with the last block of the message
+	/// \param State the state of the chain before the suffix
+	/// \param Key pointer to K_EC
+	/// \param HeaderSize size of the header
+	/// \param MessageSize size of the message
+	/// \param Input pointer to the last block of the message (EC, EVer) or of CEC (DO)
+	/// \param Output outputs the last block of CEC (EC) or of the message (DO), not used by EVer
+	/// \param Length size of the last block, 0 to cChunkSize
+	/// \param Blocks outputs the 2 * BlockSize bytes of the suffix blocks
+    template <ChainMode Mode>
+    static void SuffixBlocks(const Word* State,
+                             const uint8_t* Key,
+                             uint64_t HeaderSize,
+                             uint64_t MessageSize,
+                             const uint8_t* Input,
+                             uint8_t* Output,
+                             uint64_t Length,
+                             uint8_t* Blocks);
+    /// \brief Returns the commitment of the state after the suffix
+	/// \param State the state of the chain
+    static std::string Commitment(const Word* State)
+    {
+        // BEC has one byte per state word
+        return std::string(State, State + cStateUnits);
+    }
+
+protected:
+    /// \brief Checks the input of EC, DO and EVer, the batch functions check every job with it
+	/// \param Mode function of the chain
+	/// \param KEC the key of the chain
+	/// \param Input pointer to the message (EC, EVer) or to CEC (DO)
+    void CheckChainInput(ChainMode Mode,
+                         const std::string& KEC,
+                         const unsigned char* Input);
+    /// \brief Chains the IV, the key and the header
+	/// \param State outputs the state before the first message block
+	/// \param Key pointer to K_EC
+	/// \param Header pointer to the header
+	/// \param HeaderSize size of the header
+	/// \param MessageSize size of the message
+    /// \details Returns the size of the start of the header which pads
+    ///          the message blocks (AltPad), else 0
+    uint64_t ChainHeader(Word* State,
+                         const uint8_t* Key,
+                         const uint8_t* Header,
+                         uint64_t HeaderSize,
+                         uint64_t MessageSize);
+    /// \brief Chains full message blocks, they are not the last block of the message
+	/// \param State the state of the chain
+	/// \param Key pointer to K_EC
+	/// \param Header pointer to the header which pads the message blocks
+	/// \param PadSize size of the header which pads the message blocks
+	/// \param Input pointer to the message (EC, EVer) or to CEC (DO)
+	/// \param Output outputs CEC (EC) or the message (DO), not used by EVer
+	/// \param Blocks number of blocks
+    template <ChainMode Mode>
+    static void ChainMessage(Word* State,
+                             const uint8_t* Key,
+                             const uint8_t* Header,
+                             uint64_t PadSize,
+                             const uint8_t* Input,
+                             uint8_t* Output,
+                             uint64_t Blocks);
+    /// \brief Chains the last block of the message and the suffix
+	/// \param State the state of the chain, outputs the state of the commitment
+	/// \param Key pointer to K_EC
+	/// \param HeaderSize size of the header
+	/// \param MessageSize size of the message
+	/// \param Input pointer to the last block of the message (EC, EVer) or of CEC (DO)
+	/// \param Output outputs the last block of CEC (EC) or of the message (DO), not used by EVer
+	/// \param Length size of the last block, 0 to cChunkSize
+    template <ChainMode Mode>
+    static void ChainSuffix(Word* State,
+                            const uint8_t* Key,
+                            uint64_t HeaderSize,
+                            uint64_t MessageSize,
+                            const uint8_t* Input,
+                            uint8_t* Output,
+                            uint64_t Length);
+    const std::string mIV = std::string(StateSize, '0');
+
+private:
+    /// \brief Chains one full message block
+	/// \param State the state of the chain
+	/// \param Key pointer to K_EC
+	/// \param Input pointer to the block of the message (EC, EVer) or of CEC (DO)
+	/// \param Output outputs the block of CEC (EC) or of the message (DO), not used by EVer
+	/// \param Block the block for f, the part after the message is already set
+    template <ChainMode Mode>
+    static void ChainBlock(Word* State,
+                           const uint8_t* Key,
+                           const uint8_t* Input,
+                           uint8_t* Output,
+                           uint8_t* Block);
+    /// \brief Chains full blocks of the incremental chain
+	/// \param Input pointer to the blocks
+	/// \param Output outputs the blocks, not used by EVer
+	/// \param Blocks number of blocks
+    void ChainBlocks(const uint8_t* Input,
+                     uint8_t* Output,
+                     uint64_t Blocks);
+
+    // State of the incremental chain
+    Word mChainState[cStateUnits];
+    // The last block is held back for the suffix
+    uint8_t mChainLast[cChunkSize];
+    size_t mChainLastSize = 0;
+    uint64_t mChainHeaderSize = 0;
+    uint64_t mChainMessageSize = 0;
+    const std::string cClassDescription = "HFC[" + Compression::Name() + "]";
+};
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::EC(const std::string& KEC,
+                                                      const unsigned char* Header,
+                                                      uint64_t HeaderSize,
+                                                      const unsigned char* Message,
+                                                      uint64_t MessageSize,
+                                                      unsigned char* CEC,
+                                                      std::string& BEC)
+{
+    CheckChainInput(ChainEC, KEC, Message);
+    const uint8_t* KeyPointer = (const uint8_t*)KEC.data();
+    Word State[cStateUnits];
+    uint64_t PadSize = ChainHeader(State, KeyPointer, Header, HeaderSize, MessageSize);
+    /* For i=1,...,m-1 do C_EC <- C_EC || (V_h+i-1 xor M_i) */
+    uint64_t Blocks = MessageSize == 0 ? 0 : (MessageSize - 1) / cChunkSize;
+    ChainMessage<ChainEC>(State, KeyPointer, Header, PadSize, Message, CEC, Blocks);
+    uint64_t Offset = Blocks * cChunkSize;
+    ChainSuffix<ChainEC>(State, KeyPointer, HeaderSize, MessageSize,
+                         Message + Offset, CEC + Offset, MessageSize - Offset);
+    /* Return (C_EC, B_EC), C_EC is already constructed */
+    BEC.assign(Commitment(State));
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+bool HFC<Compression, BlockSize, StateSize, Word>::DO(const std::string& KEC,
+                                                      const unsigned char* Header,
+                                                      uint64_t HeaderSize,
+                                                      const unsigned char* CEC,
+                                                      uint64_t CECSize,
+                                                      const std::string& BEC,
+                                                      unsigned char* Message)
+{
+    CheckChainInput(ChainDO, KEC, CEC);
+    const uint8_t* KeyPointer = (const uint8_t*)KEC.data();
+    Word State[cStateUnits];
+    uint64_t PadSize = ChainHeader(State, KeyPointer, Header, HeaderSize, CECSize);
+    /* For i=1,...,m-1 do M <- M || (V_h+i-1 xor CEC_i) */
+    uint64_t Blocks = CECSize == 0 ? 0 : (CECSize - 1) / cChunkSize;
+    ChainMessage<ChainDO>(State, KeyPointer, Header, PadSize, CEC, Message, Blocks);
+    uint64_t Offset = Blocks * cChunkSize;
+    ChainSuffix<ChainDO>(State, KeyPointer, HeaderSize, CECSize,
+                         CEC + Offset, Message + Offset, CECSize - Offset);
+    /* If B_EC' != B_EC then Return 0 */
+    if (BEC != Commitment(State))
+    {
+        memset(Message, 0x00, CECSize);
+        return false;
+    }
+    return true;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+bool HFC<Compression, BlockSize, StateSize, Word>::EVer(const unsigned char* Header,
+                                                        uint64_t HeaderSize,
+                                                        const unsigned char* Message,
+                                                        uint64_t MessageSize,
+                                                        const std::string& KEC,
+                                                        const std::string& BEC)
+{
+    CheckChainInput(ChainEVer, KEC, Message);
+    const uint8_t* KeyPointer = (const uint8_t*)KEC.data();
+    Word State[cStateUnits];
+    uint64_t PadSize = ChainHeader(State, KeyPointer, Header, HeaderSize, MessageSize);
+    /* V_m-1 <- f+(V_h, (KEC xor M_1') || ... || (KEC xor M_m-1')) */
+    uint64_t Blocks = MessageSize == 0 ? 0 : (MessageSize - 1) / cChunkSize;
+    ChainMessage<ChainEVer>(State, KeyPointer, Header, PadSize, Message, NULL, Blocks);
+    uint64_t Offset = Blocks * cChunkSize;
+    ChainSuffix<ChainEVer>(State, KeyPointer, HeaderSize, MessageSize,
+                           Message + Offset, NULL, MessageSize - Offset);
+    /* If B_EC' != B_EC then Return 0 */
+    return BEC == Commitment(State);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::CheckChainInput(ChainMode Mode,
+                                                                   const std::string& KEC,
+                                                                   const unsigned char* Input)
+{
+    if (Mode == ChainEC && Input == NULL)
+    {
+        throw std::runtime_error("Null pointer for message");
+    }
+    if (Mode == ChainDO && Input == NULL)
+    {
+        throw std::runtime_error("Null pointer for CEC");
+    }
+    CheckInput(KEC.size());
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+uint64_t HFC<Compression, BlockSize, StateSize, Word>::ChainHeader(Word* State,
+                                                                   const uint8_t* Key,
+                                                                   const uint8_t* Header,
+                                                                   uint64_t HeaderSize,
+                                                                   uint64_t MessageSize)
+{
+    alignas(Word) uint8_t Block[BlockSize];
+    // Initialize state with IV
+    memcpy(State, mIV.data(), StateSize);
+    /* V0 <- f(IV, KEC) */
+    Compression::Compress(State, Key);
+    uint64_t PadSize = 0;
+    if constexpr (Compression::cHeaderInMessage)
+    {
+        // The last message block is padded by the suffix, so the header pads
+        // the ones before it and only the rest of it gets own blocks
+        uint64_t MessageBlocks = MessageSize == 0 ? 0 : (MessageSize - 1) / StateSize;
+        if (HeaderSize <= MessageBlocks * cPadSize)
+        {
+            return HeaderSize;
+        }
+        PadSize = MessageBlocks * cPadSize;
+        Header += PadSize;
+        HeaderSize -= PadSize;
+    }
+    /* Vh <- f+(V0, (KEC xor H1) || ... || (KEC xor Hh)) */
+    while (HeaderSize >= BlockSize)
+    {
+        HeaderBlock(Key, Header, BlockSize, Block);
+        Compression::Compress(State, Block);
+        Header += BlockSize;
+        HeaderSize -= BlockSize;
+    }
+    HeaderBlock(Key, Header, HeaderSize, Block);
+    Compression::Compress(State, Block);
+    return PadSize;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::HeaderBlock(const uint8_t* Key,
+                                                               const uint8_t* Header,
+                                                               uint64_t Size,
+                                                               uint8_t* Block)
+{
+    if constexpr (Compression::cSponge)
+    {
+        memset(Block, 0x00, BlockSize);
+    }
+    else
+    {
+        memcpy(Block, Key, BlockSize);
+    }
+    CryptoPP::xorbuf(Block, Header, Size);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::MessageKeyBlock(const uint8_t* Key,
+                                                                   uint8_t* Block)
+{
+    memcpy(Block + cChunkSize, Key + cChunkSize, BlockSize - cChunkSize);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+template <IHFCScheme::ChainMode Mode>
+void HFC<Compression, BlockSize, StateSize, Word>::MessageBlock(const Word* State,
+                                                                const uint8_t* Key,
+                                                                const uint8_t* Input,
+                                                                uint8_t* Output,
+                                                                uint8_t* Block)
+{
+    if constexpr (Mode == ChainDO)
+    {
+        /* M <- M || (V_h+i-1 xor CEC_i) */
+        CryptoPP::xorbuf(Output, Input, (const uint8_t*)State, cChunkSize);
+        Input = Output;
+    }
+    /* V_h+i <- f(V_h+i-1, (KEC xor M_i')) */
+    if constexpr (Compression::cSponge)
+    {
+        memcpy(Block, Input, cChunkSize);
+    }
+    else
+    {
+        CryptoPP::xorbuf(Block, Input, Key, cChunkSize);
+    }
+    if constexpr (Mode == ChainEC)
+    {
+        // After the block, CEC may be written over the message
+        /* C_EC <- C_EC || (V_h+i-1 xor M_i) */
+        CryptoPP::xorbuf(Output, Input, (const uint8_t*)State, cChunkSize);
+    }
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+template <IHFCScheme::ChainMode Mode>
+void HFC<Compression, BlockSize, StateSize, Word>::ChainBlock(Word* State,
+                                                              const uint8_t* Key,
+                                                              const uint8_t* Input,
+                                                              uint8_t* Output,
+                                                              uint8_t* Block)
+{
+    MessageBlock<Mode>(State, Key, Input, Output, Block);
+    Compression::Compress(State, Block);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+template <IHFCScheme::ChainMode Mode>
+void HFC<Compression, BlockSize, StateSize, Word>::ChainMessage(Word* State,
+                                                                const uint8_t* Key,
+                                                                const uint8_t* Header,
+                                                                uint64_t PadSize,
+                                                                const uint8_t* Input,
+                                                                uint8_t* Output,
+                                                                uint64_t Blocks)
+{
+    const uint64_t OutputStep = Mode == ChainEVer ? 0 : cChunkSize;
+    alignas(Word) uint8_t Block[BlockSize];
+    MessageKeyBlock(Key, Block);
+    if constexpr (Compression::cHeaderInMessage)
+    {
+        /* For i=1,...,b do, with (KEC xor H_i) after M_i */
+        while (PadSize > 0)
+        {
+            uint64_t Size = PadSize < cPadSize ? PadSize : cPadSize;
+            MessageKeyBlock(Key, Block);
+            CryptoPP::xorbuf(Block + StateSize, Header, Size);
+            ChainBlock<Mode>(State, Key, Input, Output, Block);
+            Header += Size;
+            PadSize -= Size;
+            Input += cChunkSize;
+            Output += OutputStep;
+            Blocks--;
+        }
+        // Use the key for the remaining message blocks
+        MessageKeyBlock(Key, Block);
+    }
+    uint64_t Chained = Compression::Chain(State, Key, Input, Output, Blocks, Mode);
+    Input += Chained * cChunkSize;
+    Output += Chained * OutputStep;
+    /* For i=b,...,m-1 do */
+    for (uint64_t i = Chained; i < Blocks; i++)
+    {
+        ChainBlock<Mode>(State, Key, Input, Output, Block);
+        Input += cChunkSize;
+        Output += OutputStep;
+    }
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+template <IHFCScheme::ChainMode Mode>
+void HFC<Compression, BlockSize, StateSize, Word>::SuffixBlocks(const Word* State,
+                                                                const uint8_t* Key,
+                                                                uint64_t HeaderSize,
+                                                                uint64_t MessageSize,
+                                                                const uint8_t* Input,
+                                                                uint8_t* Output,
+                                                                uint64_t Length,
+                                                                uint8_t* Blocks)
+{
+    /* M_m', M_m+1' <- Parse_d(PadSuf(|H|, |M|, M_m)) */
+    uint8_t* MessageSuf = Blocks;
+    const size_t SufSize = 2 * BlockSize;
+    memset(MessageSuf, 0x00, SufSize);
+    if constexpr (Mode == ChainDO)
+    {
+        /* M <- M || (V_h+m-1 xor CEC_m) */
+        CryptoPP::xorbuf(Output, Input, (const uint8_t*)State, Length);
+        memcpy(MessageSuf, Output, Length);
+    }
+    else
+    {
+        memcpy(MessageSuf, Input, Length);
+        if constexpr (Mode == ChainEC)
+        {
+            /* C_EC <- C_EC || (V_h+m-1 xor M_m) */
+            CryptoPP::xorbuf(Output, Input, (const uint8_t*)State, Length);
+        }
+    }
+    memcpy(MessageSuf + SufSize - sizeof(HeaderSize) - sizeof(MessageSize), &HeaderSize, sizeof(HeaderSize));
+    memcpy(MessageSuf + SufSize - sizeof(MessageSize), &MessageSize, sizeof(MessageSize));
+    CryptoPP::xorbuf(MessageSuf, Key, cSuffixKeySize);
+    CryptoPP::xorbuf(MessageSuf + cSuffixKeySize, Key, cSuffixKeySize);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+template <IHFCScheme::ChainMode Mode>
+void HFC<Compression, BlockSize, StateSize, Word>::ChainSuffix(Word* State,
+                                                               const uint8_t* Key,
+                                                               uint64_t HeaderSize,
+                                                               uint64_t MessageSize,
+                                                               const uint8_t* Input,
+                                                               uint8_t* Output,
+                                                               uint64_t Length)
+{
+    alignas(Word) uint8_t MessageSuf[2 * BlockSize];
+    SuffixBlocks<Mode>(State, Key, HeaderSize, MessageSize, Input, Output, Length, MessageSuf);
+    /* B_EC <- f+(V_h+m-1, (K_EC xor M_m') || (K_EC xor M_m+1')) */
+    Compression::Compress(State, MessageSuf);
+    Compression::Compress(State, MessageSuf + BlockSize);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::StartChain(ChainMode Mode,
+                                                              const std::string& KEC,
+                                                              const unsigned char* Header,
+                                                              uint64_t HeaderSize)
+{
+    if constexpr (Compression::cHeaderInMessage)
+    {
+        // The header blocks depend on the size of the message, so it is buffered
+        IHFCScheme::StartChain(Mode, KEC, Header, HeaderSize);
+        return;
+    }
+    CheckInput(KEC.size());
+    mChainMode = Mode;
+    mChainKey.assign(KEC);
+    ChainHeader(mChainState, (const uint8_t*)mChainKey.data(), Header, HeaderSize, 0);
+    mChainHeaderSize = HeaderSize;
+    mChainMessageSize = 0;
+    mChainLastSize = 0;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::ChainBlocks(const uint8_t* Input,
+                                                               uint8_t* Output,
+                                                               uint64_t Blocks)
+{
+    const uint8_t* KeyPointer = (const uint8_t*)mChainKey.data();
+    if (mChainMode == ChainEC)
+    {
+        ChainMessage<ChainEC>(mChainState, KeyPointer, NULL, 0, Input, Output, Blocks);
+    }
+    else if (mChainMode == ChainDO)
+    {
+        ChainMessage<ChainDO>(mChainState, KeyPointer, NULL, 0, Input, Output, Blocks);
+    }
+    else
+    {
+        ChainMessage<ChainEVer>(mChainState, KeyPointer, NULL, 0, Input, NULL, Blocks);
+    }
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+void HFC<Compression, BlockSize, StateSize, Word>::UpdateChain(const unsigned char* Input,
+                                                               size_t InputSize,
+                                                               unsigned char* Output,
+                                                               size_t& OutputSize)
+{
+    if constexpr (Compression::cHeaderInMessage)
+    {
+        IHFCScheme::UpdateChain(Input, InputSize, Output, OutputSize);
+        return;
+    }
+    // Every block except the last one (1 to cChunkSize bytes) is chained
+    size_t Available = mChainLastSize + InputSize;
+    size_t WriteSize = Available == 0 ? 0 : (Available - 1) / cChunkSize * cChunkSize;
+    if (mChainMode == ChainEVer)
+    {
+        WriteSize = 0;
+    }
+    if (OutputSize < WriteSize)
+    {
+        throw std::runtime_error("Output buffer too small for the chain");
+    }
+    mChainMessageSize += InputSize;
+    size_t Written = 0;
+    if (mChainLastSize != 0 && Available > cChunkSize)
+    {
+        // Complete the block of the last part, there is more after it
+        size_t Missing = cChunkSize - mChainLastSize;
+        memcpy(mChainLast + mChainLastSize, Input, Missing);
+        ChainBlocks(mChainLast, Output, 1);
+        Written += mChainMode == ChainEVer ? 0 : cChunkSize;
+        Input += Missing;
+        InputSize -= Missing;
+        mChainLastSize = 0;
+    }
+    /* For i=1,...,m-1 do */
+    if (InputSize > cChunkSize)
+    {
+        size_t Blocks = (InputSize - 1) / cChunkSize;
+        ChainBlocks(Input, Output + Written, Blocks);
+        Written += mChainMode == ChainEVer ? 0 : Blocks * cChunkSize;
+        Input += Blocks * cChunkSize;
+        InputSize -= Blocks * cChunkSize;
+    }
+    memcpy(mChainLast + mChainLastSize, Input, InputSize);
+    mChainLastSize += InputSize;
+    OutputSize = WriteSize;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+bool HFC<Compression, BlockSize, StateSize, Word>::FinishChain(unsigned char* Output,
+                                                               size_t& OutputSize,
+                                                               std::string& BEC)
+{
+    if constexpr (Compression::cHeaderInMessage)
+    {
+        return IHFCScheme::FinishChain(Output, OutputSize, BEC);
+    }
+    size_t WriteSize = mChainMode == ChainEVer ? 0 : mChainLastSize;
+    if (OutputSize < WriteSize)
+    {
+        throw std::runtime_error("Output buffer too small for the chain");
+    }
+    const uint8_t* KeyPointer = (const uint8_t*)mChainKey.data();
+    if (mChainMode == ChainEC)
+    {
+        ChainSuffix<ChainEC>(mChainState, KeyPointer, mChainHeaderSize, mChainMessageSize,
+                             mChainLast, Output, mChainLastSize);
+    }
+    else if (mChainMode == ChainDO)
+    {
+        ChainSuffix<ChainDO>(mChainState, KeyPointer, mChainHeaderSize, mChainMessageSize,
+                             mChainLast, Output, mChainLastSize);
+    }
+    else
+    {
+        ChainSuffix<ChainEVer>(mChainState, KeyPointer, mChainHeaderSize, mChainMessageSize,
+                               mChainLast, NULL, mChainLastSize);
+    }
+    OutputSize = WriteSize;
+    mChainLastSize = 0;
+    if (mChainMode == ChainEC)
+    {
+        /* Return (C_EC, B_EC), C_EC is already written */
+        BEC.assign(Commitment(mChainState));
+        return true;
+    }
+    /* If B_EC' != B_EC then Return 0 */
+    return BEC == Commitment(mChainState);
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+IHFCScheme* HFC<Compression, BlockSize, StateSize, Word>::Clone() const
+{
+    return new HFC();
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+const std::string& HFC<Compression, BlockSize, StateSize, Word>::GetClassDecription()
+{
+    return cClassDescription;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+uint32_t HFC<Compression, BlockSize, StateSize, Word>::GetBlockSize()
+{
+    return BlockSize;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+uint32_t HFC<Compression, BlockSize, StateSize, Word>::GetStateSize()
+{
+    return StateSize;
+}
+
+template <class Compression, uint32_t BlockSize, uint32_t StateSize, class Word>
+size_t HFC<Compression, BlockSize, StateSize, Word>::GetCommitmentSize()
+{
+    // BEC has one byte per state word
+    return cStateUnits;
+}
+
+#endif
@@ -3,7 +3,7 @@
 
 #include <string>
 
-#include <cryptopp/osrng.h>
+#include "../Random.h"
 
 class IHFCScheme
 {
@@ -15,14 +15,55 @@ public:
     /// \brief Key generation for the scheme
     std::string EKg()
     {
-        CryptoPP::AutoSeededRandomPool Rnd;
-        string Key(GetBlockSize(), '0');
-        Rnd.GenerateBlock((unsigned char*)Key.data(), Key.size());
-        return Key;
+        return RandomGenerator::Generate(GetBlockSize());
     }
-    /// \brief Encryptes the message with a header
+    /// \brief Encrypts the message with a header into a caller buffer
+	/// \param KEC Key for the encryption
+	/// \param Header pointer to the header for the encryption
+	/// \param HeaderSize size of the header
+	/// \param Message pointer to input for the encryption
+	/// \param MessageSize size of input data for the encryption
+	/// \param CEC outputs the cipher for the message, needs MessageSize bytes
+	/// \param BEC reference outputs the commitment
+    /// \details Nothing is copied or allocated for the message and the
+    ///          cipher, CEC may point into a larger output buffer
+    virtual void EC(const std::string& KEC,
+                    const unsigned char* Header,
+                    uint64_t HeaderSize,
+                    const unsigned char* Message, 
+                    uint64_t MessageSize, 
+                    unsigned char* CEC,
+                    std::string& BEC) = 0;
+    /// \brief Decrypts the cipher with a header into a caller buffer
+	/// \param KEC Key for the decryption
+	/// \param Header pointer to the header for the decryption
+	/// \param HeaderSize size of the header
+	/// \param CEC ciphertext pointer for the decryption
+	/// \param CECSize size of data of ciphertext
+	/// \param BEC commitment for the decryption
+	/// \param Message outputs the message, needs CECSize bytes
+    virtual bool DO(const std::string& KEC,
+                    const unsigned char* Header,
+                    uint64_t HeaderSize,
+                    const unsigned char* CEC, 
+                    uint64_t CECSize, 
+                    const std::string& BEC,
+                    unsigned char* Message) = 0;
+    /// \brief Verifies the Header and Message for a commitment
+	/// \param Header pointer to the header for the verification
+	/// \param HeaderSize size of the header
+	/// \param Message pointer to the message for the verification
+	/// \param MessageSize size of the message
+	/// \param KEC for the verification
+	/// \param BEC the commitment to verify
+    virtual bool EVer(const unsigned char* Header,
+                      uint64_t HeaderSize,
+                      const unsigned char* Message,
+                      uint64_t MessageSize,
+                      const std::string& KEC,
+                      const std::string& BEC) = 0;
+    /// \brief Encrypts the message with a header
 	/// \param KEC Key for the encryption
-	/// \param Nonce for the encryption
 	/// \param Header for the encryption
 	/// \param Message pointer to input for the encryption
 	/// \param MessageSize size of input data for the encryption
@@ -30,15 +71,19 @@ public:
 	/// \param BEC reference outputs the commitment
     /// \details We use a pointer to the input message to avoid
     ///          a string creation in any case
-    virtual void EC(const std::string& KEC,
-                    const std::string& Header,
-                    const unsigned char* Message, 
-                    uint32_t MessageSize, 
-                    std::string& CEC,
-                    std::string& BEC) = 0;
-    /// \brief Decryptes the cipher with a header
+    void EC(const std::string& KEC,
+            const std::string& Header,
+            const unsigned char* Message, 
+            uint64_t MessageSize, 
+            std::string& CEC,
+            std::string& BEC)
+    {
+        CEC.resize(GetCiphertextSize(Header.size(), MessageSize));
+        EC(KEC, (const unsigned char*)Header.data(), Header.size(),
+           Message, MessageSize, (unsigned char*)CEC.data(), BEC);
+    }
+    /// \brief Decrypts the cipher with a header
 	/// \param KEC Key for the decryption
-	/// \param Nonce for the decryption
 	/// \param Header for the decryption
 	/// \param CEC ciphertext pointer for the decryption
 	/// \param CECSize size of data of ciphertext
@@ -46,25 +91,210 @@ public:
 	/// \param Message reference outputs the message
     /// \details We use a pointer to CEC to avoid
     ///          a string creation in any case
-    virtual bool DO(const std::string& KEC,
-                    const std::string& Header,
-                    const unsigned char* CEC, 
-                    uint32_t CECSize, 
-                    const std::string& BEC,
-                    std::string& Message) = 0;
+    bool DO(const std::string& KEC,
+            const std::string& Header,
+            const unsigned char* CEC, 
+            uint64_t CECSize, 
+            const std::string& BEC,
+            std::string& Message)
+    {
+        Message.resize(GetMaxPlaintextSize(CECSize));
+        return DO(KEC, (const unsigned char*)Header.data(), Header.size(),
+                  CEC, CECSize, BEC, (unsigned char*)Message.data());
+    }
     /// \brief Verifies the Header and Message for a commitment
-	/// \param Nonce for the verification
 	/// \param Header for the verification
 	/// \param Message for the verification
 	/// \param KEC for the verification
 	/// \param BEC the commitment to verify
-    virtual bool EVer(const std::string& Header,
-                      const std::string& Message,
-                      const std::string& KEC,
-                      const std::string& BEC) = 0;
+    bool EVer(const std::string& Header,
+              const std::string& Message,
+              const std::string& KEC,
+              const std::string& BEC)
+    {
+        return EVer((const unsigned char*)Header.data(), Header.size(),
+                    (const unsigned char*)Message.data(), Message.size(), KEC, BEC);
+    }
+    /// \brief Encrypts a batch of independent messages
+	/// \param Count number of messages
+	/// \param KECs key of every message
+	/// \param Headers pointers to the headers
+	/// \param HeaderSizes sizes of the headers
+	/// \param Messages pointers to the messages
+	/// \param MessageSizes sizes of the messages
+	/// \param CECs outputs the cipher of every message, MessageSizes[i] bytes each
+	/// \param BECs outputs the commitment of every message
+    /// \details The default calls EC for every message, schemes with
+    ///          a multi-buffer engine run the chains side by side
+    virtual void ECBatch(size_t Count,
+                         const std::string* KECs,
+                         const unsigned char* const* Headers,
+                         const size_t* HeaderSizes,
+                         const unsigned char* const* Messages,
+                         const size_t* MessageSizes,
+                         unsigned char* const* CECs,
+                         std::string* BECs)
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            EC(KECs[i], Headers[i], HeaderSizes[i], Messages[i], MessageSizes[i], CECs[i], BECs[i]);
+        }
+    }
+    /// \brief Decrypts a batch of independent ciphers
+	/// \param Count number of ciphers
+	/// \param KECs key of every cipher
+	/// \param Headers pointers to the headers
+	/// \param HeaderSizes sizes of the headers
+	/// \param CECs pointers to the ciphers
+	/// \param CECSizes sizes of the ciphers
+	/// \param BECs commitment of every cipher
+	/// \param Messages outputs the message of every cipher, CECSizes[i] bytes each
+	/// \param Valid outputs if every cipher was decrypted
+    /// \details Returns the number of valid ciphers, the messages of
+    ///          the invalid ones are cleared like by DO
+    virtual size_t DOBatch(size_t Count,
+                           const std::string* KECs,
+                           const unsigned char* const* Headers,
+                           const size_t* HeaderSizes,
+                           const unsigned char* const* CECs,
+                           const size_t* CECSizes,
+                           const std::string* BECs,
+                           unsigned char* const* Messages,
+                           bool* Valid)
+    {
+        size_t ValidCount = 0;
+        for (size_t i = 0; i < Count; i++)
+        {
+            Valid[i] = DO(KECs[i], Headers[i], HeaderSizes[i], CECs[i], CECSizes[i], BECs[i], Messages[i]);
+            ValidCount += Valid[i];
+        }
+        return ValidCount;
+    }
+    /// \brief Verifies a batch of independent messages
+	/// \param Count number of messages
+	/// \param Headers pointers to the headers
+	/// \param HeaderSizes sizes of the headers
+	/// \param Messages pointers to the messages
+	/// \param MessageSizes sizes of the messages
+	/// \param KECs key of every message
+	/// \param BECs commitment of every message
+	/// \param Valid outputs if every message was verified
+    /// \details Returns the number of valid messages
+    virtual size_t EVerBatch(size_t Count,
+                             const unsigned char* const* Headers,
+                             const size_t* HeaderSizes,
+                             const unsigned char* const* Messages,
+                             const size_t* MessageSizes,
+                             const std::string* KECs,
+                             const std::string* BECs,
+                             bool* Valid)
+    {
+        size_t ValidCount = 0;
+        for (size_t i = 0; i < Count; i++)
+        {
+            Valid[i] = EVer(Headers[i], HeaderSizes[i], Messages[i], MessageSizes[i], KECs[i], BECs[i]);
+            ValidCount += Valid[i];
+        }
+        return ValidCount;
+    }
+    /// \brief Function of an incremental chain
+    enum ChainMode
+    {
+        ChainEC = 0,
+        ChainDO,
+        ChainEVer
+    };
+    /// \brief Starts an incremental EC, DO or EVer
+	/// \param Mode function of the chain
+	/// \param KEC Key for the chain
+	/// \param Header pointer to the header
+	/// \param HeaderSize size of the header
+    /// \details The default buffers the input and calls the functions
+    ///          above in FinishChain, schemes with a sequential chain
+    ///          override the incremental functions
+    virtual void StartChain(ChainMode Mode,
+                            const std::string& KEC,
+                            const unsigned char* Header,
+                            uint64_t HeaderSize)
+    {
+        CheckInput(KEC.size());
+        mChainMode = Mode;
+        mChainKey.assign(KEC);
+        mChainHeader.assign((const char*)Header, HeaderSize);
+        mChainBuffer.clear();
+    }
+    /// \brief Chains the next part of the message (EC, EVer) or of CEC (DO)
+	/// \param Input pointer to the next part
+	/// \param InputSize size of the part
+	/// \param Output outputs the next part of CEC (EC) or of the message (DO)
+	/// \param OutputSize capacity of Output, outputs the written size
+    /// \details The last block goes into the suffix and is held back, so
+    ///          InputSize plus GetStateSize is always enough, otherwise a
+    ///          runtime_error is thrown. EVer has no output
+    virtual void UpdateChain(const unsigned char* Input,
+                             size_t InputSize,
+                             unsigned char* /* Output */,
+                             size_t& OutputSize)
+    {
+        mChainBuffer.append((const char*)Input, InputSize);
+        OutputSize = 0;
+    }
+    /// \brief Finishes the chain
+	/// \param Output outputs the rest of CEC (EC) or of the message (DO)
+	/// \param OutputSize capacity of Output, outputs the written size
+	/// \param BEC reference outputs the commitment (EC) or the commitment to check (DO, EVer)
+    /// \details Returns false if the commitment does not match, the output
+    ///          of DO is not cleared then and has to be discarded
+    virtual bool FinishChain(unsigned char* Output,
+                             size_t& OutputSize,
+                             std::string& BEC)
+    {
+        bool Success = true;
+        size_t WriteSize = mChainMode == ChainEVer ? 0 : mChainBuffer.size();
+        if (OutputSize < WriteSize)
+        {
+            throw runtime_error("Output buffer too small for the chain");
+        }
+        if (mChainMode == ChainEC)
+        {
+            EC(mChainKey, (const unsigned char*)mChainHeader.data(), mChainHeader.size(),
+               (const unsigned char*)mChainBuffer.data(), mChainBuffer.size(), Output, BEC);
+        }
+        else if (mChainMode == ChainDO)
+        {
+            Success = DO(mChainKey, (const unsigned char*)mChainHeader.data(), mChainHeader.size(),
+                         (const unsigned char*)mChainBuffer.data(), mChainBuffer.size(), BEC, Output);
+        }
+        else
+        {
+            Success = EVer((const unsigned char*)mChainHeader.data(), mChainHeader.size(),
+                           (const unsigned char*)mChainBuffer.data(), mChainBuffer.size(), mChainKey, BEC);
+        }
+        mChainBuffer.clear();
+        OutputSize = WriteSize;
+        return Success;
+    }
+    /// \brief Returns a new instance of the same HFC without the chain state
+    virtual IHFCScheme* Clone() const = 0;
     virtual const std::string& GetClassDecription() = 0;
     virtual uint32_t GetBlockSize() = 0;
     virtual uint32_t GetStateSize() = 0;
+    /// \brief Returns the size of CEC, it is always the message size
+	/// \param HeaderLength length of the header
+	/// \param MessageLength length of the message
+    size_t GetCiphertextSize(size_t /* HeaderLength */,
+                             size_t MessageLength)
+    {
+        return MessageLength;
+    }
+    /// \brief Returns the size of the commitment BEC
+    virtual size_t GetCommitmentSize() = 0;
+    /// \brief Returns the size of the message for a CEC
+	/// \param CECSize size of the ciphertext
+    size_t GetMaxPlaintextSize(size_t CECSize)
+    {
+        return CECSize;
+    }
     /// \brief Checks if the key size is correct
     /// for the scheme
     bool CheckInput(uint32_t Keysize)
@@ -81,5 +311,10 @@ public:
 
     protected:
         const std::string mIV = "";
+        // State of the incremental chain
+        ChainMode mChainMode = ChainEC;
+        std::string mChainKey;
+        std::string mChainHeader;
+        std::string mChainBuffer;
 };
 #endif
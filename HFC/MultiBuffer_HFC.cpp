@@ -0,0 +1,538 @@
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MULTIBUFFER_HFC_KERNEL
+#endif
+using namespace std;
+
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/misc.h>
+#include <cryptopp/sha.h>
+using namespace CryptoPP;
+
+#include "MultiBuffer_HFC.h"
+#include "SHA256_HFC.h"
+#include "SHA512_HFC.h"
+
+#ifdef MULTIBUFFER_HFC_KERNEL
+
+#define MULTIBUFFER_INLINE inline __attribute__((always_inline))
+// Rotates every word of a vector right
+#define MULTIBUFFER_ROR(X, N) (((X) >> (N)) | ((X) << (Hash::WORDBITS - (N))))
+
+/// \brief Constants of SHA256
+struct SHA256Hash
+{
+    // The HFC which builds the blocks of the lanes
+    typedef SHA256_HFC HFCType;
+    typedef word32 Word;
+    static const uint32_t WORDBITS = 32;
+    static const uint32_t BLOCKSIZE = 64;
+    static const uint32_t STATESIZE = 32;
+    static const uint32_t ROUNDS = 64;
+    static const Word cK[ROUNDS];
+    // Rotations of Sigma0, Sigma1, sigma0 and sigma1, the last one of sigma is a shift
+    static constexpr uint32_t cRotations[4][3] = {{2, 13, 22}, {6, 11, 25}, {7, 18, 3}, {17, 19, 10}};
+    static void Transform(Word* State, const Word* Block) { SHA256::Transform(State, Block); }
+};
+
+const word32 SHA256Hash::cK[SHA256Hash::ROUNDS] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/// \brief Constants of SHA512
+struct SHA512Hash
+{
+    typedef SHA512_HFC HFCType;
+    typedef word64 Word;
+    static const uint32_t WORDBITS = 64;
+    static const uint32_t BLOCKSIZE = 128;
+    static const uint32_t STATESIZE = 64;
+    static const uint32_t ROUNDS = 80;
+    static const Word cK[ROUNDS];
+    // Rotations of Sigma0, Sigma1, sigma0 and sigma1, the last one of sigma is a shift
+    static constexpr uint32_t cRotations[4][3] = {{28, 34, 39}, {14, 18, 41}, {1, 8, 7}, {19, 61, 6}};
+    static void Transform(Word* State, const Word* Block) { SHA512::Transform(State, Block); }
+};
+
+const word64 SHA512Hash::cK[SHA512Hash::ROUNDS] = {
+    W64LIT(0x428a2f98d728ae22), W64LIT(0x7137449123ef65cd), W64LIT(0xb5c0fbcfec4d3b2f), W64LIT(0xe9b5dba58189dbbc),
+    W64LIT(0x3956c25bf348b538), W64LIT(0x59f111f1b605d019), W64LIT(0x923f82a4af194f9b), W64LIT(0xab1c5ed5da6d8118),
+    W64LIT(0xd807aa98a3030242), W64LIT(0x12835b0145706fbe), W64LIT(0x243185be4ee4b28c), W64LIT(0x550c7dc3d5ffb4e2),
+    W64LIT(0x72be5d74f27b896f), W64LIT(0x80deb1fe3b1696b1), W64LIT(0x9bdc06a725c71235), W64LIT(0xc19bf174cf692694),
+    W64LIT(0xe49b69c19ef14ad2), W64LIT(0xefbe4786384f25e3), W64LIT(0x0fc19dc68b8cd5b5), W64LIT(0x240ca1cc77ac9c65),
+    W64LIT(0x2de92c6f592b0275), W64LIT(0x4a7484aa6ea6e483), W64LIT(0x5cb0a9dcbd41fbd4), W64LIT(0x76f988da831153b5),
+    W64LIT(0x983e5152ee66dfab), W64LIT(0xa831c66d2db43210), W64LIT(0xb00327c898fb213f), W64LIT(0xbf597fc7beef0ee4),
+    W64LIT(0xc6e00bf33da88fc2), W64LIT(0xd5a79147930aa725), W64LIT(0x06ca6351e003826f), W64LIT(0x142929670a0e6e70),
+    W64LIT(0x27b70a8546d22ffc), W64LIT(0x2e1b21385c26c926), W64LIT(0x4d2c6dfc5ac42aed), W64LIT(0x53380d139d95b3df),
+    W64LIT(0x650a73548baf63de), W64LIT(0x766a0abb3c77b2a8), W64LIT(0x81c2c92e47edaee6), W64LIT(0x92722c851482353b),
+    W64LIT(0xa2bfe8a14cf10364), W64LIT(0xa81a664bbc423001), W64LIT(0xc24b8b70d0f89791), W64LIT(0xc76c51a30654be30),
+    W64LIT(0xd192e819d6ef5218), W64LIT(0xd69906245565a910), W64LIT(0xf40e35855771202a), W64LIT(0x106aa07032bbd1b8),
+    W64LIT(0x19a4c116b8d2d0c8), W64LIT(0x1e376c085141ab53), W64LIT(0x2748774cdf8eeb99), W64LIT(0x34b0bcb5e19b48a8),
+    W64LIT(0x391c0cb3c5c95a63), W64LIT(0x4ed8aa4ae3418acb), W64LIT(0x5b9cca4f7763e373), W64LIT(0x682e6ff3d6b2b8a3),
+    W64LIT(0x748f82ee5defb2fc), W64LIT(0x78a5636f43172f60), W64LIT(0x84c87814a1f0ab72), W64LIT(0x8cc702081a6439ec),
+    W64LIT(0x90befffa23631e28), W64LIT(0xa4506cebde82bde9), W64LIT(0xbef9a3f7b2c67915), W64LIT(0xc67178f2e372532b),
+    W64LIT(0xca273eceea26619c), W64LIT(0xd186b8c721c0c207), W64LIT(0xeada7dd6cde0eb1e), W64LIT(0xf57d4f7fee6ed178),
+    W64LIT(0x06f067aa72176fba), W64LIT(0x0a637dc5a2c898a6), W64LIT(0x113f9804bef90dae), W64LIT(0x1b710b35131c471b),
+    W64LIT(0x28db77f523047d84), W64LIT(0x32caab7b40c72493), W64LIT(0x3c9ebe0a15c9bebc), W64LIT(0x431d67c49c100d4c),
+    W64LIT(0x4cc5d4becb3e42b6), W64LIT(0x597f299cfc657e2a), W64LIT(0x5fcb6fab3ad6faec), W64LIT(0x6c44198c4a475817)
+};
+
+/// \brief Compresses one block into the state of every lane
+/// \details State and Block hold word j of every lane behind each other.
+/// The words are in the byte order of the CPU like for SHA256::Transform,
+/// the vector type V decides the lanes and gets the instructions of the caller
+template <class Hash, typename V>
+static MULTIBUFFER_INLINE void CompressLanes(typename Hash::Word* State,
+                                             const typename Hash::Word* Block)
+{
+    V S[8];
+    V W[16];
+    memcpy(S, State, sizeof(S));
+    memcpy(W, Block, sizeof(W));
+    V A = S[0], B = S[1], C = S[2], D = S[3], E = S[4], F = S[5], G = S[6], H = S[7];
+    for (uint32_t i = 0; i < Hash::ROUNDS; i++)
+    {
+        const uint32_t (*R)[3] = Hash::cRotations;
+        if (i >= 16)
+        {
+            // W[i] = sigma1(W[i-2]) + W[i-7] + sigma0(W[i-15]) + W[i-16]
+            V W2 = W[(i - 2) & 15];
+            V W15 = W[(i - 15) & 15];
+            W[i & 15] += (MULTIBUFFER_ROR(W2, R[3][0]) ^ MULTIBUFFER_ROR(W2, R[3][1]) ^ (W2 >> R[3][2])) +
+                         W[(i - 7) & 15] +
+                         (MULTIBUFFER_ROR(W15, R[2][0]) ^ MULTIBUFFER_ROR(W15, R[2][1]) ^ (W15 >> R[2][2]));
+        }
+        V T1 = H + (MULTIBUFFER_ROR(E, R[1][0]) ^ MULTIBUFFER_ROR(E, R[1][1]) ^ MULTIBUFFER_ROR(E, R[1][2])) +
+               ((E & F) ^ (~E & G)) + Hash::cK[i] + W[i & 15];
+        V T2 = (MULTIBUFFER_ROR(A, R[0][0]) ^ MULTIBUFFER_ROR(A, R[0][1]) ^ MULTIBUFFER_ROR(A, R[0][2])) +
+               ((A & B) ^ (A & C) ^ (B & C));
+        H = G;
+        G = F;
+        F = E;
+        E = D + T1;
+        D = C;
+        C = B;
+        B = A;
+        A = T1 + T2;
+    }
+    S[0] += A; S[1] += B; S[2] += C; S[3] += D;
+    S[4] += E; S[5] += F; S[6] += G; S[7] += H;
+    memcpy(State, S, sizeof(S));
+}
+
+typedef word32 Word32x8 __attribute__((vector_size(32)));
+typedef word32 Word32x16 __attribute__((vector_size(64)));
+typedef word64 Word64x4 __attribute__((vector_size(32)));
+typedef word64 Word64x8 __attribute__((vector_size(64)));
+
+__attribute__((target("avx2")))
+static void CompressSHA256x8(word32* State, const word32* Block)
+{
+    CompressLanes<SHA256Hash, Word32x8>(State, Block);
+}
+
+__attribute__((target("avx512f")))
+static void CompressSHA256x16(word32* State, const word32* Block)
+{
+    CompressLanes<SHA256Hash, Word32x16>(State, Block);
+}
+
+__attribute__((target("avx2")))
+static void CompressSHA512x4(word64* State, const word64* Block)
+{
+    CompressLanes<SHA512Hash, Word64x4>(State, Block);
+}
+
+__attribute__((target("avx512f")))
+static void CompressSHA512x8(word64* State, const word64* Block)
+{
+    CompressLanes<SHA512Hash, Word64x8>(State, Block);
+}
+
+/// \brief Runs the jobs of a batch in the lanes of one engine
+template <class Hash, uint32_t Lanes>
+class LaneEngine
+{
+public:
+    typedef typename Hash::Word Word;
+    typedef typename Hash::HFCType HFCType;
+    typedef void (*CompressFunction)(Word*, const Word*);
+
+    LaneEngine(const HFCBatch& Batch,
+               const uint8_t* IV,
+               CompressFunction Compress):
+        mBatch(Batch),
+        mIV(IV),
+        mCompress(Compress)
+    {}
+
+    size_t Run()
+    {
+        // The longest messages start first, so the lanes end about together
+        mOrder.resize(mBatch.Count);
+        for (size_t i = 0; i < mBatch.Count; i++)
+        {
+            mOrder[i] = i;
+        }
+        stable_sort(mOrder.begin(), mOrder.end(), [this](size_t a, size_t b)
+        {
+            return mBatch.InputSizes[a] > mBatch.InputSizes[b];
+        });
+        mNext = 0;
+        mActive = 0;
+        mValidCount = 0;
+        for (uint32_t l = 0; l < Lanes; l++)
+        {
+            Refill(l);
+        }
+        Word Block[BLOCKUNITSIZE];
+        Word LaneState[STATEUNITSIZE];
+        while (mActive > 1)
+        {
+            for (uint32_t l = 0; l < Lanes; l++)
+            {
+                // Idle lanes compress their old block, the result is not used
+                if (!mLanes[l].Active)
+                {
+                    continue;
+                }
+                // Only EC and DO xor the state into their output
+                if (mBatch.Mode != IHFCScheme::ChainEVer)
+                {
+                    GetLaneState(l, LaneState);
+                }
+                NextBlock(mLanes[l], LaneState, Block);
+                for (uint32_t j = 0; j < BLOCKUNITSIZE; j++)
+                {
+                    mBlocks[j * Lanes + l] = Block[j];
+                }
+            }
+            mCompress(mState, mBlocks);
+            for (uint32_t l = 0; l < Lanes; l++)
+            {
+                if (mLanes[l].Active && mLanes[l].Phase == PhaseDone)
+                {
+                    GetLaneState(l, LaneState);
+                    Finish(mLanes[l], LaneState);
+                    mActive--;
+                    Refill(l);
+                }
+            }
+        }
+        // The last message runs on alone with the scalar compression
+        for (uint32_t l = 0; l < Lanes && mActive == 1; l++)
+        {
+            if (!mLanes[l].Active)
+            {
+                continue;
+            }
+            GetLaneState(l, LaneState);
+            while (mLanes[l].Phase != PhaseDone)
+            {
+                NextBlock(mLanes[l], LaneState, Block);
+                Hash::Transform(LaneState, Block);
+            }
+            Finish(mLanes[l], LaneState);
+            mActive--;
+        }
+        return mValidCount;
+    }
+
+private:
+    static const uint32_t BLOCKSIZE = Hash::BLOCKSIZE;
+    static const uint32_t STATESIZE = Hash::STATESIZE;
+    static const uint32_t BLOCKUNITSIZE = BLOCKSIZE / sizeof(Word);
+    static const uint32_t STATEUNITSIZE = STATESIZE / sizeof(Word);
+    // The lanes chain the message blocks of the HFC, the header is not in them
+    static_assert(HFCType::cChunkSize == STATESIZE, "The lanes need the message blocks of a HFC of SHA2");
+
+    enum ChainPhase
+    {
+        PhaseKey = 0,
+        PhaseHeader,
+        PhaseMessage,
+        PhaseSuffix,
+        PhaseDone
+    };
+
+    /// \brief Job in one lane and the position in its chain
+    struct Lane
+    {
+        bool Active = false;
+        size_t Index = 0;
+        ChainPhase Phase = PhaseKey;
+        const uint8_t* Key = NULL;
+        const uint8_t* Header = NULL;
+        uint64_t HLength = 0;
+        const uint8_t* Input = NULL;
+        uint64_t Length = 0;
+        uint8_t* Output = NULL;
+        Word MessageSuf[2 * BLOCKUNITSIZE];
+    };
+
+	/// \brief Starts the next job in a lane or marks it idle
+	/// \param l index of the lane
+    void Refill(uint32_t l)
+    {
+        Lane& L = mLanes[l];
+        L.Active = mNext < mBatch.Count;
+        if (!L.Active)
+        {
+            return;
+        }
+        size_t i = mOrder[mNext++];
+        L.Index = i;
+        L.Phase = PhaseKey;
+        L.Key = (const uint8_t*)mBatch.KECs[i].data();
+        L.Header = (const uint8_t*)mBatch.Headers[i];
+        L.HLength = mBatch.HeaderSizes[i];
+        L.Input = (const uint8_t*)mBatch.Inputs[i];
+        L.Length = mBatch.InputSizes[i];
+        L.Output = mBatch.Mode == IHFCScheme::ChainEVer ? NULL : (uint8_t*)mBatch.Outputs[i];
+        // Initialize state with IV
+        Word IV[STATEUNITSIZE];
+        memcpy(IV, mIV, STATESIZE);
+        for (uint32_t j = 0; j < STATEUNITSIZE; j++)
+        {
+            mState[j * Lanes + l] = IV[j];
+        }
+        mActive++;
+    }
+
+	/// \brief Copies the state of one lane
+	/// \param l index of the lane
+	/// \param LaneState outputs the state
+    void GetLaneState(uint32_t l, Word* LaneState)
+    {
+        for (uint32_t j = 0; j < STATEUNITSIZE; j++)
+        {
+            LaneState[j] = mState[j * Lanes + l];
+        }
+    }
+
+	/// \brief Builds the next block of a chain with the block functions of the HFC
+	/// \param L the lane
+	/// \param LaneState the state of the lane before the block
+	/// \param Block outputs the block
+    void NextBlock(Lane& L, const Word* LaneState, Word* Block)
+    {
+        uint8_t* BlockBytes = (uint8_t*)Block;
+        switch (L.Phase)
+        {
+        case PhaseKey:
+            /* V0 <- f(IV, KEC) */
+            memcpy(BlockBytes, L.Key, BLOCKSIZE);
+            L.Phase = PhaseHeader;
+            break;
+        case PhaseHeader:
+            /* Vh <- f+(V0, (KEC xor H1) || ... || (KEC xor Hh)) */
+            if (L.HLength >= BLOCKSIZE)
+            {
+                HFCType::HeaderBlock(L.Key, L.Header, BLOCKSIZE, BlockBytes);
+                L.Header += BLOCKSIZE;
+                L.HLength -= BLOCKSIZE;
+                break;
+            }
+            HFCType::HeaderBlock(L.Key, L.Header, L.HLength, BlockBytes);
+            L.Phase = PhaseMessage;
+            break;
+        case PhaseMessage:
+            if (L.Length > HFCType::cChunkSize)
+            {
+                /* V_h+i <- f(V_h+i-1, (KEC xor M_i')) */
+                HFCType::MessageKeyBlock(L.Key, BlockBytes);
+                MessageBlock(L, LaneState, BlockBytes);
+                L.Input += HFCType::cChunkSize;
+                L.Output += L.Output == NULL ? 0 : HFCType::cChunkSize;
+                L.Length -= HFCType::cChunkSize;
+                break;
+            }
+            SuffixBlocks(L, LaneState);
+            /* B_EC <- f+(V_h+m-1, (K_EC xor M_m') || (K_EC xor M_m+1')) */
+            memcpy(Block, L.MessageSuf, BLOCKSIZE);
+            L.Phase = PhaseSuffix;
+            break;
+        case PhaseSuffix:
+            memcpy(Block, L.MessageSuf + BLOCKUNITSIZE, BLOCKSIZE);
+            L.Phase = PhaseDone;
+            break;
+        default:
+            throw runtime_error("Block after the end of the chain");
+        }
+    }
+
+	/// \brief Builds a full message block of the mode of the batch
+	/// \param L the lane
+	/// \param LaneState the state of the lane before the block
+	/// \param Block outputs the block, the part after the message is set
+    void MessageBlock(Lane& L, const Word* LaneState, uint8_t* Block)
+    {
+        if (mBatch.Mode == IHFCScheme::ChainEC)
+        {
+            HFCType::template MessageBlock<IHFCScheme::ChainEC>(LaneState, L.Key, L.Input, L.Output, Block);
+        }
+        else if (mBatch.Mode == IHFCScheme::ChainDO)
+        {
+            HFCType::template MessageBlock<IHFCScheme::ChainDO>(LaneState, L.Key, L.Input, L.Output, Block);
+        }
+        else
+        {
+            HFCType::template MessageBlock<IHFCScheme::ChainEVer>(LaneState, L.Key, L.Input, NULL, Block);
+        }
+    }
+
+	/// \brief Handles the last message block and builds the suffix blocks of the mode of the batch
+	/// \param L the lane
+	/// \param LaneState the state of the lane before the suffix
+    void SuffixBlocks(Lane& L, const Word* LaneState)
+    {
+        uint64_t HSize = mBatch.HeaderSizes[L.Index];
+        uint64_t MSize = mBatch.InputSizes[L.Index];
+        uint8_t* MessageSuf = (uint8_t*)L.MessageSuf;
+        if (mBatch.Mode == IHFCScheme::ChainEC)
+        {
+            HFCType::template SuffixBlocks<IHFCScheme::ChainEC>(LaneState, L.Key, HSize, MSize, L.Input,
+                                                                L.Output, L.Length, MessageSuf);
+        }
+        else if (mBatch.Mode == IHFCScheme::ChainDO)
+        {
+            HFCType::template SuffixBlocks<IHFCScheme::ChainDO>(LaneState, L.Key, HSize, MSize, L.Input,
+                                                                L.Output, L.Length, MessageSuf);
+        }
+        else
+        {
+            HFCType::template SuffixBlocks<IHFCScheme::ChainEVer>(LaneState, L.Key, HSize, MSize, L.Input,
+                                                                  NULL, L.Length, MessageSuf);
+        }
+    }
+
+	/// \brief Outputs or checks the commitment of a finished job
+	/// \param L the lane
+	/// \param LaneState the state of the lane after the suffix
+    void Finish(Lane& L, const Word* LaneState)
+    {
+        size_t i = L.Index;
+        string BECNew = HFCType::Commitment(LaneState);
+        if (mBatch.Mode == IHFCScheme::ChainEC)
+        {
+            /* Return (C_EC, B_EC), C_EC is already constructed */
+            mBatch.NewBECs[i].assign(BECNew);
+            mValidCount++;
+            return;
+        }
+        /* If B_EC' != B_EC then Return 0 */
+        bool Valid = mBatch.BECs[i].compare(BECNew) == 0;
+        if (!Valid && mBatch.Mode == IHFCScheme::ChainDO)
+        {
+            memset(mBatch.Outputs[i], 0x00, mBatch.InputSizes[i]);
+        }
+        if (mBatch.Valid != NULL)
+        {
+            mBatch.Valid[i] = Valid;
+        }
+        mValidCount += Valid;
+    }
+
+    const HFCBatch& mBatch;
+    const uint8_t* mIV;
+    CompressFunction mCompress;
+    // Word j of every lane behind each other
+    alignas(64) Word mState[STATEUNITSIZE * Lanes] = {0};
+    alignas(64) Word mBlocks[BLOCKUNITSIZE * Lanes] = {0};
+    Lane mLanes[Lanes];
+    vector<size_t> mOrder;
+    size_t mNext = 0;
+    uint32_t mActive = 0;
+    size_t mValidCount = 0;
+};
+
+uint32_t MultiBuffer_HFC::GetSHA256Lanes()
+{
+    static const uint32_t Lanes = __builtin_cpu_supports("avx512f") ? 16 :
+                                  __builtin_cpu_supports("avx2") ? 8 : 0;
+    return Lanes;
+}
+
+uint32_t MultiBuffer_HFC::GetSHA512Lanes()
+{
+    return GetSHA256Lanes() / 2;
+}
+
+size_t MultiBuffer_HFC::SHA256(const HFCBatch& Batch,
+                               const uint8_t* IV,
+                               uint32_t Lanes)
+{
+    if (Lanes > GetSHA256Lanes())
+    {
+        throw runtime_error("The CPU has no " + to_string(Lanes) + " lanes for SHA256");
+    }
+    if (Lanes == 16)
+    {
+        LaneEngine<SHA256Hash, 16> Engine(Batch, IV, CompressSHA256x16);
+        return Engine.Run();
+    }
+    if (Lanes == 8)
+    {
+        LaneEngine<SHA256Hash, 8> Engine(Batch, IV, CompressSHA256x8);
+        return Engine.Run();
+    }
+    throw runtime_error("SHA256 has 8 or 16 lanes, not " + to_string(Lanes));
+}
+
+size_t MultiBuffer_HFC::SHA512(const HFCBatch& Batch,
+                               const uint8_t* IV,
+                               uint32_t Lanes)
+{
+    if (Lanes > GetSHA512Lanes())
+    {
+        throw runtime_error("The CPU has no " + to_string(Lanes) + " lanes for SHA512");
+    }
+    if (Lanes == 8)
+    {
+        LaneEngine<SHA512Hash, 8> Engine(Batch, IV, CompressSHA512x8);
+        return Engine.Run();
+    }
+    if (Lanes == 4)
+    {
+        LaneEngine<SHA512Hash, 4> Engine(Batch, IV, CompressSHA512x4);
+        return Engine.Run();
+    }
+    throw runtime_error("SHA512 has 4 or 8 lanes, not " + to_string(Lanes));
+}
+
+#else
+
+uint32_t MultiBuffer_HFC::GetSHA256Lanes()
+{
+    return 0;
+}
+
+uint32_t MultiBuffer_HFC::GetSHA512Lanes()
+{
+    return 0;
+}
+
+size_t MultiBuffer_HFC::SHA256(const HFCBatch& /* Batch */,
+                               const uint8_t* /* IV */,
+                               uint32_t /* Lanes */)
+{
+    throw runtime_error("The multi-buffer engine is not built for this platform");
+}
+
+size_t MultiBuffer_HFC::SHA512(const HFCBatch& /* Batch */,
+                               const uint8_t* /* IV */,
+                               uint32_t /* Lanes */)
+{
+    throw runtime_error("The multi-buffer engine is not built for this platform");
+}
+
+#endif
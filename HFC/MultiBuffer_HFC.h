@@ -0,0 +1,64 @@
+#ifndef MULTIBUFFER_HFC_H
+#define MULTIBUFFER_HFC_H
+
+#include <cstdint>
+#include <string>
+
+#include "IHFCScheme.h"
+
+/// \brief Independent EC, DO or EVer jobs for the multi-buffer engines
+/// \details Job i uses KECs[i], Headers[i] and Inputs[i], the input is the
+/// message (EC, EVer) or CEC (DO). EC writes Outputs[i] and NewBECs[i],
+/// DO writes Outputs[i] and checks BECs[i], EVer only checks BECs[i]
+struct HFCBatch
+{
+    IHFCScheme::ChainMode Mode;
+    size_t Count;
+    const std::string* KECs;
+    const unsigned char* const* Headers;
+    const size_t* HeaderSizes;
+    const unsigned char* const* Inputs;
+    const size_t* InputSizes;
+    unsigned char* const* Outputs;
+    const std::string* BECs;
+    std::string* NewBECs;
+    bool* Valid;
+};
+
+/// \brief MultiBuffer_HFC class with the multi-buffer engines of SHA256_HFC and SHA512_HFC
+/// \details The chain of one message is sequential, so the engines run the chains
+/// of independent messages in the lanes of the SIMD registers, one word of every
+/// lane per register. SHA256 has 8 lanes with AVX2 and 16 with AVX-512, SHA512
+/// has 4 and 8. The blocks of every lane (key, header, message and suffix) are built
+/// by the block functions of the HFC template, then one compression runs for all
+/// lanes. A lane whose message is finished is refilled with the next one, the longest
+/// messages start first so few lanes idle at the end, and the last message runs on with
+/// SHA256::Transform (SHA512::Transform). The results are the same as the scalar
+/// functions. Only built for x86 with GCC or Clang, the instructions are enabled
+/// per function, so the binary runs on every CPU.
+class MultiBuffer_HFC
+{
+public:
+	/// \brief Returns the lanes of the SHA256 engine, 16 with AVX-512, 8 with AVX2, else 0
+    static uint32_t GetSHA256Lanes();
+	/// \brief Returns the lanes of the SHA512 engine, 8 with AVX-512, 4 with AVX2, else 0
+    static uint32_t GetSHA512Lanes();
+	/// \brief Runs the jobs of SHA256_HFC
+	/// \param Batch the jobs, the jobs have to be checked
+	/// \param IV pointer to the 32 bytes of the IV
+	/// \param Lanes 8 or 16, at most GetSHA256Lanes
+    /// \details Returns the number of valid jobs, for EC all
+    static size_t SHA256(const HFCBatch& Batch,
+                         const uint8_t* IV,
+                         uint32_t Lanes);
+	/// \brief Runs the jobs of SHA512_HFC
+	/// \param Batch the jobs, the jobs have to be checked
+	/// \param IV pointer to the 64 bytes of the IV
+	/// \param Lanes 4 or 8, at most GetSHA512Lanes
+    /// \details Returns the number of valid jobs, for EC all
+    static size_t SHA512(const HFCBatch& Batch,
+                         const uint8_t* IV,
+                         uint32_t Lanes);
+};
+
+#endif
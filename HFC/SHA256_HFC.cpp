@@ -1,241 +1,225 @@
 using namespace std;
 
+#include <algorithm>
+#include <vector>
+
 #include <cryptopp/cryptlib.h>
 #include <cryptopp/misc.h>
 using namespace CryptoPP;
 
 #include "SHA256_HFC.h"
+#include "SHA256_SHANI.h"
+#include "MultiBuffer_HFC.h"
 
-void SHA256_HFC::EC(const string& KEC,
-                    const string& Header,
-                    const unsigned char* Message,
-                    uint32_t MessageSize,
-                    string& CEC,
-                    string& BEC)
+uint64_t SHA256Compression::Chain(word32* State,
+                                  const uint8_t* Key,
+                                  const uint8_t* Input,
+                                  uint8_t* Output,
+                                  uint64_t Blocks,
+                                  IHFCScheme::ChainMode Mode)
 {
-    if (Message == NULL)
+    // SHA extensions kernel for the blocks, the loop of HFC is the fallback
+    if (Blocks == 0 || !SHA256_SHANI::IsAvailable())
     {
-        throw runtime_error("Null pointer for message");
+        return 0;
     }
-    CheckInput(KEC.size());
-    uint32_t BLOCKSIZE = GetBlockSize();
-    uint32_t STATESIZE = GetStateSize();
-    uint32_t BLOCKUNITSIZE = BLOCKSIZE / sizeof(word32);
-    uint32_t STATEUNITSIZE = STATESIZE / sizeof(word32);
-    const unsigned char* KeyPointer = (const unsigned char*)KEC.data();
-    // Initialize state with IV
-    word32 State[STATEUNITSIZE];
-    memcpy(State, mIV.data(), mIV.size());
-    /* V0 <- f(IV, KEC) */
-    SHA256::Transform(State, (word32*)KeyPointer);
-    /* Vh <- f+(V0, (KEC xor H1) || ... || (KEC xor Hh)) */
-    uint8_t XorBuffer[BLOCKSIZE];
-    uint32_t HLength = Header.size();
-    const uint8_t *HPointer = (const uint8_t*)Header.data();
-    while (HLength >= BLOCKSIZE)
+    SHA256_SHANI::Chain(State, Key, Input, Output, Blocks, Mode);
+    return Blocks;
+}
+
+template class HFC<SHA256Compression, 64, 32, word32>;
+
+void SHA256_HFC::ECBatch(size_t Count,
+                         const string* KECs,
+                         const unsigned char* const* Headers,
+                         const size_t* HeaderSizes,
+                         const unsigned char* const* Messages,
+                         const size_t* MessageSizes,
+                         unsigned char* const* CECs,
+                         string* BECs)
+{
+    if (!UseBatchEngine(Count))
     {
-        xorbuf(XorBuffer, HPointer, KeyPointer, BLOCKSIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        HPointer += BLOCKSIZE;
-        HLength -= BLOCKSIZE;
+        IHFCScheme::ECBatch(Count, KECs, Headers, HeaderSizes, Messages, MessageSizes, CECs, BECs);
+        return;
     }
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    xorbuf(XorBuffer, HPointer, HLength);
-    SHA256::Transform(State, (word32*)XorBuffer);
+    HFCBatch Batch = {ChainEC, Count, KECs, Headers, HeaderSizes, Messages, MessageSizes,
+                      CECs, NULL, BECs, NULL};
+    RunBatch(Batch);
+}
 
-    /* C_EC <- e */
-    uint32_t MLength = MessageSize;
-    CEC.resize(MLength);
-    uint8_t *OutputPointer = (uint8_t*)CEC.data();
-    const uint8_t *MPointer = (const uint8_t*)Message;
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    /* For i=1,...,m-1 do */
-    while (MLength > STATESIZE)
+size_t SHA256_HFC::DOBatch(size_t Count,
+                           const string* KECs,
+                           const unsigned char* const* Headers,
+                           const size_t* HeaderSizes,
+                           const unsigned char* const* CECs,
+                           const size_t* CECSizes,
+                           const string* BECs,
+                           unsigned char* const* Messages,
+                           bool* Valid)
+{
+    if (!UseBatchEngine(Count))
     {
-        /* C_EC <- C_EC || (V_h+i-1 xor M_i) */
-        xorbuf(OutputPointer, MPointer, (uint8_t*)State, STATESIZE);
-        /* V_h+i <- f(V_h+i-1, (KEC xor M_i')) */
-        xorbuf(XorBuffer, MPointer, KeyPointer, STATESIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        MPointer += STATESIZE;
-        OutputPointer += STATESIZE;
-        MLength -= STATESIZE;
+        return IHFCScheme::DOBatch(Count, KECs, Headers, HeaderSizes, CECs, CECSizes, BECs, Messages, Valid);
     }
+    HFCBatch Batch = {ChainDO, Count, KECs, Headers, HeaderSizes, CECs, CECSizes,
+                      Messages, BECs, NULL, Valid};
+    return RunBatch(Batch);
+}
 
-    /* C_EC <- C_EC || (V_h+m-1 xor M_m) */
-    xorbuf(OutputPointer, MPointer, (uint8_t*)State, MLength);
-    /* M_m', M_m+1' <- Parse_d(PadSuf(|H|, |M|, M_m)) */
-    word32 MessageSuf[2 * BLOCKUNITSIZE] = {0};
-    memcpy(MessageSuf, MPointer, MLength);
-    uint64_t HSize = Header.size();
-    uint64_t MSize = MessageSize;
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(HSize) - sizeof(MSize)) / sizeof(word32), &HSize, sizeof(HSize));
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(MSize)) / sizeof(word32), &MSize, sizeof(MSize));
-    xorbuf((unsigned char*)MessageSuf, KeyPointer, BLOCKUNITSIZE);
-    xorbuf((unsigned char*)MessageSuf + BLOCKUNITSIZE, KeyPointer, BLOCKUNITSIZE);
-    /* B_EC <- f+(V_h+m-1, (K_EC xor M_m') || (K_EC xor M_m+1')) */
-    SHA256::Transform(State, MessageSuf);
-    SHA256::Transform(State, MessageSuf + BLOCKUNITSIZE);
-    /* Return (C_EC, B_EC), C_EC is already constructed */
-    BEC.assign(State, State + STATEUNITSIZE);
-    return;
+size_t SHA256_HFC::EVerBatch(size_t Count,
+                             const unsigned char* const* Headers,
+                             const size_t* HeaderSizes,
+                             const unsigned char* const* Messages,
+                             const size_t* MessageSizes,
+                             const string* KECs,
+                             const string* BECs,
+                             bool* Valid)
+{
+    if (!UseBatchEngine(Count))
+    {
+        return IHFCScheme::EVerBatch(Count, Headers, HeaderSizes, Messages, MessageSizes, KECs, BECs, Valid);
+    }
+    HFCBatch Batch = {ChainEVer, Count, KECs, Headers, HeaderSizes, Messages, MessageSizes,
+                      NULL, BECs, NULL, Valid};
+    return RunBatch(Batch);
 }
 
-bool SHA256_HFC::DO(const string& KEC,
-                    const string& Header,
-                    const unsigned char* CEC,
-                    uint32_t CECSize,
-                    const string& BEC,
-                    string& Message)
+bool SHA256_HFC::UseBatchEngine(size_t Count)
 {
-    if (CEC == NULL)
+    return Count > 1 && (SHA256_SHANI::IsAvailable() || MultiBuffer_HFC::GetSHA256Lanes() > 0);
+}
+
+size_t SHA256_HFC::RunBatch(const HFCBatch& Batch)
+{
+    // Every job is checked like by EC, DO and EVer before the first one runs
+    for (size_t i = 0; i < Batch.Count; i++)
     {
-        throw runtime_error("Null pointer for CEC");
+        CheckChainInput(Batch.Mode, Batch.KECs[i], Batch.Inputs[i]);
     }
-    CheckInput(KEC.size());
-    uint32_t BLOCKSIZE = GetBlockSize();
-    uint32_t STATESIZE = GetStateSize();
-    uint32_t BLOCKUNITSIZE = BLOCKSIZE / sizeof(word32);
-    uint32_t STATEUNITSIZE = STATESIZE / sizeof(word32);
-    const unsigned char* KeyPointer = (const unsigned char*)KEC.data();
-    // Initialize state with IV
-    word32 State[STATEUNITSIZE];
-    memcpy(State, mIV.data(), mIV.size());
-    /* V0 <- f(IV, KEC) */
-    SHA256::Transform(State, (word32*)KeyPointer);
-    /* Vh <- f+(V0, (KEC xor H1) || ... || (KEC xor Hh)) */
-    uint8_t XorBuffer[BLOCKSIZE];
-    uint32_t HLength = Header.size();
-    const uint8_t *HPointer = (const uint8_t*)Header.data();
-    while (HLength >= BLOCKSIZE)
+    // With the SHA extensions one chain is about as fast as 16 lanes and
+    // two interleaved chains are faster, so the lanes only run without them
+    if (SHA256_SHANI::IsAvailable())
     {
-        xorbuf(XorBuffer, HPointer, KeyPointer, BLOCKSIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        HPointer += BLOCKSIZE;
-        HLength -= BLOCKSIZE;
+        return RunInterleaved(Batch);
     }
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    xorbuf(XorBuffer, HPointer, HLength);
-    SHA256::Transform(State, (word32*)XorBuffer);
+    return MultiBuffer_HFC::SHA256(Batch, (const uint8_t*)mIV.data(), MultiBuffer_HFC::GetSHA256Lanes());
+}
 
-    /* M <- e */
-    uint32_t CLength = CECSize;
-    Message.resize(CLength);
-    uint8_t *OutputPointer = (uint8_t*)Message.data();
-    const uint8_t *CPointer = (const uint8_t*)CEC;
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    /* For i=1,...,m-1 do */
-    while (CLength > STATESIZE)
+size_t SHA256_HFC::RunInterleaved(const HFCBatch& Batch)
+{
+    const uint32_t Ways = SHA256_SHANI::cWays;
+    // The longest messages start first, so few ways idle at the end
+    vector<size_t> Order(Batch.Count);
+    for (size_t i = 0; i < Batch.Count; i++)
     {
-        /* M <- M || (V_h+i-1 xor CEC_i) */
-        xorbuf(OutputPointer, CPointer, (uint8_t*)State, STATESIZE);
-        /* V_h+i <- f(V_h+i-1, (KEC xor M_i')) */
-        xorbuf(XorBuffer, OutputPointer, KeyPointer, STATESIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        CPointer += STATESIZE;
-        OutputPointer += STATESIZE;
-        CLength -= STATESIZE;
+        Order[i] = i;
     }
-
-    /* M <- M || (V_h+m-1 xor CEC_m) */
-    xorbuf(OutputPointer, CPointer, (uint8_t*)State, CLength);
-    /* M_m', M_m+1' <- Parse_d(PadSuf(|H|, |M|, M_m)) */
-    word32 MessageSuf[2 * BLOCKUNITSIZE] = {0};
-    memcpy(MessageSuf, OutputPointer, CLength);
-    uint64_t HSize = Header.size();
-    uint64_t MSize = Message.size();
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(HSize) - sizeof(MSize)) / sizeof(word32), &HSize, sizeof(HSize));
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(MSize)) / sizeof(word32), &MSize, sizeof(MSize));
-    xorbuf((unsigned char*)MessageSuf, KeyPointer, BLOCKUNITSIZE);
-    xorbuf((unsigned char*)MessageSuf + BLOCKUNITSIZE, KeyPointer, BLOCKUNITSIZE);
-    /* B_EC <- f+(V_h+m-1, (K_EC xor M_m') || (K_EC xor M_m+1')) */
-    SHA256::Transform(State, MessageSuf);
-    SHA256::Transform(State, MessageSuf + BLOCKUNITSIZE);
-    /* If B_EC' != B_EC then Return 0 */
-    string BECNew(State, State + STATEUNITSIZE);
-    if (BEC.compare(BECNew))
+    stable_sort(Order.begin(), Order.end(), [&Batch](size_t a, size_t b)
+    {
+        return Batch.InputSizes[a] > Batch.InputSizes[b];
+    });
+    word32 States[Ways][cStateUnits];
+    size_t Jobs[Ways];
+    uint64_t Offsets[Ways];
+    uint64_t Ends[Ways];
+    bool Busy[Ways] = {false};
+    size_t Next = 0;
+    size_t ValidCount = 0;
+    while (true)
     {
-        memset(Message.data(), 0x00, Message.size());
-        return false;
+        uint32_t* ActiveStates[Ways];
+        const uint8_t* ActiveKeys[Ways];
+        const uint8_t* ActiveInputs[Ways];
+        uint8_t* ActiveOutputs[Ways];
+        uint32_t Active = 0;
+        uint64_t Blocks = UINT64_MAX;
+        for (uint32_t w = 0; w < Ways; w++)
+        {
+            word32* State = States[w];
+            // Refill the way, a message without a full block is finished at once
+            while (!Busy[w] && Next < Batch.Count)
+            {
+                Jobs[w] = Order[Next++];
+                size_t Size = Batch.InputSizes[Jobs[w]];
+                ChainHeader(State, (const uint8_t*)Batch.KECs[Jobs[w]].data(),
+                            Batch.Headers[Jobs[w]], Batch.HeaderSizes[Jobs[w]], Size);
+                Offsets[w] = 0;
+                Ends[w] = Size == 0 ? 0 : (Size - 1) / cChunkSize * cChunkSize;
+                Busy[w] = Ends[w] > 0;
+                if (!Busy[w])
+                {
+                    ValidCount += FinishJob(Batch, Jobs[w], State, 0);
+                }
+            }
+            if (!Busy[w])
+            {
+                continue;
+            }
+            ActiveStates[Active] = State;
+            ActiveKeys[Active] = (const uint8_t*)Batch.KECs[Jobs[w]].data();
+            ActiveInputs[Active] = Batch.Inputs[Jobs[w]] + Offsets[w];
+            ActiveOutputs[Active] = Batch.Mode == ChainEVer ? NULL : Batch.Outputs[Jobs[w]] + Offsets[w];
+            Blocks = min(Blocks, (Ends[w] - Offsets[w]) / cChunkSize);
+            Active++;
+        }
+        if (Active == 0)
+        {
+            return ValidCount;
+        }
+        // Until the shortest message of the ways has no full block left
+        SHA256_SHANI::ChainInterleaved(ActiveStates, ActiveKeys, ActiveInputs, ActiveOutputs,
+                                       Blocks, Active, Batch.Mode);
+        for (uint32_t w = 0; w < Ways; w++)
+        {
+            if (!Busy[w])
+            {
+                continue;
+            }
+            Offsets[w] += Blocks * cChunkSize;
+            if (Offsets[w] == Ends[w])
+            {
+                ValidCount += FinishJob(Batch, Jobs[w], States[w], Offsets[w]);
+                Busy[w] = false;
+            }
+        }
     }
-    return true;
 }
 
-bool SHA256_HFC::EVer(const string& Header,
-                      const string& Message,
-                      const string& KEC,
-                      const string& BEC)
+bool SHA256_HFC::FinishJob(const HFCBatch& Batch,
+                           size_t Job,
+                           word32* State,
+                           uint64_t Offset)
 {
-    CheckInput(KEC.size());
-    uint32_t BLOCKSIZE = GetBlockSize();
-    uint32_t STATESIZE = GetStateSize();
-    uint32_t BLOCKUNITSIZE = BLOCKSIZE / sizeof(word32);
-    uint32_t STATEUNITSIZE = STATESIZE / sizeof(word32);
-    const unsigned char* KeyPointer = (const unsigned char*)KEC.data();
-    // Initialize state with IV
-    word32 State[STATEUNITSIZE];
-    memcpy(State, mIV.data(), mIV.size());
-    /* V0 <- f(IV, KEC) */
-    SHA256::Transform(State, (word32*)KeyPointer);
-    /* Vh <- f+(V0, (KEC xor H1) || ... || (KEC xor Hh)) */
-    uint8_t XorBuffer[BLOCKSIZE];
-    uint32_t HLength = Header.size();
-    const uint8_t *HPointer = (const uint8_t*)Header.data();
-    while (HLength >= BLOCKSIZE)
+    const uint8_t* KeyPointer = (const uint8_t*)Batch.KECs[Job].data();
+    uint64_t HeaderSize = Batch.HeaderSizes[Job];
+    uint64_t Size = Batch.InputSizes[Job];
+    const uint8_t* Input = Batch.Inputs[Job] + Offset;
+    if (Batch.Mode == ChainEC)
     {
-        xorbuf(XorBuffer, HPointer, KeyPointer, BLOCKSIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        HPointer += BLOCKSIZE;
-        HLength -= BLOCKSIZE;
+        ChainSuffix<ChainEC>(State, KeyPointer, HeaderSize, Size, Input, Batch.Outputs[Job] + Offset, Size - Offset);
+        /* Return (C_EC, B_EC), C_EC is already written */
+        Batch.NewBECs[Job].assign(Commitment(State));
+        return true;
     }
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    xorbuf(XorBuffer, HPointer, HLength);
-    SHA256::Transform(State, (word32*)XorBuffer);
-
-    /* V_m-1 <- f+(V0, (KEC xor M_1') || ... || (KEC xor M_m-1')) */
-    uint32_t MLength = Message.size();
-    const uint8_t *MPointer = (const uint8_t*)Message.data();
-    memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
-    while (MLength > STATESIZE)
+    if (Batch.Mode == ChainDO)
     {
-        xorbuf(XorBuffer, MPointer, KeyPointer, STATESIZE);
-        SHA256::Transform(State, (word32*)XorBuffer);
-        MPointer += STATESIZE;
-        MLength -= STATESIZE;
+        ChainSuffix<ChainDO>(State, KeyPointer, HeaderSize, Size, Input, Batch.Outputs[Job] + Offset, Size - Offset);
+    }
+    else
+    {
+        ChainSuffix<ChainEVer>(State, KeyPointer, HeaderSize, Size, Input, NULL, Size - Offset);
     }
-
-    /* M_m', M_m+1' <- Parse_d(PadSuf(|H|, |M|, M_m)) */
-    word32 MessageSuf[2 * BLOCKUNITSIZE] = {0};
-    memcpy(MessageSuf, MPointer, MLength);
-    uint64_t HSize = Header.size();
-    uint64_t MSize = Message.size();
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(HSize) - sizeof(MSize)) / sizeof(word32), &HSize, sizeof(HSize));
-    memcpy(MessageSuf + (sizeof(MessageSuf) - sizeof(MSize)) / sizeof(word32), &MSize, sizeof(MSize));
-    xorbuf((unsigned char*)MessageSuf, KeyPointer, BLOCKUNITSIZE);
-    xorbuf((unsigned char*)MessageSuf + BLOCKUNITSIZE, KeyPointer, BLOCKUNITSIZE);
-    /* B_EC <- f+(V_h+m-1, (K_EC xor M_m') || (K_EC xor M_m+1')) */
-    SHA256::Transform(State, MessageSuf);
-    SHA256::Transform(State, MessageSuf + BLOCKUNITSIZE);
     /* If B_EC' != B_EC then Return 0 */
-    string BECNew(State, State + STATEUNITSIZE);
-    if (BEC.compare(BECNew))
+    Batch.Valid[Job] = Batch.BECs[Job] == Commitment(State);
+    if (!Batch.Valid[Job] && Batch.Mode == ChainDO)
     {
-        return false;
+        memset(Batch.Outputs[Job], 0x00, Size);
     }
-    return true;
-}
-
-const string& SHA256_HFC::GetClassDecription()
-{
-    return cClassDescription;
-}
-
-uint32_t SHA256_HFC::GetBlockSize()
-{
-    return 64;
+    return Batch.Valid[Job];
 }
 
-uint32_t SHA256_HFC::GetStateSize()
+IHFCScheme* SHA256_HFC::Clone() const
 {
-    return 32;
+    return new SHA256_HFC();
 }
@@ -5,38 +5,82 @@
 
 #include <cryptopp/sha.h>
 
-#include "IHFCScheme.h" 
+#include "HFC.h"
 
-class SHA256_HFC : public IHFCScheme
+struct HFCBatch;
+
+/// \brief Compression of the HFC of SHA256, the message blocks run on the
+/// SHA extensions kernel if the CPU has them
+struct SHA256Compression : public HFCCompression
+{
+    static std::string Name()
+    {
+        return CryptoPP::SHA256::StaticAlgorithmName();
+    }
+    static void Compress(CryptoPP::word32* State, const uint8_t* Block)
+    {
+        CryptoPP::SHA256::Transform(State, (const CryptoPP::word32*)Block);
+    }
+    static uint64_t Chain(CryptoPP::word32* State,
+                          const uint8_t* Key,
+                          const uint8_t* Input,
+                          uint8_t* Output,
+                          uint64_t Blocks,
+                          IHFCScheme::ChainMode Mode);
+};
+
+extern template class HFC<SHA256Compression, 64, 32, CryptoPP::word32>;
+
+class SHA256_HFC : public HFC<SHA256Compression, 64, 32, CryptoPP::word32>
 {
 public:
-    void EC(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* Message, 
-            uint32_t MessageSize, 
-            std::string& CEC,
-            std::string& BEC);
-    bool DO(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* CEC, 
-            uint32_t CECSize, 
-            const std::string& BEC,
-            std::string& Message);
-    bool EVer(const std::string& Header,
-              const std::string& Message,
-              const std::string& KEC,
-              const std::string& BEC);
-    const std::string& GetClassDecription();
-    uint32_t GetBlockSize();
-    uint32_t GetStateSize();
-
-protected:
-    const std::string mIV = std::string(GetStateSize(), '0');
+    void ECBatch(size_t Count,
+                 const std::string* KECs,
+                 const unsigned char* const* Headers,
+                 const size_t* HeaderSizes,
+                 const unsigned char* const* Messages,
+                 const size_t* MessageSizes,
+                 unsigned char* const* CECs,
+                 std::string* BECs);
+    size_t DOBatch(size_t Count,
+                   const std::string* KECs,
+                   const unsigned char* const* Headers,
+                   const size_t* HeaderSizes,
+                   const unsigned char* const* CECs,
+                   const size_t* CECSizes,
+                   const std::string* BECs,
+                   unsigned char* const* Messages,
+                   bool* Valid);
+    size_t EVerBatch(size_t Count,
+                     const unsigned char* const* Headers,
+                     const size_t* HeaderSizes,
+                     const unsigned char* const* Messages,
+                     const size_t* MessageSizes,
+                     const std::string* KECs,
+                     const std::string* BECs,
+                     bool* Valid);
+    IHFCScheme* Clone() const;
 
 private:
-    const std::string cClassDescription = "HFC[" +
-                                          std::string(CryptoPP::SHA256::StaticAlgorithmName()) +
-                                          "]";
-
+	/// \brief Returns true if a batch of Count messages runs on a batch engine
+	/// \param Count number of messages of the batch
+    bool UseBatchEngine(size_t Count);
+	/// \brief Checks every job and runs a batch on the interleaved SHA extensions
+	/// kernel or on the multi-buffer engine
+	/// \param Batch the jobs of the batch
+    size_t RunBatch(const HFCBatch& Batch);
+	/// \brief Runs a batch with SHA256_SHANI::cWays chains interleaved, the longest
+	/// messages first, a way is refilled when its message is finished
+	/// \param Batch the jobs of the batch
+    size_t RunInterleaved(const HFCBatch& Batch);
+	/// \brief Chains the last block and the suffix of a job and writes or checks BEC
+	/// \param Batch the jobs of the batch
+	/// \param Job index of the job
+	/// \param State the state after the full blocks of the job
+	/// \param Offset size of the full blocks of the job
+    bool FinishJob(const HFCBatch& Batch,
+                   size_t Job,
+                   CryptoPP::word32* State,
+                   uint64_t Offset);
 };
 #endif
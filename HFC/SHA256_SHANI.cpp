@@ -0,0 +1,239 @@
+#include <stdexcept>
+#include <string>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SHA256_SHANI_KERNEL
+#endif
+using namespace std;
+
+#ifdef SHA256_SHANI_KERNEL
+#include <cryptopp/cpu.h>
+using namespace CryptoPP;
+#endif
+
+#include "SHA256_SHANI.h"
+
+#ifdef SHA256_SHANI_KERNEL
+
+// Round constants of SHA256
+alignas(16) static const uint32_t cRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/// \brief Compresses one block of every chain into its state in the ABEF and CDGH layout of the SHA instructions
+/// \details SHA256::Transform takes the message words in the byte order of the CPU,
+/// so the words are used as they are loaded, without a byte swap. The rounds of
+/// the chains are interleaved, so the SHA unit works on one chain while the
+/// result of the last instruction of the other ones is not ready yet
+template <uint32_t Ways>
+__attribute__((target("sha,sse4.1"), always_inline))
+static inline void Compress(__m128i* ABEF, __m128i* CDGH,
+                            __m128i* W0, __m128i* W1, __m128i* W2, __m128i* W3)
+{
+    __m128i SavedABEF[Ways];
+    __m128i SavedCDGH[Ways];
+#pragma GCC unroll 4
+    for (uint32_t w = 0; w < Ways; w++)
+    {
+        SavedABEF[w] = ABEF[w];
+        SavedCDGH[w] = CDGH[w];
+    }
+#pragma GCC unroll 16
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        const __m128i RoundConstants = _mm_load_si128((const __m128i*)(cRoundConstants + 4 * i));
+#pragma GCC unroll 4
+        for (uint32_t w = 0; w < Ways; w++)
+        {
+            // Four rounds, two per instruction
+            __m128i Message = _mm_add_epi32(W0[w], RoundConstants);
+            CDGH[w] = _mm_sha256rnds2_epu32(CDGH[w], ABEF[w], Message);
+            ABEF[w] = _mm_sha256rnds2_epu32(ABEF[w], CDGH[w], _mm_shuffle_epi32(Message, 0x0E));
+            // W[i+16] = s1(W[i+14]) + W[i+9] + s0(W[i+1]) + W[i], up to W[63]
+            __m128i Next = W3[w];
+            if (i < 12)
+            {
+                Next = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(W0[w], W1[w]),
+                                                          _mm_alignr_epi8(W3[w], W2[w], 4)), W3[w]);
+            }
+            W0[w] = W1[w];
+            W1[w] = W2[w];
+            W2[w] = W3[w];
+            W3[w] = Next;
+        }
+    }
+#pragma GCC unroll 4
+    for (uint32_t w = 0; w < Ways; w++)
+    {
+        ABEF[w] = _mm_add_epi32(ABEF[w], SavedABEF[w]);
+        CDGH[w] = _mm_add_epi32(CDGH[w], SavedCDGH[w]);
+    }
+}
+
+/// \brief Returns the first and the second half of the state in the layout of SHA256::Transform
+__attribute__((target("sha,sse4.1")))
+static inline void Unpack(__m128i ABEF, __m128i CDGH, __m128i& Low, __m128i& High)
+{
+    __m128i FEBA = _mm_shuffle_epi32(ABEF, 0x1B);
+    __m128i DCHG = _mm_shuffle_epi32(CDGH, 0xB1);
+    Low = _mm_blend_epi16(FEBA, DCHG, 0xF0);
+    High = _mm_alignr_epi8(DCHG, FEBA, 8);
+}
+
+/// \brief Chains the same number of blocks of Ways independent chains
+template <uint32_t Ways>
+__attribute__((target("sha,sse4.1")))
+static void ChainKernel(uint32_t* const* States,
+                        const uint8_t* const* Keys,
+                        const uint8_t* const* Inputs,
+                        uint8_t* const* Outputs,
+                        uint64_t Blocks,
+                        IHFCScheme::ChainMode Mode)
+{
+    __m128i ABEF[Ways], CDGH[Ways];
+    __m128i Key0[Ways], Key1[Ways], Key2[Ways], Key3[Ways];
+    const uint8_t* Input[Ways];
+    uint8_t* Output[Ways];
+#pragma GCC unroll 4
+    for (uint32_t w = 0; w < Ways; w++)
+    {
+        // State from ABCD and EFGH to ABEF and CDGH
+        __m128i CDAB = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)States[w]), 0xB1);
+        __m128i HGFE = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(States[w] + 4)), 0x1B);
+        ABEF[w] = _mm_alignr_epi8(CDAB, HGFE, 8);
+        CDGH[w] = _mm_blend_epi16(HGFE, CDAB, 0xF0);
+        // The first half of K_EC is xored into the block, the second half is the
+        // second half of every block
+        Key0[w] = _mm_loadu_si128((const __m128i*)Keys[w]);
+        Key1[w] = _mm_loadu_si128((const __m128i*)(Keys[w] + 16));
+        Key2[w] = _mm_loadu_si128((const __m128i*)(Keys[w] + 32));
+        Key3[w] = _mm_loadu_si128((const __m128i*)(Keys[w] + 48));
+        Input[w] = Inputs[w];
+        Output[w] = Mode == IHFCScheme::ChainEVer ? NULL : Outputs[w];
+    }
+    for (uint64_t i = 0; i < Blocks; i++)
+    {
+        __m128i W0[Ways], W1[Ways], W2[Ways], W3[Ways];
+#pragma GCC unroll 4
+        for (uint32_t w = 0; w < Ways; w++)
+        {
+            __m128i Input0 = _mm_loadu_si128((const __m128i*)Input[w]);
+            __m128i Input1 = _mm_loadu_si128((const __m128i*)(Input[w] + 16));
+            __m128i Absorb0 = Input0;
+            __m128i Absorb1 = Input1;
+            if (Mode != IHFCScheme::ChainEVer)
+            {
+                /* C_EC <- C_EC || (V_h+i-1 xor M_i) or M <- M || (V_h+i-1 xor CEC_i) */
+                __m128i Low, High;
+                Unpack(ABEF[w], CDGH[w], Low, High);
+                __m128i Output0 = _mm_xor_si128(Input0, Low);
+                __m128i Output1 = _mm_xor_si128(Input1, High);
+                _mm_storeu_si128((__m128i*)Output[w], Output0);
+                _mm_storeu_si128((__m128i*)(Output[w] + 16), Output1);
+                if (Mode == IHFCScheme::ChainDO)
+                {
+                    Absorb0 = Output0;
+                    Absorb1 = Output1;
+                }
+                Output[w] += 32;
+            }
+            /* V_h+i <- f(V_h+i-1, (KEC xor M_i')) */
+            W0[w] = _mm_xor_si128(Absorb0, Key0[w]);
+            W1[w] = _mm_xor_si128(Absorb1, Key1[w]);
+            W2[w] = Key2[w];
+            W3[w] = Key3[w];
+            Input[w] += 32;
+        }
+        Compress<Ways>(ABEF, CDGH, W0, W1, W2, W3);
+    }
+#pragma GCC unroll 4
+    for (uint32_t w = 0; w < Ways; w++)
+    {
+        // State from ABEF and CDGH back to ABCD and EFGH
+        __m128i Low, High;
+        Unpack(ABEF[w], CDGH[w], Low, High);
+        _mm_storeu_si128((__m128i*)States[w], Low);
+        _mm_storeu_si128((__m128i*)(States[w] + 4), High);
+    }
+}
+
+bool SHA256_SHANI::IsAvailable()
+{
+    static const bool Available = HasSHA() && HasSSE41();
+    return Available;
+}
+
+void SHA256_SHANI::Chain(uint32_t* State,
+                         const uint8_t* Key,
+                         const uint8_t* Input,
+                         uint8_t* Output,
+                         uint64_t Blocks,
+                         IHFCScheme::ChainMode Mode)
+{
+    ChainKernel<1>(&State, &Key, &Input, &Output, Blocks, Mode);
+}
+
+void SHA256_SHANI::ChainInterleaved(uint32_t* const* States,
+                                    const uint8_t* const* Keys,
+                                    const uint8_t* const* Inputs,
+                                    uint8_t* const* Outputs,
+                                    uint64_t Blocks,
+                                    uint32_t Ways,
+                                    IHFCScheme::ChainMode Mode)
+{
+    switch (Ways)
+    {
+    case 1:
+        ChainKernel<1>(States, Keys, Inputs, Outputs, Blocks, Mode);
+        break;
+    case 2:
+        ChainKernel<2>(States, Keys, Inputs, Outputs, Blocks, Mode);
+        break;
+    case 3:
+        ChainKernel<3>(States, Keys, Inputs, Outputs, Blocks, Mode);
+        break;
+    case 4:
+        ChainKernel<4>(States, Keys, Inputs, Outputs, Blocks, Mode);
+        break;
+    default:
+        throw runtime_error("The SHA extensions kernel interleaves 1 to " + to_string(cMaxWays) +
+                            " chains, not " + to_string(Ways));
+    }
+}
+
+#else
+
+bool SHA256_SHANI::IsAvailable()
+{
+    return false;
+}
+
+void SHA256_SHANI::Chain(uint32_t* /* State */,
+                         const uint8_t* /* Key */,
+                         const uint8_t* /* Input */,
+                         uint8_t* /* Output */,
+                         uint64_t /* Blocks */,
+                         IHFCScheme::ChainMode /* Mode */)
+{
+    throw runtime_error("The SHA extensions kernel is not built for this platform");
+}
+
+void SHA256_SHANI::ChainInterleaved(uint32_t* const* /* States */,
+                                    const uint8_t* const* /* Keys */,
+                                    const uint8_t* const* /* Inputs */,
+                                    uint8_t* const* /* Outputs */,
+                                    uint64_t /* Blocks */,
+                                    uint32_t /* Ways */,
+                                    IHFCScheme::ChainMode /* Mode */)
+{
+    throw runtime_error("The SHA extensions kernel is not built for this platform");
+}
+
+#endif
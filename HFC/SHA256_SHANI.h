@@ -0,0 +1,57 @@
+#ifndef SHA256_SHANI_H
+#define SHA256_SHANI_H
+
+#include <cstdint>
+
+#include "IHFCScheme.h"
+
+/// \brief SHA256_SHANI class with the SHA extensions kernel for the chain of the SHA256 HFCs
+/// \details A block of the chain is the 32 byte message block xor the first half of
+/// K_EC followed by the second half of K_EC, so the second half of the message schedule
+/// is the same for every block. The kernel keeps the state and the key in XMM registers
+/// for all blocks, xors the key into the message words when they are loaded and writes
+/// CEC (EC) or the message (DO) from the state in the registers. The result is the same
+/// as the loop with xorbuf and SHA256::Transform. Only built for x86 with GCC or Clang,
+/// the SHA instructions are enabled per function, so the binary runs on every CPU.
+class SHA256_SHANI
+{
+public:
+	/// \brief Returns true if the CPU has the SHA extensions and SSE4.1
+    static bool IsAvailable();
+	/// \brief Chains full blocks, needs IsAvailable
+	/// \param State the SHA256 state, updated after the last block
+	/// \param Key pointer to the 64 bytes of K_EC
+	/// \param Input pointer to the message (EC, EVer) or to CEC (DO)
+	/// \param Output outputs CEC (EC) or the message (DO), not used by EVer, can be Input
+	/// \param Blocks number of 32 byte blocks
+	/// \param Mode function of the chain
+    static void Chain(uint32_t* State,
+                      const uint8_t* Key,
+                      const uint8_t* Input,
+                      uint8_t* Output,
+                      uint64_t Blocks,
+                      IHFCScheme::ChainMode Mode);
+	/// \brief Chains full blocks of independent chains with interleaved rounds, needs IsAvailable
+	/// \param States the SHA256 state of every chain, updated after the last block
+	/// \param Keys pointer to the 64 bytes of K_EC of every chain
+	/// \param Inputs pointer to the message (EC, EVer) or to CEC (DO) of every chain
+	/// \param Outputs outputs CEC (EC) or the message (DO) of every chain, not used by EVer
+	/// \param Blocks number of 32 byte blocks of every chain
+	/// \param Ways number of chains, 1 to cMaxWays
+	/// \param Mode function of the chains
+    /// \details One chain waits for the latency of every SHA instruction, the
+    ///          rounds of the other chains fill the pipeline of the SHA unit meanwhile
+    static void ChainInterleaved(uint32_t* const* States,
+                                 const uint8_t* const* Keys,
+                                 const uint8_t* const* Inputs,
+                                 uint8_t* const* Outputs,
+                                 uint64_t Blocks,
+                                 uint32_t Ways,
+                                 IHFCScheme::ChainMode Mode);
+
+    static const uint32_t cMaxWays = 4;
+    // Two chains fill the SHA unit, more ones only spill the XMM registers
+    static const uint32_t cWays = 2;
+};
+
+#endif
@@ -5,38 +5,32 @@
 
 #include <cryptopp/keccak.h>
 
-#include "IHFCScheme.h" 
+#include "HFC.h"
 
-class SHA3_HFC : public IHFCScheme
-{
-public:
-    void EC(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* Message, 
-            uint32_t MessageSize, 
-            std::string& CEC,
-            std::string& BEC);
-    bool DO(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* CEC, 
-            uint32_t CECSize, 
-            const std::string& BEC,
-            std::string& Message);
-    bool EVer(const std::string& Header,
-              const std::string& Message,
-              const std::string& KEC,
-              const std::string& BEC);
-    const std::string& GetClassDecription();
-    uint32_t GetBlockSize();
-    uint32_t GetStateSize();
+NAMESPACE_BEGIN(CryptoPP)
+// The Keccak core function
+extern void KeccakF1600(word64 *state);
+NAMESPACE_END
 
-protected:
-    const std::string mIV = std::string(GetStateSize(), '0');
+/// \brief Compression of the HFC of the Keccak sponge, a block is xored into
+/// the rate of the state and the state is permuted
+/// \tparam Rate size of a block in bytes, 136 for SHA3-256
+template <uint32_t Rate>
+struct KeccakCompression : public HFCCompression
+{
+    static const bool cSponge = true;
+    static std::string Name()
+    {
+        return "SHA3_Keccak" + std::to_string((1600 - Rate * 8) / 2);
+    }
+    static void Compress(CryptoPP::word64* State, const uint8_t* Block)
+    {
+        CryptoPP::xorbuf((uint8_t*)State, Block, Rate);
+        CryptoPP::KeccakF1600(State);
+    }
+};
 
-private:
-    const std::string cClassDescription = std::string("HFC[") +
-                                          "SHA3_Keccak" + std::to_string((1600-GetBlockSize()*8)/2) +
-                                          "]";
+extern template class HFC<KeccakCompression<136>, 136, 200, CryptoPP::word64>;
 
-};
+typedef HFC<KeccakCompression<136>, 136, 200, CryptoPP::word64> SHA3_HFC;
 #endif
@@ -5,38 +5,61 @@
 
 #include <cryptopp/sha.h>
 
-#include "IHFCScheme.h" 
+#include "HFC.h"
 
-class SHA512_HFC : public IHFCScheme
+struct HFCBatch;
+
+/// \brief Compression of the HFC of SHA512
+struct SHA512Compression : public HFCCompression
+{
+    static std::string Name()
+    {
+        return CryptoPP::SHA512::StaticAlgorithmName();
+    }
+    static void Compress(CryptoPP::word64* State, const uint8_t* Block)
+    {
+        CryptoPP::SHA512::Transform(State, (const CryptoPP::word64*)Block);
+    }
+};
+
+extern template class HFC<SHA512Compression, 128, 64, CryptoPP::word64>;
+
+class SHA512_HFC : public HFC<SHA512Compression, 128, 64, CryptoPP::word64>
 {
 public:
-    void EC(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* Message, 
-            uint32_t MessageSize, 
-            std::string& CEC,
-            std::string& BEC);
-    bool DO(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* CEC, 
-            uint32_t CECSize, 
-            const std::string& BEC,
-            std::string& Message);
-    bool EVer(const std::string& Header,
-              const std::string& Message,
-              const std::string& KEC,
-              const std::string& BEC);
-    const std::string& GetClassDecription();
-    uint32_t GetBlockSize();
-    uint32_t GetStateSize();
-
-protected:
-    const std::string mIV = std::string(GetStateSize(), '0');
+    void ECBatch(size_t Count,
+                 const std::string* KECs,
+                 const unsigned char* const* Headers,
+                 const size_t* HeaderSizes,
+                 const unsigned char* const* Messages,
+                 const size_t* MessageSizes,
+                 unsigned char* const* CECs,
+                 std::string* BECs);
+    size_t DOBatch(size_t Count,
+                   const std::string* KECs,
+                   const unsigned char* const* Headers,
+                   const size_t* HeaderSizes,
+                   const unsigned char* const* CECs,
+                   const size_t* CECSizes,
+                   const std::string* BECs,
+                   unsigned char* const* Messages,
+                   bool* Valid);
+    size_t EVerBatch(size_t Count,
+                     const unsigned char* const* Headers,
+                     const size_t* HeaderSizes,
+                     const unsigned char* const* Messages,
+                     const size_t* MessageSizes,
+                     const std::string* KECs,
+                     const std::string* BECs,
+                     bool* Valid);
+    IHFCScheme* Clone() const;
 
 private:
-    const std::string cClassDescription = "HFC[" +
-                                          std::string(CryptoPP::SHA512::StaticAlgorithmName()) +
-                                          "]";
-
+	/// \brief Returns true if a batch of Count messages runs on the multi-buffer engine
+	/// \param Count number of messages of the batch
+    bool UseMultiBuffer(size_t Count);
+	/// \brief Checks every job and runs a batch on the multi-buffer engine
+	/// \param Batch the jobs of the batch
+    size_t RunBatch(const HFCBatch& Batch);
 };
 #endif
@@ -5,38 +5,22 @@
 
 #include <cryptopp/whrlpool.h>
 
-#include "IHFCScheme.h" 
+#include "HFC.h"
 
-class Whrlpool_HFC : public IHFCScheme
+/// \brief Compression of the HFC of Whirlpool
+struct WhirlpoolCompression : public HFCCompression
 {
-public:
-    void EC(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* Message, 
-            uint32_t MessageSize, 
-            std::string& CEC,
-            std::string& BEC);
-    bool DO(const std::string& KEC,
-            const std::string& Header,
-            const unsigned char* CEC, 
-            uint32_t CECSize, 
-            const std::string& BEC,
-            std::string& Message);
-    bool EVer(const std::string& Header,
-              const std::string& Message,
-              const std::string& KEC,
-              const std::string& BEC);
-    const std::string& GetClassDecription();
-    uint32_t GetBlockSize();
-    uint32_t GetStateSize();
-
-protected:
-    const std::string mIV = std::string(GetStateSize(), '0');
+    static std::string Name()
+    {
+        return CryptoPP::Whirlpool::StaticAlgorithmName();
+    }
+    static void Compress(CryptoPP::word64* State, const uint8_t* Block)
+    {
+        CryptoPP::Whirlpool::Transform(State, (const CryptoPP::word64*)Block);
+    }
+};
 
-private:
-   const std::string cClassDescription = "HFC[" +
-                                         std::string(CryptoPP::Whirlpool::StaticAlgorithmName()) +
-                                         "]";
+extern template class HFC<WhirlpoolCompression, 64, 64, CryptoPP::word64>;
 
-};
+typedef HFC<WhirlpoolCompression, 64, 64, CryptoPP::word64> Whrlpool_HFC;
 #endif
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <limits>
+using namespace std;
+
+#include "Histogram.h"
+
+Histogram::Histogram():
+    mCounts(cBucketCount, 0),
+    mCount(0),
+    mMin(numeric_limits<uint64_t>::max()),
+    mMax(0),
+    mMean(0.0),
+    mM2(0.0)
+{}
+
+void Histogram::Merge(const Histogram& Other)
+{
+    if (Other.mCount == 0)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < cBucketCount; i++)
+    {
+        mCounts[i] += Other.mCounts[i];
+    }
+    mMin = min(mMin, Other.mMin);
+    mMax = max(mMax, Other.mMax);
+    // Combine mean and variance of both sample sets (Chan et al.)
+    uint64_t Count = mCount + Other.mCount;
+    double Delta = Other.mMean - mMean;
+    mM2 += Other.mM2 + Delta * Delta * ((double)mCount * Other.mCount / Count);
+    mMean += Delta * ((double)Other.mCount / Count);
+    mCount = Count;
+}
+
+void Histogram::Reset()
+{
+    fill(mCounts.begin(), mCounts.end(), 0);
+    mCount = 0;
+    mMin = numeric_limits<uint64_t>::max();
+    mMax = 0;
+    mMean = 0.0;
+    mM2 = 0.0;
+}
+
+uint64_t Histogram::GetPercentile(double Percentile) const
+{
+    if (mCount == 0)
+    {
+        return 0;
+    }
+    // Rank of the sample we are looking for, at least the first one
+    uint64_t Rank = (uint64_t)ceil(Percentile / 100.0 * mCount);
+    return GetValueAtRank(Rank);
+}
+
+uint64_t Histogram::GetValueAtRank(uint64_t Rank) const
+{
+    if (mCount == 0)
+    {
+        return 0;
+    }
+    if (Rank == 0)
+    {
+        Rank = 1;
+    }
+    uint64_t Seen = 0;
+    for (uint32_t i = 0; i < cBucketCount; i++)
+    {
+        Seen += mCounts[i];
+        if (Seen >= Rank)
+        {
+            return min(BucketUpperBound(i), mMax);
+        }
+    }
+    return mMax;
+}
+
+void Histogram::GetMedianInterval(uint64_t& Lower, uint64_t& Upper) const
+{
+    // Ranks of the order statistics which enclose the median with 95%
+    double HalfWidth = 1.96 * sqrt((double)mCount) / 2.0;
+    double LowerRank = floor(mCount / 2.0 - HalfWidth);
+    double UpperRank = ceil(mCount / 2.0 + HalfWidth) + 1;
+    Lower = LowerRank < 1 ? GetMin() : GetValueAtRank((uint64_t)LowerRank);
+    Upper = UpperRank > mCount ? GetMax() : GetValueAtRank((uint64_t)UpperRank);
+}
+
+uint64_t Histogram::GetCount() const
+{
+    return mCount;
+}
+
+uint64_t Histogram::GetMin() const
+{
+    return mCount == 0 ? 0 : mMin;
+}
+
+uint64_t Histogram::GetMax() const
+{
+    return mMax;
+}
+
+double Histogram::GetMean() const
+{
+    return mMean;
+}
+
+double Histogram::GetStandardDeviation() const
+{
+    if (mCount < 2)
+    {
+        return 0.0;
+    }
+    return sqrt(mM2 / (mCount - 1));
+}
+
+uint64_t Histogram::BucketUpperBound(uint32_t Index)
+{
+    if (Index < (2u << cSubBucketBits))
+    {
+        return Index;
+    }
+    // Index = Shift * 2^SubBucketBits + Mantissa with Mantissa in [2^SubBucketBits, 2^(SubBucketBits + 1))
+    uint32_t Shift = (Index >> cSubBucketBits) - 1;
+    uint64_t Mantissa = (Index & ((1u << cSubBucketBits) - 1)) + (1u << cSubBucketBits);
+    return ((Mantissa + 1) << Shift) - 1;
+}
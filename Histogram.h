@@ -0,0 +1,96 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/// \brief Histogram class which records latency samples with a low overhead
+/// \details The buckets are log-linear: values below 2^(cSubBucketBits + 1) get
+/// their own bucket, above that every power of two is split into 2^cSubBucketBits
+/// buckets. So recording is a shift and an increment and the relative error
+/// of a percentile stays below 1%.
+class Histogram
+{
+public:
+	/// \brief Construct an empty Histogram
+    Histogram();
+	/// \brief Destruct a Histogram
+    ~Histogram() {}
+    /// \brief Records one sample
+	/// \param Value the sample, e.g. nanoseconds of one iteration
+    void Record(uint64_t Value)
+    {
+        mCounts[BucketIndex(Value)]++;
+        if (Value < mMin)
+        {
+            mMin = Value;
+        }
+        if (Value > mMax)
+        {
+            mMax = Value;
+        }
+        // Welford's online algorithm for mean and variance
+        mCount++;
+        double Delta = (double)Value - mMean;
+        mMean += Delta / mCount;
+        mM2 += Delta * ((double)Value - mMean);
+    }
+    /// \brief Adds the samples of another histogram to this one
+	/// \param Other histogram to add
+    void Merge(const Histogram& Other);
+    /// \brief Removes all samples
+    void Reset();
+    /// \brief Returns the value below which the given percentage of samples lies
+	/// \param Percentile percentage between 0 and 100
+    /// \details Returns the upper bound of the found bucket, but never more than
+    /// the largest recorded sample
+    uint64_t GetPercentile(double Percentile) const;
+    /// \brief Returns the sample with the given rank in sorted order
+	/// \param Rank rank of the sample, starting with 1
+    /// \details Returns the upper bound of the found bucket, but never more than
+    /// the largest recorded sample
+    uint64_t GetValueAtRank(uint64_t Rank) const;
+    /// \brief Returns the 95% confidence interval of the median
+	/// \param Lower reference outputs the lower bound
+	/// \param Upper reference outputs the upper bound
+    /// \details Distribution free interval from the order statistics,
+    /// the ranks are n/2 -+ 1.96 * sqrt(n)/2
+    void GetMedianInterval(uint64_t& Lower, uint64_t& Upper) const;
+    /// \brief Returns the number of recorded samples
+    uint64_t GetCount() const;
+    /// \brief Returns the smallest recorded sample
+    uint64_t GetMin() const;
+    /// \brief Returns the largest recorded sample
+    uint64_t GetMax() const;
+    /// \brief Returns the mean of the recorded samples
+    double GetMean() const;
+    /// \brief Returns the sample standard deviation of the recorded samples
+    double GetStandardDeviation() const;
+
+private:
+    /// \brief Returns the index of the bucket for a value
+	/// \param Value the value to look up
+    static uint32_t BucketIndex(uint64_t Value)
+    {
+        if (Value < (2ull << cSubBucketBits))
+        {
+            return (uint32_t)Value;
+        }
+        uint32_t Shift = 63 - __builtin_clzll(Value) - cSubBucketBits;
+        return (Shift << cSubBucketBits) + (uint32_t)(Value >> Shift);
+    }
+    /// \brief Returns the largest value that falls into a bucket
+	/// \param Index index of the bucket
+    static uint64_t BucketUpperBound(uint32_t Index);
+
+    static const uint32_t cSubBucketBits = 7;
+    static const uint32_t cBucketCount = (64 - cSubBucketBits + 1) << cSubBucketBits;
+    std::vector<uint64_t> mCounts;
+    uint64_t mCount;
+    uint64_t mMin;
+    uint64_t mMax;
+    double mMean;
+    double mM2;
+};
+#endif
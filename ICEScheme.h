@@ -3,7 +3,8 @@
 
 #include <string>
 
-#include <cryptopp/osrng.h>
+#include "Random.h"
+#include "RandomBuffer.h"
 
 /// \brief Interface for a CE scheme
 /// \details Gets implemented by the schemes to test,
@@ -21,44 +22,434 @@ public:
 	/// \brief Key generation of the scheme
     std::string Kg()
     {
-        CryptoPP::AutoSeededRandomPool Rnd;
-        string Key(GetKeySize(), '0');
-        Rnd.GenerateBlock((unsigned char*)Key.data(), Key.size());
-        return Key;
+        return RandomGenerator::Generate(GetKeySize());
     }
-    /// \brief Encryptes the message with a header
+    /// \brief Encrypts the message with a header
 	/// \param Key for the encryption
 	/// \param Header for the encryption
 	/// \param Message for the encryption
 	/// \param C1 reference outputs the cipher for the message
 	/// \param C2 reference outputs the commitment
-    virtual void Enc(const std::string& Key,
-                     const std::string& Header,
-                     const std::string& Message,
-                     std::string& C1,
-                     std::string& C2) = 0;
-    /// \brief Decryptes the C1 and C2 with the Header
+    void Enc(const std::string& Key,
+             const std::string& Header,
+             const std::string& Message,
+             std::string& C1,
+             std::string& C2)
+    {
+        C1.resize(GetCiphertextSize(Header.size(), Message.size()));
+        C2.resize(GetCommitmentSize());
+        size_t C1Length = C1.size();
+        size_t C2Length = C2.size();
+        Enc(Key, (const unsigned char*)Header.data(), Header.size(),
+            (const unsigned char*)Message.data(), Message.size(),
+            (unsigned char*)C1.data(), C1Length, (unsigned char*)C2.data(), C2Length);
+        C1.resize(C1Length);
+        C2.resize(C2Length);
+    }
+    /// \brief Decrypts the C1 and C2 with the Header
 	/// \param Key for the decryption 
 	/// \param Header for the decryption 
 	/// \param C1 the cipher for the message
 	/// \param C2 the commitment
 	/// \param Message outputs the decrypted message
 	/// \param Keyf outputs the opening key for verification
-    virtual bool Dec(const std::string& Key,
-                     const std::string& Header,
-                     const std::string& C1,
-                     const std::string& C2,
-                     std::string& Message,
-                     std::string& Keyf) = 0;
+    bool Dec(const std::string& Key,
+             const std::string& Header,
+             const std::string& C1,
+             const std::string& C2,
+             std::string& Message,
+             std::string& Keyf)
+    {
+        Message.resize(GetMaxPlaintextSize(C1.size()));
+        size_t MessageLength = Message.size();
+        bool Success = Dec(Key, (const unsigned char*)Header.data(), Header.size(),
+                           (const unsigned char*)C1.data(), C1.size(),
+                           (const unsigned char*)C2.data(), C2.size(),
+                           (unsigned char*)Message.data(), MessageLength, Keyf);
+        Message.resize(MessageLength);
+        return Success;
+    }
     /// \brief Verifies the Header and Message for a commitment
 	/// \param Header for the verification
 	/// \param Message for the verification
 	/// \param Keyf opening key for the verification
 	/// \param C2 the commitment to verify
-    virtual bool Ver(const std::string& Header,
-                     const std::string& Message,
+    bool Ver(const std::string& Header,
+             const std::string& Message,
+             const std::string& Keyf,
+             const std::string& C2)
+    {
+        return Ver((const unsigned char*)Header.data(), Header.size(),
+                   (const unsigned char*)Message.data(), Message.size(),
+                   Keyf, (const unsigned char*)C2.data(), C2.size());
+    }
+    /// \brief Encrypts the message with a header into caller buffers
+	/// \param Key for the encryption
+	/// \param Header pointer to the header for the encryption
+	/// \param HeaderLength length of the header
+	/// \param Message pointer to the message for the encryption
+	/// \param MessageLength length of the message
+	/// \param C1 outputs the cipher for the message
+	/// \param C1Length capacity of C1, outputs the written length
+	/// \param C2 outputs the commitment
+	/// \param C2Length capacity of C2, outputs the written length
+    /// \details Nothing is copied or allocated for the message and the
+    ///          cipher. C1 needs GetCiphertextSize and C2 GetCommitmentSize
+    ///          bytes, otherwise a runtime_error is thrown
+    virtual void Enc(const std::string& Key,
+                     const unsigned char* Header,
+                     size_t HeaderLength,
+                     const unsigned char* Message,
+                     size_t MessageLength,
+                     unsigned char* C1,
+                     size_t& C1Length,
+                     unsigned char* C2,
+                     size_t& C2Length) = 0;
+    /// \brief Decrypts the C1 and C2 with the Header into a caller buffer
+	/// \param Key for the decryption 
+	/// \param Header pointer to the header for the decryption
+	/// \param HeaderLength length of the header
+	/// \param C1 pointer to the cipher for the message
+	/// \param C1Length length of the cipher
+	/// \param C2 pointer to the commitment
+	/// \param C2Length length of the commitment
+	/// \param Message outputs the decrypted message
+	/// \param MessageLength capacity of Message, outputs the written length
+	/// \param Keyf outputs the opening key for verification
+    /// \details Message needs GetMaxPlaintextSize(C1Length) bytes, otherwise
+    ///          a runtime_error is thrown. On failure MessageLength is 0
+    virtual bool Dec(const std::string& Key,
+                     const unsigned char* Header,
+                     size_t HeaderLength,
+                     const unsigned char* C1,
+                     size_t C1Length,
+                     const unsigned char* C2,
+                     size_t C2Length,
+                     unsigned char* Message,
+                     size_t& MessageLength,
+                     std::string& Keyf) = 0;
+    /// \brief Verifies the Header and Message for a commitment
+	/// \param Header pointer to the header for the verification
+	/// \param HeaderLength length of the header
+	/// \param Message pointer to the message for the verification
+	/// \param MessageLength length of the message
+	/// \param Keyf opening key for the verification
+	/// \param C2 pointer to the commitment to verify
+	/// \param C2Length length of the commitment
+    virtual bool Ver(const unsigned char* Header,
+                     size_t HeaderLength,
+                     const unsigned char* Message,
+                     size_t MessageLength,
                      const std::string& Keyf,
-                     const std::string& C2) = 0;
+                     const unsigned char* C2,
+                     size_t C2Length) = 0;
+
+    //======================================================//
+    // Batch Enc, Dec and Ver for many small messages under one key.
+    // Message i uses the nonce increased i times, afterwards the nonce
+    // is increased once more like after Enc of a CEContext, so the next
+    // batch does not reuse a nonce. The outputs of a batch are contiguous,
+    // so the outputs of EncBatch are the inputs of DecBatch. The
+    // random bytes come from the random buffer or the generator (Random.h)
+    // and the key schedules are kept by the key contexts (KeyContext)
+
+    /// \brief Returns if the scheme has its own batch functions
+    /// \details The defaults call Enc, Dec and Ver for every message,
+    ///          so their batch times equal the times of single messages
+    virtual bool HasBatch()
+    {
+        return false;
+    }
+    /// \brief Encrypts a batch of messages into contiguous buffers
+	/// \param Key for the encryption
+	/// \param Count number of messages
+	/// \param Headers pointers to the headers
+	/// \param HeaderLengths lengths of the headers
+	/// \param Messages pointers to the messages
+	/// \param MessageLengths lengths of the messages
+	/// \param C1 outputs the ciphers behind each other
+	/// \param C1Length capacity of C1, outputs the written length
+	/// \param C1Lengths outputs the length of every cipher
+	/// \param C2 outputs the commitments, GetCommitmentSize bytes each
+    /// \details C1 needs the sum of GetCiphertextSize, otherwise
+    ///          a runtime_error is thrown
+    virtual void EncBatch(const std::string& Key,
+                          size_t Count,
+                          const unsigned char* const* Headers,
+                          const size_t* HeaderLengths,
+                          const unsigned char* const* Messages,
+                          const size_t* MessageLengths,
+                          unsigned char* C1,
+                          size_t& C1Length,
+                          size_t* C1Lengths,
+                          unsigned char* C2)
+    {
+        size_t Written = 0;
+        for (size_t i = 0; i < Count; i++)
+        {
+            C1Lengths[i] = C1Length - Written;
+            size_t C2Length = GetCommitmentSize();
+            try
+            {
+                Enc(Key, Headers[i], HeaderLengths[i], Messages[i], MessageLengths[i],
+                    C1 + Written, C1Lengths[i], C2 + i * GetCommitmentSize(), C2Length);
+            }
+            catch (...)
+            {
+                // The nonce may have been used for a part of the message
+                IncreaseNonce();
+                throw;
+            }
+            Written += C1Lengths[i];
+            IncreaseNonce();
+        }
+        C1Length = Written;
+    }
+    /// \brief Decrypts a batch of contiguous ciphers
+	/// \param Key for the decryption
+	/// \param Count number of messages
+	/// \param Headers pointers to the headers
+	/// \param HeaderLengths lengths of the headers
+	/// \param C1 the ciphers behind each other
+	/// \param C1Lengths length of every cipher
+	/// \param C2 the commitments, GetCommitmentSize bytes each
+	/// \param Message outputs the messages behind each other
+	/// \param MessageLength capacity of Message, outputs the written length
+	/// \param MessageLengths outputs the length of every message
+	/// \param Keyfs outputs the opening key of every message
+	/// \param Valid outputs if every message was decrypted
+    /// \details Message needs the sum of GetMaxPlaintextSize. Returns
+    ///          the number of valid messages, invalid ones have length 0
+    virtual size_t DecBatch(const std::string& Key,
+                            size_t Count,
+                            const unsigned char* const* Headers,
+                            const size_t* HeaderLengths,
+                            const unsigned char* C1,
+                            const size_t* C1Lengths,
+                            const unsigned char* C2,
+                            unsigned char* Message,
+                            size_t& MessageLength,
+                            size_t* MessageLengths,
+                            std::string* Keyfs,
+                            bool* Valid)
+    {
+        size_t ValidCount = 0;
+        size_t Read = 0;
+        size_t Written = 0;
+        for (size_t i = 0; i < Count; i++)
+        {
+            MessageLengths[i] = MessageLength - Written;
+            Valid[i] = Dec(Key, Headers[i], HeaderLengths[i], C1 + Read, C1Lengths[i],
+                           C2 + i * GetCommitmentSize(), GetCommitmentSize(),
+                           Message + Written, MessageLengths[i], Keyfs[i]);
+            ValidCount += Valid[i];
+            Read += C1Lengths[i];
+            Written += MessageLengths[i];
+            IncreaseNonce();
+        }
+        MessageLength = Written;
+        return ValidCount;
+    }
+    /// \brief Verifies a batch of messages for contiguous commitments
+	/// \param Count number of messages
+	/// \param Headers pointers to the headers
+	/// \param HeaderLengths lengths of the headers
+	/// \param Messages pointers to the messages
+	/// \param MessageLengths lengths of the messages
+	/// \param Keyfs opening key of every message
+	/// \param C2 the commitments, GetCommitmentSize bytes each
+	/// \param Valid outputs if every message was verified
+    /// \details Returns the number of valid messages
+    virtual size_t VerBatch(size_t Count,
+                            const unsigned char* const* Headers,
+                            const size_t* HeaderLengths,
+                            const unsigned char* const* Messages,
+                            const size_t* MessageLengths,
+                            const std::string* Keyfs,
+                            const unsigned char* C2,
+                            bool* Valid)
+    {
+        size_t ValidCount = 0;
+        for (size_t i = 0; i < Count; i++)
+        {
+            Valid[i] = Ver(Headers[i], HeaderLengths[i], Messages[i], MessageLengths[i],
+                           Keyfs[i], C2 + i * GetCommitmentSize(), GetCommitmentSize());
+            ValidCount += Valid[i];
+        }
+        return ValidCount;
+    }
+
+    //======================================================//
+    // Incremental Enc, Dec and Ver for messages which do not fit
+    // into memory. The message is streamed in parts of any size,
+    // every part can be written to disk before the next one is read.
+    // The defaults buffer the message and call the functions above
+    // in Finish, schemes which can process the parts override them
+
+    /// \brief Starts an incremental encryption
+	/// \param Key for the encryption
+	/// \param Header pointer to the header for the encryption
+	/// \param HeaderLength length of the header
+    virtual void StartEnc(const std::string& Key,
+                          const unsigned char* Header,
+                          size_t HeaderLength)
+    {
+        mStreamKey.assign(Key);
+        mStreamHeader.assign((const char*)Header, HeaderLength);
+        mStreamBuffer.clear();
+    }
+    /// \brief Encrypts the next part of the message
+	/// \param Message pointer to the next part of the message
+	/// \param MessageLength length of the part
+	/// \param C1 outputs the next part of the cipher
+	/// \param C1Length capacity of C1, outputs the written length
+    /// \details The written length can differ from MessageLength,
+    ///          MessageLength plus GetStreamBlockSize is always enough,
+    ///          otherwise a runtime_error is thrown
+    virtual void UpdateEnc(const unsigned char* Message,
+                           size_t MessageLength,
+                           unsigned char* /* C1 */,
+                           size_t& C1Length)
+    {
+        mStreamBuffer.append((const char*)Message, MessageLength);
+        C1Length = 0;
+    }
+    /// \brief Finishes an incremental encryption
+	/// \param C1 outputs the rest of the cipher
+	/// \param C1Length capacity of C1, outputs the written length
+	/// \param C2 outputs the commitment
+	/// \param C2Length capacity of C2, outputs the written length
+    /// \details C1 needs GetCiphertextSize of the whole message minus
+    ///          the length written by UpdateEnc
+    virtual void FinishEnc(unsigned char* C1,
+                           size_t& C1Length,
+                           unsigned char* C2,
+                           size_t& C2Length)
+    {
+        Enc(mStreamKey, (const unsigned char*)mStreamHeader.data(), mStreamHeader.size(),
+            (const unsigned char*)mStreamBuffer.data(), mStreamBuffer.size(), C1, C1Length, C2, C2Length);
+        mStreamBuffer.clear();
+    }
+    /// \brief Starts an incremental decryption
+	/// \param Key for the decryption
+	/// \param Header pointer to the header for the decryption
+	/// \param HeaderLength length of the header
+	/// \param C2 pointer to the commitment
+	/// \param C2Length length of the commitment
+	/// \param Trailer pointer to the last GetTrailerSize bytes of C1
+	/// \param TrailerLength length of the trailer
+    /// \details The trailer is needed first, the rest of C1 is given to UpdateDec
+    virtual void StartDec(const std::string& Key,
+                          const unsigned char* Header,
+                          size_t HeaderLength,
+                          const unsigned char* C2,
+                          size_t C2Length,
+                          const unsigned char* /* Trailer */,
+                          size_t TrailerLength)
+    {
+        if (TrailerLength != GetTrailerSize())
+        {
+            throw runtime_error("Wrong trailer length for the decryption");
+        }
+        mStreamKey.assign(Key);
+        mStreamHeader.assign((const char*)Header, HeaderLength);
+        mStreamC2.assign((const char*)C2, C2Length);
+        mStreamBuffer.clear();
+    }
+    /// \brief Decrypts the next part of C1 without the trailer
+	/// \param C1 pointer to the next part of the cipher
+	/// \param C1Length length of the part
+	/// \param Message outputs the next part of the message
+	/// \param MessageLength capacity of Message, outputs the written length
+    /// \details C1Length plus GetStreamBlockSize is always enough, otherwise
+    ///          a runtime_error is thrown. The output is not verified before
+    ///          FinishDec returns true, on failure it has to be discarded
+    virtual void UpdateDec(const unsigned char* C1,
+                           size_t C1Length,
+                           unsigned char* /* Message */,
+                           size_t& MessageLength)
+    {
+        mStreamBuffer.append((const char*)C1, C1Length);
+        MessageLength = 0;
+    }
+    /// \brief Finishes an incremental decryption and checks C1 and C2
+	/// \param Message outputs the rest of the message
+	/// \param MessageLength capacity of Message, outputs the written length
+	/// \param Keyf outputs the opening key for verification
+    /// \details Message needs GetMaxPlaintextSize of the whole C1 minus
+    ///          the length written by UpdateDec
+    virtual bool FinishDec(unsigned char* Message,
+                           size_t& MessageLength,
+                           std::string& Keyf)
+    {
+        bool Success = Dec(mStreamKey, (const unsigned char*)mStreamHeader.data(), mStreamHeader.size(),
+                           (const unsigned char*)mStreamBuffer.data(), mStreamBuffer.size(),
+                           (const unsigned char*)mStreamC2.data(), mStreamC2.size(),
+                           Message, MessageLength, Keyf);
+        mStreamBuffer.clear();
+        return Success;
+    }
+    /// \brief Starts an incremental verification
+	/// \param Header pointer to the header for the verification
+	/// \param HeaderLength length of the header
+	/// \param Keyf opening key for the verification
+	/// \param C2 pointer to the commitment to verify
+	/// \param C2Length length of the commitment
+    virtual void StartVer(const unsigned char* Header,
+                          size_t HeaderLength,
+                          const std::string& Keyf,
+                          const unsigned char* C2,
+                          size_t C2Length)
+    {
+        mStreamKey.assign(Keyf);
+        mStreamHeader.assign((const char*)Header, HeaderLength);
+        mStreamC2.assign((const char*)C2, C2Length);
+        mStreamBuffer.clear();
+    }
+    /// \brief Verifies the next part of the message
+	/// \param Message pointer to the next part of the message
+	/// \param MessageLength length of the part
+    virtual void UpdateVer(const unsigned char* Message,
+                           size_t MessageLength)
+    {
+        mStreamBuffer.append((const char*)Message, MessageLength);
+    }
+    /// \brief Finishes an incremental verification
+    virtual bool FinishVer()
+    {
+        bool Success = Ver((const unsigned char*)mStreamHeader.data(), mStreamHeader.size(),
+                           (const unsigned char*)mStreamBuffer.data(), mStreamBuffer.size(),
+                           mStreamKey, (const unsigned char*)mStreamC2.data(), mStreamC2.size());
+        mStreamBuffer.clear();
+        return Success;
+    }
+    /// \brief Returns the size of the end of C1 which StartDec needs
+    virtual size_t GetTrailerSize()
+    {
+        return 0;
+    }
+    /// \brief Returns how many bytes an Update can write more than its input
+    virtual size_t GetStreamBlockSize()
+    {
+        return 0;
+    }
+    /// \brief Returns the size of C1
+	/// \param HeaderLength length of the header
+	/// \param MessageLength length of the message
+    /// \details Exact for every message, so the output can be allocated once
+    virtual size_t GetCiphertextSize(size_t HeaderLength,
+                                     size_t MessageLength) = 0;
+    /// \brief Returns the size of the commitment C2
+    virtual size_t GetCommitmentSize() = 0;
+    /// \brief Returns the capacity Dec needs for the message
+	/// \param C1Length length of C1
+    /// \details Can include room for padding or the opening key,
+    ///          Dec returns the exact length of the message
+    virtual size_t GetMaxPlaintextSize(size_t C1Length) = 0;
+    /// \brief Returns a new instance with new components of the same types
+    /// \details Nothing is shared with this instance, only the nonce is copied.
+    ///          Every thread can work on its own clone of one parsed scheme
+    virtual ICEScheme* Clone() const = 0;
     /// \brief Returns the class description
     /// \details Contains every component
     virtual const std::string& GetClassDecription() = 0;
@@ -67,12 +458,43 @@ public:
     /// \brief Returns the needed nonce size
     virtual uint32_t GetNonceSize() = 0;
     /// \brief Sets the nonce
-    void SetNonce(string& Nonce) 
+    void SetNonce(const std::string& Nonce) 
     {
         mNonce.assign(Nonce);
     }
+    /// \brief Returns the nonce
+    const std::string& GetNonce()
+    {
+        return mNonce;
+    }
+    /// \brief Increases the nonce by one for the next message
+    void IncreaseNonce()
+    {
+        for (size_t i = 0; i < mNonce.size(); i++)
+        {
+            mNonce[i] = static_cast<char>(mNonce[i] + 0x01);
+            if (mNonce[i] != 0x00)
+            {
+                break;
+            }
+        }
+    }
 
 protected:
+    /// \brief Fills the output with random bytes
+	/// \param Output pointer to the output
+	/// \param Length number of random bytes
+    /// \details Pops the bytes from the random buffer if it runs,
+    ///          uses the generator of the calling thread otherwise
+    void GenerateRandom(unsigned char* Output, size_t Length)
+    {
+        RandomBuffer::Generate(Output, Length);
+    }
     string mNonce;
+    // State of the buffering incremental functions
+    std::string mStreamKey;
+    std::string mStreamHeader;
+    std::string mStreamC2;
+    std::string mStreamBuffer;
 };
 #endif
@@ -0,0 +1,63 @@
+#ifndef KEYCONTEXT_H
+#define KEYCONTEXT_H
+
+#include <string>
+
+#include <cryptopp/secblock.h>
+#include <cryptopp/misc.h>
+
+/// \brief KeyContext class which remembers the key of a keyed Crypto++ object
+/// \details The object keeps everything it derives from the key, e.g. the expanded
+/// AES key, the GHASH table of GCM or the padded HMAC key. A scheme only calls SetKey
+/// when the key of a call differs from the key of the context and otherwise only sets
+/// the nonce with Resynchronize, so a session with one long-term key runs the key
+/// schedule once. The key is compared in constant time.
+class KeyContext
+{
+public:
+	/// \brief Construct a KeyContext without a key
+    KeyContext():
+        mKey(),
+        mValid(false)
+    {}
+	/// \brief Returns true if the object has to be keyed with the key
+	/// \param Key pointer to the key of the call
+	/// \param KeyLength length of the key
+    bool NeedsKey(const unsigned char* Key, size_t KeyLength)
+    {
+        return !mValid || mKey.size() != KeyLength ||
+               !CryptoPP::VerifyBufsEqual(mKey.BytePtr(), Key, KeyLength);
+    }
+	/// \brief Overrides NeedsKey for a string key
+	/// \param Key the key of the call
+    bool NeedsKey(const std::string& Key)
+    {
+        return NeedsKey((const unsigned char*)Key.data(), Key.size());
+    }
+	/// \brief Remembers the key after the object was keyed
+	/// \param Key pointer to the key of the object
+	/// \param KeyLength length of the key
+    void SetKey(const unsigned char* Key, size_t KeyLength)
+    {
+        mKey.Assign(Key, KeyLength);
+        mValid = true;
+    }
+	/// \brief Overrides SetKey for a string key
+	/// \param Key the key of the object
+    void SetKey(const std::string& Key)
+    {
+        SetKey((const unsigned char*)Key.data(), Key.size());
+    }
+    /// \brief Forgets the key, the next call keys the object again
+    void Clear()
+    {
+        mKey.CleanNew(0);
+        mValid = false;
+    }
+
+private:
+    CryptoPP::SecByteBlock mKey;
+    bool mValid;
+};
+
+#endif
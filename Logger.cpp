@@ -0,0 +1,131 @@
+#include <map>
+using namespace std;
+
+#include "Logger.h"
+
+shared_ptr<Logger> Logger::Get(const string& FileName)
+{
+    // The loggers live until the end of the program, so every
+    // line is written even if a tester is not deleted
+    static mutex RegistryMutex;
+    static map<string, shared_ptr<Logger>> Registry;
+    lock_guard<mutex> Lock(RegistryMutex);
+    shared_ptr<Logger>& Log = Registry[FileName];
+    if (!Log)
+    {
+        Log = make_shared<Logger>(FileName);
+    }
+    return Log;
+}
+
+Logger::Logger(const string& FileName):
+    mQueue(cQueueSize),
+    mFile(FileName, ios::out | ios::binary | ios::app),
+    mBuffer(""),
+    mStop(false),
+    mSleeping(false),
+    mQueued(0),
+    mWritten(0),
+    mBuffered(0)
+{
+    mBuffer.reserve(cBufferSize);
+    mThread = thread(&Logger::Run, this);
+}
+
+Logger::~Logger()
+{
+    mStop.store(true);
+    {
+        lock_guard<mutex> Lock(mMutex);
+        mWake.notify_one();
+    }
+    mThread.join();
+}
+
+bool Logger::Write(string Line)
+{
+    if (!mFile.is_open())
+    {
+        return false;
+    }
+    mQueued.fetch_add(1);
+    // Only wait for the background thread if the queue is full
+    while (!mQueue.Push(Line))
+    {
+        Wake();
+        this_thread::yield();
+    }
+    Wake();
+    return true;
+}
+
+void Logger::Wake()
+{
+    // Pairs with the fence of Run, either the line is seen before the
+    // background thread sleeps or the flag is seen here
+    atomic_thread_fence(memory_order_seq_cst);
+    if (mSleeping.load(memory_order_relaxed))
+    {
+        lock_guard<mutex> Lock(mMutex);
+        mWake.notify_one();
+    }
+}
+
+void Logger::Flush()
+{
+    uint64_t Queued = mQueued.load();
+    unique_lock<mutex> Lock(mMutex);
+    mFlushed.wait(Lock, [this, Queued]
+    {
+        return mWritten.load() >= Queued;
+    });
+}
+
+void Logger::Run()
+{
+    string Line;
+    while (true)
+    {
+        // Read stop before the queue, so no line queued before the stop is lost
+        bool Stop = mStop.load();
+        while (mQueue.Pop(Line))
+        {
+            if (mBuffer.size() + Line.size() + 1 > cBufferSize)
+            {
+                WriteBuffer();
+            }
+            mBuffer += Line;
+            mBuffer += '\n';
+            mBuffered++;
+        }
+        WriteBuffer();
+        if (Stop)
+        {
+            break;
+        }
+        // Sleep until Write or the destructor wakes the thread
+        mSleeping.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        unique_lock<mutex> Lock(mMutex);
+        mWake.wait(Lock, [this]
+        {
+            return mStop.load() || !mQueue.Empty();
+        });
+        mSleeping.store(false, memory_order_relaxed);
+    }
+}
+
+void Logger::WriteBuffer()
+{
+    if (mBuffered == 0)
+    {
+        return;
+    }
+    mFile.write(mBuffer.data(), mBuffer.size());
+    mFile.flush();
+    mBuffer.clear();
+    mWritten.fetch_add(mBuffered);
+    mBuffered = 0;
+    lock_guard<mutex> Lock(mMutex);
+    mFlushed.notify_all();
+}
@@ -0,0 +1,65 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include "BoundedQueue.h"
+
+/// \brief Logger class which appends lines to a logfile on a background thread
+/// \details Writing a line only moves it into a lock-free queue, the background
+/// thread collects the lines in a preallocated buffer and writes the buffer when
+/// it is full or the queue is empty. So the timed code never waits for the file.
+/// An idle background thread sleeps until a line is queued, so it does not wake
+/// a core next to the timed threads.
+/// There is one Logger per logfile, they get flushed at shutdown.
+class Logger
+{
+public:
+	/// \brief Returns the Logger for the logfile, creates it if needed
+	/// \param FileName path of the logfile, the lines get appended
+    static std::shared_ptr<Logger> Get(const std::string& FileName);
+	/// \brief Construct a Logger and start the background thread
+	/// \param FileName path of the logfile, the lines get appended
+    Logger(const std::string& FileName);
+	/// \brief Destruct a Logger
+    /// \details Writes every queued line before the background thread stops
+    ~Logger();
+	/// \brief Queues a line for the logfile, returns false if the file could not be opened
+	/// \param Line the line without line break, the background thread adds it
+    /// \details Waits only if the queue is full
+    bool Write(std::string Line);
+	/// \brief Waits until every line queued so far is in the logfile
+    void Flush();
+
+private:
+	/// \brief Loop of the background thread
+    void Run();
+	/// \brief Writes the buffer to the file
+    void WriteBuffer();
+	/// \brief Wakes the background thread if it sleeps
+    void Wake();
+
+    BoundedQueue<std::string> mQueue;
+    std::ofstream mFile;
+    std::string mBuffer;
+    std::atomic<bool> mStop;
+    // The background thread sleeps on mWake, Flush waits on mFlushed
+    std::atomic<bool> mSleeping;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mFlushed;
+    std::atomic<uint64_t> mQueued;
+    std::atomic<uint64_t> mWritten;
+    uint64_t mBuffered;
+    std::thread mThread;
+    static const uint32_t cQueueSize = 4096;
+    static const uint32_t cBufferSize = 1 << 16;
+};
+
+#endif
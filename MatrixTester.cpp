@@ -0,0 +1,170 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <chrono>
+using namespace std;
+using namespace std::chrono;
+
+#include "MatrixTester.h"
+
+MatrixTester::MatrixTester(uint32_t Iterations,
+                           string& Logfile,
+                           vector<SchemeTester*>& Cells,
+                           uint64_t Seed):
+    Tester(Iterations, Logfile),
+    mCells(Cells),
+    mSeed(Seed)
+{
+    if (mCells.empty())
+    {
+        throw runtime_error("Need at least one scheme for the matrix");
+    }
+    if (mSeed == 0)
+    {
+        random_device Device;
+        mSeed = ((uint64_t)Device() << 32) | Device();
+    }
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    HandleOutput("Test matrix: " + to_string(mCells.size()) + " cells with " +
+                 to_string(Iterations) + " iterations each");
+    // The seed is needed to repeat the run with the same order
+    HandleOutput("Seed of the order: " + to_string(mSeed));
+}
+
+MatrixTester::~MatrixTester()
+{
+    for (SchemeTester* Cell: mCells)
+    {
+        delete Cell;
+    }
+}
+
+bool MatrixTester::Run()
+{
+    mt19937_64 Generator(mSeed);
+    vector<uint32_t> Order(mCells.size());
+    for (uint32_t i = 0; i < Order.size(); i++)
+    {
+        Order[i] = i;
+    }
+    uint32_t Rounds = 0;
+    bool Success = true;
+    steady_clock::time_point Start = steady_clock::now();
+    // The warmup rounds are shuffled too and get removed afterwards
+    for (uint32_t Round = 0; Success && (Round < GetWarmup() || !IsFinished(Rounds, Start)); Round++)
+    {
+        // One iteration per cell and round, in a new order every round
+        shuffle(Order.begin(), Order.end(), Generator);
+        for (uint32_t Index: Order)
+        {
+            if (!mCells[Index]->TestRound())
+            {
+                HandleOutput("Cell " + to_string(Index) + " (" +
+                             mCells[Index]->GetScheme()->GetClassDecription() + ") has failed");
+                Success = false;
+                break;
+            }
+        }
+        if (Round + 1 == GetWarmup())
+        {
+            for (SchemeTester* Cell: mCells)
+            {
+                Cell->ResetTime();
+            }
+            Start = steady_clock::now();
+        }
+        else if (Round >= GetWarmup() && Success)
+        {
+            Rounds++;
+        }
+    }
+    if (!Success)
+    {
+        HandleOutput(string("Only ") + to_string(Rounds) + " out of "
+                     + to_string(GetTestIterations()) + " rounds were successful.");
+    }
+    PrintTable(Rounds);
+    for (SchemeTester* Cell: mCells)
+    {
+        WriteResult(Cell->CreateResult("matrix"));
+    }
+    return Success;
+}
+
+bool MatrixTester::HasConverged(double RelativeError)
+{
+    for (SchemeTester* Cell: mCells)
+    {
+        if (!Cell->IsConverged(RelativeError))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MatrixTester::EnablePerfCounters()
+{
+    bool Success = true;
+    for (SchemeTester* Cell: mCells)
+    {
+        if (!Cell->EnablePerfCounters())
+        {
+            mPerfError = Cell->GetPerfCountersError();
+            Success = false;
+        }
+    }
+    return Success;
+}
+
+void MatrixTester::PrintTable(uint32_t Rounds)
+{
+    // Mean of enc + dec + ver of the fastest cell as reference
+    vector<double> Totals;
+    for (SchemeTester* Cell: mCells)
+    {
+        Totals.push_back(Cell->GetHistogram(0).GetMean() +
+                         Cell->GetHistogram(1).GetMean() +
+                         Cell->GetHistogram(2).GetMean());
+    }
+    double Best = *min_element(Totals.begin(), Totals.end());
+    size_t NameWidth = 6;
+    for (SchemeTester* Cell: mCells)
+    {
+        NameWidth = max(NameWidth, Cell->GetScheme()->GetClassDecription().size());
+    }
+    HandleOutput("");
+    HandleOutput("Comparison of " + to_string(Rounds) + " rounds, times in milliseconds");
+    stringstream Line;
+    Line << left << setw(NameWidth) << "Scheme" << right
+         << setw(12) << "Message" << setw(12) << "Header"
+         << setw(12) << "Enc mean" << setw(12) << "Enc p99"
+         << setw(12) << "Dec mean" << setw(12) << "Dec p99"
+         << setw(12) << "Ver mean" << setw(12) << "Ver p99"
+         << setw(12) << "Cycles/B" << setw(10) << "Relative";
+    HandleOutput(Line.str());
+    for (uint32_t i = 0; i < mCells.size(); i++)
+    {
+        SchemeTester* Cell = mCells[i];
+        uint64_t Bytes = max<uint64_t>(Cell->GetHeaderSize() + Cell->GetMessageSize(), 1);
+        // Cycles of enc, dec and ver per byte of one iteration
+        double CyclesPerByte = (double)(Cell->GetCycles(0) + Cell->GetCycles(1) + Cell->GetCycles(2)) /
+                               ((double)max<uint64_t>(Cell->GetHistogram(0).GetCount(), 1) * Bytes);
+        Line.str("");
+        Line << left << setw(NameWidth) << Cell->GetScheme()->GetClassDecription() << right
+             << setw(12) << Cell->GetMessageSize() << setw(12) << Cell->GetHeaderSize() << fixed;
+        for (uint8_t Phase = 0; Phase < 3; Phase++)
+        {
+            const Histogram& Samples = Cell->GetHistogram(Phase);
+            Line << setprecision(4) << setw(12) << Samples.GetMean() / 1000000.0
+                 << setw(12) << Samples.GetPercentile(99.0) / 1000000.0;
+        }
+        Line << setprecision(2) << setw(12) << CyclesPerByte
+             << setw(9) << (Best > 0 ? Totals[i] / Best : 0.0) << "x";
+        HandleOutput(Line.str());
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef MATRIXTESTER_H
+#define MATRIXTESTER_H
+
+#include <string>
+#include <vector>
+
+#include "Tester.h"
+
+/// \brief MatrixTester class which compares several CE schemes in one run
+/// \details Every cell of the matrix is a SchemeTester for one scheme and one
+/// message. The iterations of the cells are interleaved in a new random order
+/// every round, so thermal and frequency drifts hit every cell alike. At the
+/// end one comparison table is logged and one result record per cell is written.
+class MatrixTester: public Tester
+{
+public:
+	/// \brief Construct a MatrixTester
+	/// \param Iterations number of enc, dec and ver per cell
+	/// \param Logfile path of the logfile
+	/// \param Cells the SchemeTesters to compare
+	/// \param Seed seed for the order of the cells, 0 for a random seed
+    MatrixTester(uint32_t Iterations,
+                 std::string& Logfile,
+                 std::vector<SchemeTester*>& Cells,
+                 uint64_t Seed = 0);
+    /// \brief Destruct a MatrixTester
+    /// \details Need to delete the cells provided by the ConfigParser
+    ~MatrixTester();
+    /// \brief Runs the rounds of every cell in random order and logs the comparison
+    bool Run();
+    /// \brief Returns true if the median of every cell is converged
+	/// \param RelativeError see Timer::IsConverged
+    bool HasConverged(double RelativeError);
+    /// \brief Opens the hardware performance counters for every cell
+    bool EnablePerfCounters();
+
+private:
+	/// \brief Logs the comparison table of all cells
+	/// \param Rounds number of rounds every cell has done
+    void PrintTable(uint32_t Rounds);
+
+    std::vector<SchemeTester*> mCells;
+    uint64_t mSeed;
+};
+
+#endif
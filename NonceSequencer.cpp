@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+using namespace std;
+
+#include "NonceSequencer.h"
+
+NonceSequencer::NonceSequencer(const string& First,
+                               uint32_t BlockSize):
+    mFirst(First),
+    mBlockSize(BlockSize),
+    mCounterSize(min<size_t>(First.size(), cMaxCounterSize)),
+    mStart(ReadCounter(First, mCounterSize)),
+    mMaxOffset(mCounterSize == cMaxCounterSize ? numeric_limits<uint64_t>::max() :
+                                                 (1ull << (8 * mCounterSize)) - 1),
+    mOffset(0)
+{
+    if (mFirst.empty())
+    {
+        throw runtime_error("Need a nonce for the nonce sequencer");
+    }
+    if (mBlockSize == 0)
+    {
+        throw runtime_error("Need a block size above 0 for the nonce sequencer");
+    }
+}
+
+void NonceSequencer::Next(Reservation& Counters, string& Nonce, uint32_t Count)
+{
+    if (Counters.End - Counters.Next < Count)
+    {
+        Reserve(Counters, Count);
+    }
+    // The counter wraps around in its bytes, the offset can not
+    uint64_t Counter = mStart + Counters.Next;
+    Counters.Next += Count;
+    Nonce.assign(mFirst);
+    for (uint32_t i = 0; i < mCounterSize; i++)
+    {
+        Nonce[i] = (char)(Counter >> (8 * i));
+    }
+}
+
+size_t NonceSequencer::GetNonceSize() const
+{
+    return mFirst.size();
+}
+
+void NonceSequencer::Reserve(Reservation& Counters, uint32_t Count)
+{
+    uint64_t Size = max(mBlockSize, Count);
+    // The only shared write, once per block
+    uint64_t Begin = mOffset.fetch_add(Size, memory_order_relaxed);
+    // Offsets above the counter space would repeat the first nonces
+    if (Begin > mMaxOffset || mMaxOffset - Begin < Size - 1)
+    {
+        Counters.Next = Counters.End = 0;
+        throw runtime_error("The nonces of the sequencer are exhausted");
+    }
+    Counters.Next = Begin;
+    Counters.End = Begin + Size;
+}
+
+uint64_t NonceSequencer::ReadCounter(const string& Nonce, uint32_t CounterSize)
+{
+    uint64_t Counter = 0;
+    for (uint32_t i = 0; i < CounterSize; i++)
+    {
+        Counter |= (uint64_t)(unsigned char)Nonce[i] << (8 * i);
+    }
+    return Counter;
+}
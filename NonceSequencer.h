@@ -0,0 +1,71 @@
+#ifndef NONCESEQUENCER_H
+#define NONCESEQUENCER_H
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+/// \brief NonceSequencer class which hands out unique nonces to many threads
+/// \details A nonce is a counter in the first bytes (little-endian, up to 8 bytes,
+/// so IncreaseString and ICEScheme::IncreaseNonce count in the same direction)
+/// followed by a fixed field, both taken from the first nonce. With a random first
+/// nonce (<Noncesize>) the fixed field is random for the run and the counter
+/// starts at a random value and wraps around once. Every thread keeps a
+/// Reservation and only takes a new block of counters with one atomic fetch-add when
+/// its block is used up. So two threads never get the same nonce under one key and
+/// the threads do not share a cache line per message. Skipped counters of a
+/// reservation are never handed out again.
+class NonceSequencer
+{
+public:
+    /// \brief Counters reserved by one thread, owned by the thread
+    struct Reservation
+    {
+        uint64_t Next = 0;
+        uint64_t End = 0;
+    };
+	/// \brief Construct a NonceSequencer
+	/// \param First the first nonce, gives the size, the start of the counter and the fixed field
+	/// \param BlockSize number of counters a thread reserves at once
+    NonceSequencer(const std::string& First,
+                   uint32_t BlockSize = cDefaultBlockSize);
+	/// \brief Destruct a NonceSequencer
+    ~NonceSequencer() {}
+    NonceSequencer(const NonceSequencer&) = delete;
+    NonceSequencer& operator=(const NonceSequencer&) = delete;
+	/// \brief Outputs the next nonce of the reservation, reserves a new block if needed
+	/// \param Counters the reservation of the calling thread
+	/// \param Nonce outputs the nonce
+	/// \param Count number of consecutive nonces, e.g. for EncBatch
+    /// \details Nonce is the first of Count nonces which can be reached with
+    ///          IncreaseNonce. Throws a runtime_error if the counter is exhausted
+    void Next(Reservation& Counters, std::string& Nonce, uint32_t Count = 1);
+	/// \brief Returns the size of the nonces
+    size_t GetNonceSize() const;
+
+private:
+	/// \brief Reserves a new block of counters
+	/// \param Counters the reservation of the calling thread
+	/// \param Count least number of counters in the block
+    void Reserve(Reservation& Counters, uint32_t Count);
+	/// \brief Returns the little-endian counter in the first bytes of the nonce
+	/// \param Nonce the nonce
+	/// \param CounterSize number of counter bytes
+    static uint64_t ReadCounter(const std::string& Nonce, uint32_t CounterSize);
+
+    // First nonce, the fixed field is copied from it
+    const std::string mFirst;
+    const uint32_t mBlockSize;
+    // Number of nonce bytes used by the counter
+    const uint32_t mCounterSize;
+    // Counter of the first nonce
+    const uint64_t mStart;
+    // Number of counters minus one
+    const uint64_t mMaxOffset;
+    // Number of counters handed out, can not wrap around
+    alignas(64) std::atomic<uint64_t> mOffset;
+    static const uint32_t cMaxCounterSize = 8;
+    static const uint32_t cDefaultBlockSize = 1024;
+};
+
+#endif
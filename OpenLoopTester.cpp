@@ -0,0 +1,294 @@
+#include <iostream>
+#include <thread>
+#include <random>
+#include <cmath>
+using namespace std;
+using namespace std::chrono;
+
+#include "OpenLoopTester.h"
+
+OpenLoopTester::OpenLoopTester(uint32_t Iterations,
+                               string& Logfile,
+                               string& Key,
+                               string& Nonce,
+                               string& Header,
+                               string& Message,
+                               ICEScheme* CE,
+                               uint32_t Workers,
+                               bool Poisson,
+                               vector<double>& Rates,
+                               double SecondsPerRate,
+                               uint32_t LatencyBudget):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mH(Tester::ReadImage(Header)),
+    mM(Tester::ReadImage(Message)),
+    mNonces(Nonce),
+    mCE(CE),
+    mWorkers(Workers),
+    mPoisson(Poisson),
+    mRates(Rates),
+    mSecondsPerRate(SecondsPerRate),
+    mLatencyBudget(LatencyBudget),
+    mNext(0),
+    mReady(0),
+    mRunning(0),
+    mStart(false),
+    mStop(false)
+{
+    if (Workers == 0)
+    {
+        throw runtime_error("Need at least one worker for the open loop test");
+    }
+    if (mRates.empty())
+    {
+        throw runtime_error("Need at least one rate for the open loop test");
+    }
+    for (Worker& State: mWorkers)
+    {
+        State.Context = new CEContext(*mCE, mNonces);
+        State.Success = true;
+    }
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Open loop scheme: " + mCE->GetClassDecription() +
+                 " with " + to_string(mWorkers.size()) + " workers, " +
+                 (mPoisson ? "Poisson" : "constant") + " arrivals", true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(Nonce.size()), false);
+    HandleOutput("Header size: " + to_string(mH.size()), false);
+    HandleOutput("Message size: " + to_string(mM.size()), false);
+    // Test round to setup the sizes for the members of every worker
+    for (Worker& State: mWorkers)
+    {
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        if (!State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf) ||
+            !State.Context->Ver(mH, State.Message, State.Keyf, State.C2))
+        {
+            throw runtime_error("Setup round failed.");
+        }
+    }
+}
+
+OpenLoopTester::~OpenLoopTester()
+{
+    for (Worker& State: mWorkers)
+    {
+        delete State.Context;
+    }
+    delete mCE;
+}
+
+bool OpenLoopTester::Run()
+{
+    HandleOutput("");
+    double Knee = 0.0;
+    double Capacity = 0.0;
+    uint64_t BaseP99 = 0;
+    bool Success = true;
+    for (double Rate: mRates)
+    {
+        double Achieved = 0.0;
+        uint64_t P99 = 0;
+        if (!RunRate(Rate, Achieved, P99))
+        {
+            Success = false;
+            break;
+        }
+        if (BaseP99 == 0)
+        {
+            BaseP99 = max<uint64_t>(P99, 1);
+        }
+        // Saturated when the workers can not keep up or the queueing explodes
+        if (Achieved < cSaturatedThroughput * Rate || P99 > cSaturatedLatency * BaseP99)
+        {
+            HandleOutput("Saturated at " + to_string(Rate) + " requests/s");
+            break;
+        }
+        Knee = Rate;
+        if (P99 <= (uint64_t)mLatencyBudget * 1000)
+        {
+            Capacity = Rate;
+        }
+    }
+    HandleOutput("");
+    if (Knee == 0.0)
+    {
+        HandleOutput("Saturated at the lowest rate, no knee found");
+    }
+    else
+    {
+        HandleOutput("Saturation knee: " + to_string(Knee) + " requests/s");
+    }
+    HandleOutput("Capacity for a p99 of " + to_string(mLatencyBudget) + " microseconds: " +
+                 to_string(Capacity) + " requests/s, " + to_string(Capacity / mWorkers.size()) +
+                 " requests/s per worker");
+    return Success;
+}
+
+void OpenLoopTester::RunWorker(Worker& State)
+{
+    // Warmup rounds of this worker are not measured
+    for (uint32_t i = 0; i < GetWarmup(); i++)
+    {
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf);
+        State.Context->Ver(mH, State.Message, State.Keyf, State.C2);
+    }
+    mReady.fetch_add(1);
+    // Wait until every thread is created and warmed up
+    while (!mStart.load(memory_order_acquire))
+    {
+        this_thread::yield();
+    }
+    for (uint64_t Request = mNext.fetch_add(1);
+         Request < mSchedule.size() && !mStop.load(memory_order_relaxed);
+         Request = mNext.fetch_add(1))
+    {
+        high_resolution_clock::time_point Intended = mStartTime + nanoseconds(mSchedule[Request]);
+        // Sleep until shortly before the arrival and spin for the rest
+        if (Intended - high_resolution_clock::now() > microseconds(100))
+        {
+            this_thread::sleep_until(Intended - microseconds(50));
+        }
+        while (high_resolution_clock::now() < Intended);
+        high_resolution_clock::time_point Start = high_resolution_clock::now();
+        // Encryption with the next nonce of the reservation of the context
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        bool Success = State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf);
+        Success = Success && State.Context->Ver(mH, State.Message, State.Keyf, State.C2);
+        high_resolution_clock::time_point Stop = high_resolution_clock::now();
+        {
+            lock_guard<mutex> Lock(State.Lock);
+            // From the planned arrival, not from the start of the service
+            State.Latency.Record(duration_cast<nanoseconds>(Stop - Intended).count());
+            State.Service.Record(duration_cast<nanoseconds>(Stop - Start).count());
+        }
+        if (!Success)
+        {
+            State.Success = false;
+            break;
+        }
+    }
+    State.Finish = high_resolution_clock::now();
+    mRunning.fetch_sub(1);
+}
+
+bool OpenLoopTester::RunRate(double Rate, double& Achieved, uint64_t& P99)
+{
+    // Plan the arrivals, the number of requests is capped by the iterations
+    uint64_t Requests = min<uint64_t>(max<uint64_t>((uint64_t)(Rate * mSecondsPerRate), 1),
+                                      GetTestIterations());
+    mSchedule.resize(Requests);
+    random_device Device;
+    mt19937_64 Generator(((uint64_t)Device() << 32) | Device());
+    exponential_distribution<double> Exponential(Rate);
+    double Arrival = 0.0;
+    for (uint64_t i = 0; i < Requests; i++)
+    {
+        mSchedule[i] = (uint64_t)(Arrival * 1e9);
+        Arrival += mPoisson ? Exponential(Generator) : 1.0 / Rate;
+    }
+    vector<thread> Threads;
+    mStart.store(false);
+    mStop.store(false);
+    mNext.store(0);
+    mReady.store(0);
+    mRunning.store(mWorkers.size());
+    for (Worker& State: mWorkers)
+    {
+        State.Latency.Reset();
+        State.Service.Reset();
+        Threads.emplace_back(&OpenLoopTester::RunWorker, this, ref(State));
+    }
+    while (mReady.load() < mWorkers.size())
+    {
+        this_thread::yield();
+    }
+    // Give the threads some time to wake up, the first arrival is planned after it
+    mStartTime = high_resolution_clock::now() + milliseconds(10);
+    mStart.store(true, memory_order_release);
+    // The requests are shared, so the rounds are the completed requests of all workers
+    auto Snapshot = [this]()
+    {
+        mLatency.Reset();
+        mService.Reset();
+        for (Worker& State: mWorkers)
+        {
+            lock_guard<mutex> Lock(State.Lock);
+            mLatency.Merge(State.Latency);
+            mService.Merge(State.Service);
+        }
+        return (uint32_t)mLatency.GetCount();
+    };
+    if (WaitForWorkers(mRunning, Snapshot, steady_clock::now()))
+    {
+        mStop.store(true);
+    }
+    for (thread& Thread: Threads)
+    {
+        Thread.join();
+    }
+    // Until the last request is done, the monitor may wake up later
+    high_resolution_clock::time_point Finish = mStartTime;
+    for (Worker& State: mWorkers)
+    {
+        Finish = max(Finish, State.Finish);
+    }
+    double Seconds = duration_cast<nanoseconds>(Finish - mStartTime).count() / 1e9;
+    // Aggregate the results of all workers
+    bool Success = true;
+    Histogram Latency, Service;
+    for (uint32_t i = 0; i < mWorkers.size(); i++)
+    {
+        if (!mWorkers[i].Success)
+        {
+            HandleOutput("Worker " + to_string(i) + " - Decryption or verification has failed");
+            Success = false;
+        }
+        Latency.Merge(mWorkers[i].Latency);
+        Service.Merge(mWorkers[i].Service);
+    }
+    Achieved = Latency.GetCount() / Seconds;
+    P99 = Latency.GetPercentile(99.0);
+    HandleOutput("Offered: " + to_string(Rate) + " requests/s - Achieved: " + to_string(Achieved) +
+                 " requests/s - Latency p50: " + to_string(Latency.GetPercentile(50.0) / 1000000.0) +
+                 ", p99: " + to_string(P99 / 1000000.0) +
+                 ", p99.9: " + to_string(Latency.GetPercentile(99.9) / 1000000.0) +
+                 " milliseconds - Service p50: " + to_string(Service.GetPercentile(50.0) / 1000000.0) +
+                 " milliseconds");
+    HandleOutput("Offered: " + to_string(Rate) + " requests/s - Latency " + GetLatencySummary(Latency), false);
+    ResultRecord Record = CreateRecord("openloop", mCE, mH.size(), mM.size(), mKey.size(),
+                                       mWorkers[0].Nonce.size(), Latency.GetCount(), mWorkers.size());
+    Record.Add("arrival", string(mPoisson ? "poisson" : "constant"));
+    Record.Add("offered_per_s", Rate);
+    Record.Add("achieved_per_s", Achieved);
+    // One request is encryption, decryption and verification
+    Record.AddPhase("latency", Latency, 0, 0);
+    Record.AddPhase("service", Service, 0, 0);
+    WriteResult(Record);
+    return Success;
+}
+
+bool OpenLoopTester::HasConverged(double RelativeError)
+{
+    return IsConverged(mLatency, RelativeError) && IsConverged(mService, RelativeError);
+}
+
+vector<double> OpenLoopTester::GeometricRates(double Min, double Max, uint32_t Steps)
+{
+    if (Steps < 2 || Min <= 0.0 || Max < Min)
+    {
+        throw runtime_error("Need at least 2 steps and 0 < min <= max for the rates");
+    }
+    vector<double> Rates;
+    double Factor = pow(Max / Min, 1.0 / (Steps - 1));
+    for (uint32_t i = 0; i < Steps; i++)
+    {
+        Rates.push_back(Min * pow(Factor, i));
+    }
+    return Rates;
+}
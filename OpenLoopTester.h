@@ -0,0 +1,120 @@
+#ifndef OPENLOOPTESTER_H
+#define OPENLOOPTESTER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "Tester.h"
+#include "Histogram.h"
+#include "NonceSequencer.h"
+#include "CEContext.h"
+
+/// \brief OpenLoopTester class which offers requests to a CE scheme at a fixed rate
+/// \details A request is one round of encryption, decryption and verification.
+/// The arrival times are planned before the run (constant or Poisson) and a pool
+/// of workers takes the requests in order. The latency is measured from the planned
+/// arrival, so a request which waits for a busy worker counts its waiting time too
+/// (no coordinated omission). The offered rate is increased geometrically until
+/// the scheme saturates, then the knee and the capacity for a p99 budget are logged.
+/// Every worker runs the warmup rounds before the first arrival of a rate. A rate
+/// stops taking requests early once the merged latencies are converged or the
+/// time budget is used up.
+class OpenLoopTester: public Tester
+{
+public:
+	/// \brief Construct an OpenLoopTester
+	/// \param Iterations maximal number of requests per rate
+	/// \param Logfile path of the logfile
+	/// \param Key for the schemes to test
+	/// \param Nonce first nonce of the NonceSequencer which gives every context unique nonces
+	/// \param Header for the tester, can be path to image or string
+	/// \param Message for the tester, can be path to image or string
+	/// \param CE reference to the scheme to test, every worker gets a context of it
+	/// \param Workers number of worker threads
+	/// \param Poisson true for exponential inter arrival times, false for a constant rate
+	/// \param Rates offered rates in requests per second, in increasing order
+	/// \param SecondsPerRate duration of the arrivals for one rate
+	/// \param LatencyBudget p99 budget in microseconds for the capacity
+    OpenLoopTester(uint32_t Iterations,
+                   std::string& Logfile,
+                   std::string& Key,
+                   std::string& Nonce,
+                   std::string& Header,
+                   std::string& Message,
+                   ICEScheme* CE,
+                   uint32_t Workers,
+                   bool Poisson,
+                   std::vector<double>& Rates,
+                   double SecondsPerRate,
+                   uint32_t LatencyBudget);
+    /// \brief Destruct an OpenLoopTester
+    /// \details Need to delete the contexts and the scheme provided by the SchemeFactory
+    ~OpenLoopTester();
+    /// \brief Runs the offered rates until the scheme saturates and logs the results
+    bool Run();
+    /// \brief Returns Steps rates from Min to Max with a constant factor
+	/// \param Min first rate
+	/// \param Max last rate
+	/// \param Steps number of rates, at least 2
+    static std::vector<double> GeometricRates(double Min, double Max, uint32_t Steps);
+    /// \brief Returns true if the merged histograms of the running rate are converged
+	/// \param RelativeError see Timer::IsConverged
+    bool HasConverged(double RelativeError);
+
+private:
+    /// \brief State of one worker thread
+    /// \details Aligned to a cache line to avoid false sharing between the threads
+    struct alignas(64) Worker
+    {
+        CEContext* Context;
+        // Nonce of the last encryption
+        std::string Nonce;
+        std::string C1;
+        std::string C2;
+        std::string Message;
+        std::string Keyf;
+        Histogram Latency;
+        Histogram Service;
+        // Guards the histograms while the main thread merges them
+        std::mutex Lock;
+        std::chrono::high_resolution_clock::time_point Finish;
+        bool Success;
+    };
+	/// \brief Takes the planned requests until there are none left
+	/// \param State of the worker thread
+    void RunWorker(Worker& State);
+	/// \brief Offers the rate and logs the results
+	/// \param Rate offered requests per second
+	/// \param Achieved reference outputs the completed requests per second
+	/// \param P99 reference outputs the p99 latency in nanoseconds
+    bool RunRate(double Rate, double& Achieved, uint64_t& P99);
+
+    std::string mKey;
+    std::string mH;
+    std::string mM;
+    NonceSequencer mNonces;
+    ICEScheme* mCE;
+    std::vector<Worker> mWorkers;
+    bool mPoisson;
+    std::vector<double> mRates;
+    double mSecondsPerRate;
+    uint32_t mLatencyBudget;
+    std::vector<uint64_t> mSchedule;
+    std::chrono::high_resolution_clock::time_point mStartTime;
+    Histogram mLatency;
+    Histogram mService;
+    std::atomic<uint64_t> mNext;
+    std::atomic<uint32_t> mReady;
+    std::atomic<uint32_t> mRunning;
+    std::atomic<bool> mStart;
+    std::atomic<bool> mStop;
+    // Below this fraction of the offered rate the scheme is saturated
+    const double cSaturatedThroughput = 0.95;
+    // Above this multiple of the p99 at the lowest rate the scheme is saturated
+    const double cSaturatedLatency = 10.0;
+};
+
+#endif
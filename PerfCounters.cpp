@@ -0,0 +1,169 @@
+#include <cstring>
+#include <cerrno>
+using namespace std;
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "PerfCounters.h"
+
+PerfCounters::PerfCounters():
+    mLeader(-1),
+    mError("")
+{
+    for (uint32_t i = 0; i < EventCount; i++)
+    {
+        mPosition[i] = -1;
+    }
+#ifdef __linux__
+    // The leader has to be the first one
+    Open(Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if (mLeader < 0)
+    {
+        return;
+    }
+    Open(Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    Open(BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    Open(L1DMisses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    Open(LLCMisses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    Open(DTLBMisses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    ioctl(mLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(mLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    mError = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int Descriptor: mDescriptors)
+    {
+        close(Descriptor);
+    }
+#endif
+}
+
+void PerfCounters::Open(Event Counter, uint32_t Type, uint64_t Config)
+{
+#ifdef __linux__
+    struct perf_event_attr Attributes;
+    memset(&Attributes, 0, sizeof(Attributes));
+    Attributes.size = sizeof(Attributes);
+    Attributes.type = Type;
+    Attributes.config = Config;
+    // The group is enabled at once with the leader
+    Attributes.disabled = (mLeader < 0) ? 1 : 0;
+    // Only user space, needed for perf_event_paranoid = 2
+    Attributes.exclude_kernel = 1;
+    Attributes.exclude_hv = 1;
+    Attributes.read_format = PERF_FORMAT_GROUP |
+                             PERF_FORMAT_TOTAL_TIME_ENABLED |
+                             PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Count the calling thread on any cpu
+    int Descriptor = syscall(__NR_perf_event_open, &Attributes, 0, -1, mLeader, 0);
+    if (Descriptor < 0)
+    {
+        if (mError.empty())
+        {
+            mError = GetEventName(Counter) + ": " + strerror(errno);
+        }
+        return;
+    }
+    if (mLeader < 0)
+    {
+        mLeader = Descriptor;
+    }
+    mPosition[Counter] = mDescriptors.size();
+    mDescriptors.push_back(Descriptor);
+#else
+    (void)Counter;
+    (void)Type;
+    (void)Config;
+#endif
+}
+
+bool PerfCounters::IsAvailable() const
+{
+    return mLeader >= 0;
+}
+
+bool PerfCounters::IsAvailable(Event Counter) const
+{
+    return mPosition[Counter] >= 0;
+}
+
+bool PerfCounters::Read(uint64_t* Values) const
+{
+    memset(Values, 0, EventCount * sizeof(uint64_t));
+#ifdef __linux__
+    if (mLeader < 0)
+    {
+        return false;
+    }
+    // Layout of a group read: number, time enabled, time running, values
+    uint64_t Buffer[3 + EventCount];
+    ssize_t Size = read(mLeader, Buffer, sizeof(Buffer));
+    if (Size < (ssize_t)(3 * sizeof(uint64_t)) || Buffer[0] > EventCount)
+    {
+        return false;
+    }
+    if (Buffer[2] == 0)
+    {
+        // The group never got a PMU, so the zeros were not counted
+        return false;
+    }
+    double Scale = 1.0;
+    if (Buffer[2] < Buffer[1])
+    {
+        // The counters were multiplexed, so extrapolate
+        Scale = (double)Buffer[1] / Buffer[2];
+    }
+    for (uint32_t i = 0; i < EventCount; i++)
+    {
+        if (mPosition[i] >= 0 && (uint64_t)mPosition[i] < Buffer[0])
+        {
+            Values[i] = (uint64_t)(Buffer[3 + mPosition[i]] * Scale);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+const string& PerfCounters::GetError() const
+{
+    return mError;
+}
+
+string PerfCounters::GetEventName(Event Counter)
+{
+    switch (Counter)
+    {
+        case Cycles:
+            return "cycles";
+        case Instructions:
+            return "instructions";
+        case BranchMisses:
+            return "branch misses";
+        case L1DMisses:
+            return "L1D misses";
+        case LLCMisses:
+            return "LLC misses";
+        case DTLBMisses:
+            return "dTLB misses";
+        default:
+            return "unknown";
+    }
+}
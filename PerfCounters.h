@@ -0,0 +1,62 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/// \brief PerfCounters class which reads hardware performance counters of the calling thread
+/// \details Uses perf_event_open on Linux. All counters are opened as one group
+/// with cycles as leader, so one read returns every counter. Counters that can not be
+/// opened are left out and if there are no counters at all (no Linux, missing PMU
+/// in a container or VM, perf_event_paranoid) IsAvailable returns false.
+class PerfCounters
+{
+public:
+    /// \brief Counted events, the values are the indices for Read
+    enum Event
+    {
+        Cycles = 0,
+        Instructions,
+        BranchMisses,
+        L1DMisses,
+        LLCMisses,
+        DTLBMisses,
+        EventCount
+    };
+	/// \brief Construct PerfCounters and open the counters for the calling thread
+    PerfCounters();
+	/// \brief Destruct PerfCounters and close the counters
+    ~PerfCounters();
+    /// \brief Returns true if at least the cycles can be counted
+    bool IsAvailable() const;
+    /// \brief Returns true if the event can be counted
+	/// \param Counter the event
+    bool IsAvailable(Event Counter) const;
+    /// \brief Reads the current values of all counters
+	/// \param Values array with EventCount entries, unavailable events are set to 0
+    /// \details The values are scaled if the kernel had to multiplex the counters.
+    /// Returns false if the group could not be read or was never scheduled on the
+    /// PMU (time running 0), then all values are 0 but not counted.
+    bool Read(uint64_t* Values) const;
+    /// \brief Returns the reason why counters are unavailable
+    const std::string& GetError() const;
+    /// \brief Returns the name of an event
+	/// \param Counter the event
+    static std::string GetEventName(Event Counter);
+
+private:
+	/// \brief Opens one counter and adds it to the group
+	/// \param Counter the event for the index
+	/// \param Type perf type of the event
+	/// \param Config perf config of the event
+    void Open(Event Counter, uint32_t Type, uint64_t Config);
+
+    int mLeader;
+    std::vector<int> mDescriptors;
+    // Position of an event inside the group read, -1 if unavailable
+    int mPosition[EventCount];
+    std::string mError;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include <cstring>
+using namespace std;
+
+#include <cryptopp/osrng.h>
+#include <cryptopp/misc.h>
+using namespace CryptoPP;
+
+#include "Random.h"
+
+void RandomGenerator::Generate(unsigned char* Output, size_t Length)
+{
+    // Every thread has its own generator, no locks are needed
+    static thread_local RandomGenerator Generator;
+    Generator.Fill(Output, Length);
+}
+
+string RandomGenerator::Generate(size_t Length)
+{
+    string Random(Length, 0x00);
+    Generate((unsigned char*)&Random[0], Random.size());
+    return Random;
+}
+
+RandomGenerator::RandomGenerator():
+    mCipher(),
+    mBytes(0)
+{
+    Reseed();
+}
+
+RandomGenerator::~RandomGenerator()
+{
+    // Overwrite the key schedule with a key of zeros
+    unsigned char Zero[cKeySize] = {0};
+    SetKey(Zero);
+}
+
+void RandomGenerator::Fill(unsigned char* Output, size_t Length)
+{
+    if (mBytes >= cReseedBytes)
+    {
+        Reseed();
+    }
+    // CTR mode xors the key stream into the input
+    memset(Output, 0x00, Length);
+    mCipher.ProcessData(Output, Output, Length);
+    // Fast key erasure, the next key is the following key stream
+    unsigned char Key[cKeySize] = {0};
+    mCipher.ProcessData(Key, Key, cKeySize);
+    SetKey(Key);
+    SecureWipeBuffer(Key, cKeySize);
+    mBytes += Length;
+}
+
+void RandomGenerator::Reseed()
+{
+    AutoSeededRandomPool Rnd;
+    unsigned char Key[cKeySize];
+    Rnd.GenerateBlock(Key, cKeySize);
+    SetKey(Key);
+    SecureWipeBuffer(Key, cKeySize);
+    mBytes = 0;
+}
+
+void RandomGenerator::SetKey(const unsigned char* Key)
+{
+    // Every key is used for one request, so the counter can always start at 0
+    const unsigned char IV[AES::BLOCKSIZE] = {0};
+    mCipher.SetKeyWithIV(Key, cKeySize, IV, sizeof(IV));
+}
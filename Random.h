@@ -0,0 +1,50 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <string>
+#include <cstdint>
+
+#include <cryptopp/modes.h>
+#include <cryptopp/aes.h>
+
+/// \brief RandomGenerator class, a fast CSPRNG with one instance per thread
+/// \details AES-256 in CTR mode with fast key erasure: every request is the key
+/// stream of the current key and the next 32 bytes of the stream become the new
+/// key, so a later compromise of the state does not reveal earlier outputs. The
+/// key is seeded from an AutoSeededRandomPool when a thread first asks for random
+/// bytes and reseeded after cReseedBytes, instead of reading the OS entropy
+/// source for every opening key. Used for all keys, opening keys and nonces.
+class RandomGenerator
+{
+public:
+	/// \brief Fills the output with random bytes from the generator of the thread
+	/// \param Output pointer to the output
+	/// \param Length number of random bytes
+    static void Generate(unsigned char* Output, size_t Length);
+	/// \brief Returns a string of random bytes from the generator of the thread
+	/// \param Length number of random bytes
+    static std::string Generate(size_t Length);
+
+private:
+	/// \brief Construct a RandomGenerator with a seed from the OS
+    RandomGenerator();
+	/// \brief Destruct a RandomGenerator, wipes the key
+    ~RandomGenerator();
+	/// \brief Fills the output with the key stream and replaces the key
+	/// \param Output pointer to the output
+	/// \param Length number of random bytes
+    void Fill(unsigned char* Output, size_t Length);
+	/// \brief Sets a new key from the OS entropy source
+    void Reseed();
+	/// \brief Sets the key for the key stream
+	/// \param Key pointer to cKeySize bytes
+    void SetKey(const unsigned char* Key);
+
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption mCipher;
+    // Bytes since the last reseed
+    uint64_t mBytes;
+    static const size_t cKeySize = 32;
+    static const uint64_t cReseedBytes = 1ull << 24;
+};
+
+#endif
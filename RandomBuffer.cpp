@@ -0,0 +1,178 @@
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+using namespace std;
+using namespace std::chrono;
+
+#include <cryptopp/misc.h>
+using namespace CryptoPP;
+
+#include "RandomBuffer.h"
+#include "Random.h"
+
+// The running buffer, read without a lock by Generate
+static atomic<RandomBuffer*> ActiveBuffer(NULL);
+// Owner of the running buffer, stopped at the end of the program
+static unique_ptr<RandomBuffer> OwnedBuffer;
+static mutex BufferMutex;
+
+void RandomBuffer::Start(uint32_t Capacity)
+{
+    lock_guard<mutex> Lock(BufferMutex);
+    ActiveBuffer.store(NULL);
+    OwnedBuffer.reset(new RandomBuffer(Capacity));
+    ActiveBuffer.store(OwnedBuffer.get());
+}
+
+void RandomBuffer::Stop()
+{
+    lock_guard<mutex> Lock(BufferMutex);
+    ActiveBuffer.store(NULL);
+    OwnedBuffer.reset();
+}
+
+bool RandomBuffer::IsRunning()
+{
+    return ActiveBuffer.load() != NULL;
+}
+
+void RandomBuffer::Generate(unsigned char* Output, size_t Length)
+{
+    RandomBuffer* Buffer = ActiveBuffer.load(memory_order_acquire);
+    if (Buffer == NULL)
+    {
+        RandomGenerator::Generate(Output, Length);
+        return;
+    }
+    Buffer->Pop(Output, Length);
+}
+
+RandomBuffer::Metrics RandomBuffer::GetMetrics()
+{
+    lock_guard<mutex> Lock(BufferMutex);
+    if (!OwnedBuffer)
+    {
+        return Metrics{0, 0, 0, 0, 0.0, 0.0};
+    }
+    return OwnedBuffer->Collect();
+}
+
+string RandomBuffer::GetReport()
+{
+    Metrics Current = GetMetrics();
+    double Starvation = Current.Requests > 0 ? 100.0 * Current.StarvedRequests / Current.Requests : 0.0;
+    return "Random buffer: " + to_string(Current.FilledBlocks) + " blocks filled, " +
+           to_string(Current.PoppedBlocks) + " blocks popped, refill rate: " +
+           to_string(Current.RefillRate) + " blocks/s, consume rate: " +
+           to_string(Current.ConsumeRate) + " blocks/s, starved: " +
+           to_string(Current.StarvedRequests) + " of " + to_string(Current.Requests) +
+           " requests (" + to_string(Starvation) + " %)";
+}
+
+RandomBuffer::RandomBuffer(uint32_t Capacity):
+    mRing(Capacity),
+    mStop(false),
+    mFilledBlocks(0),
+    mFillNanoseconds(0),
+    mPoppedBlocks(0),
+    mRequests(0),
+    mStarvedRequests(0),
+    mStart(steady_clock::now())
+{
+    mThread = thread(&RandomBuffer::Run, this);
+}
+
+RandomBuffer::~RandomBuffer()
+{
+    mStop.store(true);
+    mThread.join();
+    // Wipe the blocks nobody has used
+    Block Current;
+    while (mRing.Pop(Current))
+    {
+        SecureWipeBuffer(Current.Bytes, cBlockSize);
+    }
+}
+
+void RandomBuffer::Run()
+{
+    Block Next;
+    bool HasNext = false;
+    while (!mStop.load(memory_order_relaxed))
+    {
+        // Fill until the ring is full, only the filling is part of the refill rate
+        steady_clock::time_point Begin = steady_clock::now();
+        uint64_t Filled = 0;
+        while (true)
+        {
+            if (!HasNext)
+            {
+                RandomGenerator::Generate(Next.Bytes, cBlockSize);
+                HasNext = true;
+            }
+            if (!mRing.Push(Next))
+            {
+                break;
+            }
+            HasNext = false;
+            Filled++;
+        }
+        if (Filled > 0)
+        {
+            mFillNanoseconds.fetch_add(duration_cast<nanoseconds>(steady_clock::now() - Begin).count(),
+                                       memory_order_relaxed);
+            mFilledBlocks.fetch_add(Filled, memory_order_relaxed);
+        }
+        this_thread::sleep_for(microseconds(cIdleMicroseconds));
+    }
+    SecureWipeBuffer(Next.Bytes, cBlockSize);
+}
+
+void RandomBuffer::Pop(unsigned char* Output, size_t Length)
+{
+    mRequests.fetch_add(1, memory_order_relaxed);
+    Block Current;
+    size_t Done = 0;
+    uint64_t Popped = 0;
+    while (Done < Length)
+    {
+        if (!mRing.Pop(Current))
+        {
+            // The ring has drained, the rest is generated on the calling thread
+            RandomGenerator::Generate(Output + Done, Length - Done);
+            mStarvedRequests.fetch_add(1, memory_order_relaxed);
+            break;
+        }
+        size_t Part = min(Length - Done, cBlockSize);
+        memcpy(Output + Done, Current.Bytes, Part);
+        Done += Part;
+        Popped++;
+    }
+    if (Popped > 0)
+    {
+        mPoppedBlocks.fetch_add(Popped, memory_order_relaxed);
+        SecureWipeBuffer(Current.Bytes, cBlockSize);
+    }
+}
+
+RandomBuffer::Block& RandomBuffer::Block::operator=(Block&& Other)
+{
+    memcpy(Bytes, Other.Bytes, cBlockSize);
+    SecureWipeBuffer(Other.Bytes, cBlockSize);
+    return *this;
+}
+
+RandomBuffer::Metrics RandomBuffer::Collect() const
+{
+    Metrics Current;
+    Current.FilledBlocks = mFilledBlocks.load();
+    Current.PoppedBlocks = mPoppedBlocks.load();
+    Current.Requests = mRequests.load();
+    Current.StarvedRequests = mStarvedRequests.load();
+    uint64_t FillNanoseconds = mFillNanoseconds.load();
+    Current.RefillRate = FillNanoseconds > 0 ? Current.FilledBlocks * 1e9 / FillNanoseconds : 0.0;
+    double Seconds = duration_cast<nanoseconds>(steady_clock::now() - mStart).count() / 1e9;
+    Current.ConsumeRate = Seconds > 0.0 ? Current.PoppedBlocks / Seconds : 0.0;
+    return Current;
+}
@@ -0,0 +1,94 @@
+#ifndef RANDOMBUFFER_H
+#define RANDOMBUFFER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "BoundedQueue.h"
+
+/// \brief RandomBuffer class, a ring of random blocks filled by a background thread
+/// \details The background thread keeps the lock-free ring full with blocks of the
+/// RandomGenerator, so the opening keys of an encryption are a few pops instead of a
+/// generation on the timed path. When the ring is empty the rest of the request is
+/// generated inline and counted as starved. There is at most one running buffer,
+/// Generate falls back to the RandomGenerator of the calling thread without it.
+class RandomBuffer
+{
+public:
+    /// \brief Counters of the running buffer
+    struct Metrics
+    {
+        uint64_t FilledBlocks;
+        uint64_t PoppedBlocks;
+        uint64_t Requests;
+        uint64_t StarvedRequests;
+        // Blocks per second while the background thread was filling
+        double RefillRate;
+        // Blocks per second popped since the start
+        double ConsumeRate;
+    };
+	/// \brief Starts the buffer, a running buffer is stopped before
+	/// \param Capacity number of blocks, needs to be a power of two
+    /// \details Must not be called while a scheme generates random bytes
+    static void Start(uint32_t Capacity);
+	/// \brief Stops the buffer, Generate uses the generator of the thread afterwards
+    /// \details Must not be called while a scheme generates random bytes
+    static void Stop();
+	/// \brief Returns true if a buffer is running
+    static bool IsRunning();
+	/// \brief Fills the output with random bytes from the running buffer
+	/// \param Output pointer to the output
+	/// \param Length number of random bytes
+    static void Generate(unsigned char* Output, size_t Length);
+	/// \brief Returns the counters of the running buffer, all zero without it
+    static Metrics GetMetrics();
+	/// \brief Returns the counters of the running buffer as a line for the log
+    static std::string GetReport();
+
+	/// \brief Construct a RandomBuffer and start the background thread
+	/// \param Capacity number of blocks, needs to be a power of two
+    RandomBuffer(uint32_t Capacity);
+	/// \brief Destruct a RandomBuffer and stop the background thread
+    ~RandomBuffer();
+    RandomBuffer(const RandomBuffer&) = delete;
+    RandomBuffer& operator=(const RandomBuffer&) = delete;
+
+    static const size_t cBlockSize = 64;
+
+private:
+    /// \brief One slot of random bytes
+    /// \details Moving a block wipes the source, so a block popped from the
+    /// ring does not stay in its slot until the slot is filled again
+    struct Block
+    {
+        Block() {}
+        Block(const Block&) = delete;
+        Block& operator=(const Block&) = delete;
+        Block& operator=(Block&& Other);
+        unsigned char Bytes[cBlockSize];
+    };
+	/// \brief Loop of the background thread
+    void Run();
+	/// \brief Pops blocks into the output, generates inline when the ring is empty
+	/// \param Output pointer to the output
+	/// \param Length number of random bytes
+    void Pop(unsigned char* Output, size_t Length);
+	/// \brief Returns the counters of this buffer
+    Metrics Collect() const;
+
+    BoundedQueue<Block> mRing;
+    std::atomic<bool> mStop;
+    std::atomic<uint64_t> mFilledBlocks;
+    std::atomic<uint64_t> mFillNanoseconds;
+    std::atomic<uint64_t> mPoppedBlocks;
+    std::atomic<uint64_t> mRequests;
+    std::atomic<uint64_t> mStarvedRequests;
+    std::chrono::steady_clock::time_point mStart;
+    std::thread mThread;
+    static const uint32_t cIdleMicroseconds = 50;
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+using namespace std;
+using namespace std::chrono;
+
+#include "ReplayTester.h"
+
+ReplayTester::ReplayTester(uint32_t Iterations,
+                           string& Logfile,
+                           string& Key,
+                           string& Nonce,
+                           const string& Workload,
+                           ICEScheme* CE,
+                           uint64_t Seed):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mNonce(Nonce),
+    mSend(1.0),
+    mDecrypt(1.0),
+    mVerify(0.0),
+    mCE(CE)
+{
+    ReadWorkload(Workload);
+    if (Seed == 0)
+    {
+        random_device Device;
+        Seed = ((uint64_t)Device() << 32) | Device();
+    }
+    mGenerator.seed(Seed);
+    vector<double> Counts;
+    uint32_t MaxSize = 0;
+    for (Entry& Message: mEntries)
+    {
+        Counts.push_back(Message.Count);
+        MaxSize = max(MaxSize, max(Message.MessageSize, Message.HeaderSize));
+    }
+    mDistribution = discrete_distribution<uint32_t>(Counts.begin(), Counts.end());
+    // Random data for the largest message, the messages and
+    // the headers are prefixes of it
+    string Random = RandomGenerator::Generate(MaxSize);
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Replay scheme: " + mCE->GetClassDecription(), true);
+    HandleOutput("Workload: " + Workload + " (" + to_string(mEntries.size()) + " sizes, seed " +
+                 to_string(Seed) + ")", true);
+    HandleOutput("Mix per message - Send: " + to_string(mSend) + ", Decrypt: " + to_string(mDecrypt) +
+                 ", Verify: " + to_string(mVerify), true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(mNonce.size()), false);
+    // Every size gets its own nonce and the ciphertext for decryption and verification
+    for (Entry& Message: mEntries)
+    {
+        IncreaseString(mNonce);
+        Message.Nonce = mNonce;
+        Message.H.assign(Random, 0, Message.HeaderSize);
+        Message.M.assign(Random, 0, Message.MessageSize);
+        mCE->SetNonce(Message.Nonce);
+        mCE->Enc(mKey, Message.H, Message.M, Message.C1, Message.C2);
+        if (!mCE->Dec(mKey, Message.H, Message.C1, Message.C2, mOutput, Message.Keyf) ||
+            !mCE->Ver(Message.H, Message.M, Message.Keyf, Message.C2))
+        {
+            throw runtime_error("Setup round failed.");
+        }
+    }
+}
+
+void ReplayTester::ReadWorkload(const string& Workload)
+{
+    ifstream WorkloadFile(Workload);
+    if (!WorkloadFile.is_open())
+    {
+        throw runtime_error("Could not open file: " + Workload);
+    }
+    string Line;
+    uint32_t LineNumber = 0;
+    while (getline(WorkloadFile, Line))
+    {
+        LineNumber++;
+        stringstream LineStream(Line);
+        string Command;
+        if (!(LineStream >> Command) || Command[0] == '#')
+        {
+            continue;
+        }
+        if ("mix" == Command)
+        {
+            if (!(LineStream >> mSend >> mDecrypt >> mVerify) ||
+                mSend < 0.0 || mDecrypt < 0.0 || mVerify < 0.0)
+            {
+                throw runtime_error("Not a valid mix in line " + to_string(LineNumber) + " of " + Workload);
+            }
+        }
+        else if ("msg" == Command)
+        {
+            Entry Message;
+            if (!(LineStream >> Message.MessageSize >> Message.HeaderSize >> Message.Count))
+            {
+                throw runtime_error("Not a valid message in line " + to_string(LineNumber) + " of " + Workload);
+            }
+            // Buckets are powers of two of the message size, 0 has its own bucket
+            Message.Bucket = Message.MessageSize == 0 ? 0 : 32 - __builtin_clz(Message.MessageSize);
+            mEntries.push_back(Message);
+        }
+        else
+        {
+            throw runtime_error("Unknown command " + Command + " in line " + to_string(LineNumber) + " of " + Workload);
+        }
+    }
+    if (mEntries.empty())
+    {
+        throw runtime_error("No messages in workload: " + Workload);
+    }
+}
+
+uint32_t ReplayTester::DrawOperations(double Expected)
+{
+    // The integer part is always done, the fraction with its probability
+    uint32_t Operations = (uint32_t)Expected;
+    if (uniform_real_distribution<double>(0.0, 1.0)(mGenerator) < Expected - Operations)
+    {
+        Operations++;
+    }
+    return Operations;
+}
+
+bool ReplayTester::TestRound()
+{
+    Entry& Message = mEntries[mDistribution(mGenerator)];
+    // Timer positions: encryption, decryption and verification per bucket
+    uint8_t Position = 3 * Message.Bucket;
+    if (Position + 2u >= mBytes.size())
+    {
+        mBytes.resize(Position + 3, 0);
+        mMessageBytes.resize(Position + 3, 0);
+    }
+    uint64_t Bytes = Message.HeaderSize + Message.MessageSize;
+    for (uint32_t i = DrawOperations(mSend); i > 0; i--)
+    {
+        // Increase Nonce, every send is a new message
+        IncreaseString(mNonce);
+        mCE->SetNonce(mNonce);
+        StartTime(Position);
+        mCE->Enc(mKey, Message.H, Message.M, mC1, mC2);
+        AddTime(Position);
+        mBytes[Position] += Bytes;
+        mMessageBytes[Position] += Message.MessageSize;
+    }
+    for (uint32_t i = DrawOperations(mDecrypt); i > 0; i--)
+    {
+        mCE->SetNonce(Message.Nonce);
+        StartTime(Position + 1);
+        bool Success = mCE->Dec(mKey, Message.H, Message.C1, Message.C2, mOutput, mKeyf);
+        AddTime(Position + 1);
+        mBytes[Position + 1] += Bytes;
+        mMessageBytes[Position + 1] += Message.MessageSize;
+        if (!Success)
+        {
+            HandleOutput("Decryption has failed");
+            return false;
+        }
+    }
+    for (uint32_t i = DrawOperations(mVerify); i > 0; i--)
+    {
+        StartTime(Position + 2);
+        bool Success = mCE->Ver(Message.H, Message.M, Message.Keyf, Message.C2);
+        AddTime(Position + 2);
+        mBytes[Position + 2] += Bytes;
+        mMessageBytes[Position + 2] += Message.MessageSize;
+        if (!Success)
+        {
+            HandleOutput("Verification has failed");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReplayTester::Run()
+{
+    // Warm up every size, the warmup is not part of the results
+    for (uint32_t i = 0; i < GetWarmup(); i++)
+    {
+        if (!TestRound())
+        {
+            HandleOutput("Warmup has failed");
+            return false;
+        }
+    }
+    ResetTime();
+    fill(mBytes.begin(), mBytes.end(), 0);
+    fill(mMessageBytes.begin(), mMessageBytes.end(), 0);
+    uint32_t Rounds = 0;
+    bool Success = true;
+    steady_clock::time_point Start = steady_clock::now();
+    while (!IsFinished(Rounds, Start))
+    {
+        if (!TestRound())
+        {
+            Success = false;
+            break;
+        }
+        Rounds++;
+    }
+    double Seconds = duration_cast<nanoseconds>(steady_clock::now() - Start).count() / 1e9;
+    // Time of all operations for the share of every bucket
+    double TotalTime = 0.0;
+    uint64_t TotalOperations = 0;
+    uint64_t TotalBytes = 0;
+    for (uint8_t Position = 0; Position < mBytes.size(); Position++)
+    {
+        TotalTime += GetHistogram(Position).GetMean() * GetHistogram(Position).GetCount();
+        TotalOperations += GetHistogram(Position).GetCount();
+        TotalBytes += mBytes[Position];
+    }
+    HandleOutput("");
+    HandleOutput("Replayed " + to_string(Rounds) + " messages, " + to_string(TotalOperations) + " operations - Throughput: " +
+                 to_string(TotalOperations / Seconds) + " operations/s, " + to_string(TotalBytes / Seconds / 1e6) + " MB/s");
+    const vector<string> Phases = {"Encryption", "Decryption", "Verification"};
+    const vector<string> Prefixes = {"enc", "dec", "ver"};
+    for (uint8_t Bucket = 0; 3 * Bucket < mBytes.size(); Bucket++)
+    {
+        uint8_t Position = 3 * Bucket;
+        uint64_t Operations = 0;
+        uint64_t BucketBytes = 0;
+        uint64_t MessageBytes = 0;
+        double BucketTime = 0.0;
+        for (uint8_t Phase = 0; Phase < 3; Phase++)
+        {
+            Operations += GetHistogram(Position + Phase).GetCount();
+            BucketBytes += mBytes[Position + Phase];
+            MessageBytes += mMessageBytes[Position + Phase];
+            BucketTime += GetHistogram(Position + Phase).GetMean() * GetHistogram(Position + Phase).GetCount();
+        }
+        if (Operations == 0)
+        {
+            continue;
+        }
+        uint64_t Lower = Bucket == 0 ? 0 : 1ull << (Bucket - 1);
+        uint64_t Upper = (1ull << Bucket) - 1;
+        string Label = "Message size " + to_string(Lower) + " to " + to_string(Upper);
+        HandleOutput("");
+        HandleOutput(Label + " - " + to_string(Operations) + " operations, " +
+                     to_string(TotalTime > 0.0 ? 100.0 * BucketTime / TotalTime : 0.0) + "% of the time");
+        // Mean sizes of the operations in the bucket, the bounds are extra fields
+        ResultRecord Record = CreateRecord("replay", mCE, (BucketBytes - MessageBytes) / Operations,
+                                           MessageBytes / Operations, mKey.size(), mNonce.size(), Rounds);
+        Record.Add("bucket_min", Lower);
+        Record.Add("bucket_max", Upper);
+        Record.Add("time_share", TotalTime > 0.0 ? BucketTime / TotalTime : 0.0);
+        for (uint8_t Phase = 0; Phase < 3; Phase++)
+        {
+            const Histogram& Samples = GetHistogram(Position + Phase);
+            // Average bytes of one operation for the cycles per byte
+            uint64_t Bytes = Samples.GetCount() == 0 ? 0 : mBytes[Position + Phase] / Samples.GetCount();
+            Record.AddPhase(Prefixes[Phase], Samples, GetCycles(Position + Phase), Bytes);
+            if (Samples.GetCount() == 0)
+            {
+                continue;
+            }
+            double CyclesPerByte = (double)GetCycles(Position + Phase) / max<uint64_t>(mBytes[Position + Phase], 1);
+            HandleOutput(Label + " - " + Phases[Phase] + " count: " + to_string(Samples.GetCount()) +
+                         ", mean: " + to_string(Samples.GetMean() / 1000000.0) +
+                         ", p99: " + to_string(Samples.GetPercentile(99.0) / 1000000.0) +
+                         " milliseconds, " + to_string(CyclesPerByte) + " cycles/byte");
+        }
+        WriteResult(Record);
+    }
+    if (!Success)
+    {
+        HandleOutput(string("Only ") + to_string(Rounds) + " out of "
+                     + to_string(GetTestIterations()) + " were successful.");
+    }
+    return Success;
+}
@@ -0,0 +1,94 @@
+#ifndef REPLAYTESTER_H
+#define REPLAYTESTER_H
+
+#include <string>
+#include <vector>
+#include <random>
+
+#include "Tester.h"
+
+/// \brief ReplayTester class which drives a CE scheme with a recorded workload
+/// \details The workload file lists the message and header sizes with their
+/// counts and the operation mix, e.g.
+///
+///     # expected sends, decryptions and verifications per message
+///     mix 1 1 0.01
+///     # message size, header size, count
+///     msg 64 0 5000
+///     msg 1048576 16 50
+///
+/// The buffers, ciphertexts and opening keys of every size are generated before
+/// the measurement. Every iteration draws one message from the size distribution
+/// and runs the operations of the mix on it. The results are reported per
+/// message size bucket (powers of two) and for the whole workload.
+class ReplayTester: public Tester
+{
+public:
+	/// \brief Construct a ReplayTester
+	/// \param Iterations number of replayed messages
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+	/// \param Workload path to the workload file
+	/// \param CE reference to the scheme to test
+	/// \param Seed seed for drawing the messages, 0 for a random seed
+    ReplayTester(uint32_t Iterations,
+                 std::string& Logfile,
+                 std::string& Key,
+                 std::string& Nonce,
+                 const std::string& Workload,
+                 ICEScheme* CE,
+                 uint64_t Seed = 0);
+    /// \brief Destruct a ReplayTester
+    /// \details Need to delete the scheme provided by the SchemeFactory
+    ~ReplayTester()
+    {
+        delete mCE;
+    }
+    /// \brief Draws one message and runs the operations of the mix on it
+    bool TestRound();
+    /// \brief Replays the workload and logs the results per size bucket
+    bool Run();
+
+private:
+    /// \brief One line of the workload with its pregenerated data
+    struct Entry
+    {
+        uint32_t MessageSize;
+        uint32_t HeaderSize;
+        uint32_t Count;
+        uint8_t Bucket;
+        std::string Nonce;
+        std::string H;
+        std::string M;
+        std::string C1;
+        std::string C2;
+        std::string Keyf;
+    };
+	/// \brief Parses the workload file
+	/// \param Workload path to the workload file
+    void ReadWorkload(const std::string& Workload);
+	/// \brief Returns how often an operation is done for the current message
+	/// \param Expected expected operations per message, the fraction is random
+    uint32_t DrawOperations(double Expected);
+
+    std::string mKey;
+    std::string mNonce;
+    std::vector<Entry> mEntries;
+    double mSend;
+    double mDecrypt;
+    double mVerify;
+    std::mt19937_64 mGenerator;
+    std::discrete_distribution<uint32_t> mDistribution;
+    // Processed bytes per timer position
+    std::vector<uint64_t> mBytes;
+    // Processed message bytes per timer position, the rest of mBytes is header
+    std::vector<uint64_t> mMessageBytes;
+    std::string mC1;
+    std::string mC2;
+    std::string mOutput;
+    std::string mKeyf;
+    ICEScheme* mCE;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include <fstream>
+#include <filesystem>
+#include <ctime>
+#include <cmath>
+using namespace std;
+
+#include "ResultWriter.h"
+
+// Set by the Makefile, so every record tells how the binary was built
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS "unknown"
+#endif
+
+void ResultRecord::Add(const string& Name, const string& Value)
+{
+    mFields.push_back({Name, {Value, true}});
+}
+
+void ResultRecord::Add(const string& Name, double Value)
+{
+    // nan and inf are no numbers in JSON, they stay empty (null)
+    mFields.push_back({Name, {isfinite(Value) ? to_string(Value) : "", false}});
+}
+
+void ResultRecord::Add(const string& Name, uint64_t Value)
+{
+    mFields.push_back({Name, {to_string(Value), false}});
+}
+
+void ResultRecord::AddPhase(const string& Phase, const Histogram& Samples, uint64_t Cycles, uint64_t Bytes)
+{
+    // Latencies are in nanoseconds, the fields in milliseconds
+    Add(Phase + "_count", Samples.GetCount());
+    Add(Phase + "_mean_ms", Samples.GetMean() / 1000000.0);
+    Add(Phase + "_stddev_ms", Samples.GetStandardDeviation() / 1000000.0);
+    Add(Phase + "_min_ms", Samples.GetMin() / 1000000.0);
+    Add(Phase + "_p50_ms", Samples.GetPercentile(50.0) / 1000000.0);
+    Add(Phase + "_p90_ms", Samples.GetPercentile(90.0) / 1000000.0);
+    Add(Phase + "_p99_ms", Samples.GetPercentile(99.0) / 1000000.0);
+    Add(Phase + "_p999_ms", Samples.GetPercentile(99.9) / 1000000.0);
+    Add(Phase + "_max_ms", Samples.GetMax() / 1000000.0);
+    double CyclesPerByte = 0.0;
+    if (Samples.GetCount() > 0 && Bytes > 0)
+    {
+        CyclesPerByte = (double)Cycles / ((double)Samples.GetCount() * Bytes);
+    }
+    Add(Phase + "_cycles_per_byte", CyclesPerByte);
+}
+
+const vector<pair<string, pair<string, bool>>>& ResultRecord::GetFields() const
+{
+    return mFields;
+}
+
+/*========================================================================*/
+
+ResultWriter::ResultWriter(const string& FileName):
+    cFileName(FileName),
+    cCSV(FileName.size() >= 4 && FileName.compare(FileName.size() - 4, 4, ".csv") == 0),
+    cCPUModel(GetCPUModel())
+{}
+
+bool ResultWriter::Write(const ResultRecord& Record)
+{
+    vector<pair<string, pair<string, bool>>> Fields;
+    Fields.push_back({"timestamp", {GetTimestamp(), true}});
+    Fields.insert(Fields.end(), Record.GetFields().begin(), Record.GetFields().end());
+    Fields.push_back({"cpu_model", {cCPUModel, true}});
+    Fields.push_back({"compiler", {__VERSION__, true}});
+    Fields.push_back({"compiler_flags", {COMPILER_FLAGS, true}});
+    string Line = "";
+    string FileName = cFileName;
+    if (cCSV)
+    {
+        string Columns = "";
+        for (auto& Field: Fields)
+        {
+            Columns += (Columns.empty() ? "" : ",") + EscapeCSV(Field.first);
+        }
+        // A new file starts with the names of the columns, the records of
+        // other columns go to the next file with the same columns
+        FileName = GetCSVFile(Columns);
+        if (!filesystem::exists(FileName) || filesystem::file_size(FileName) == 0)
+        {
+            Line += Columns + "\n";
+        }
+        string Values = "";
+        for (uint32_t i = 0; i < Fields.size(); i++)
+        {
+            Values += (i == 0 ? "" : ",") + EscapeCSV(Fields[i].second.first);
+        }
+        Line += Values;
+    }
+    else
+    {
+        Line = "{";
+        for (uint32_t i = 0; i < Fields.size(); i++)
+        {
+            Line += (i == 0 ? "\"" : ", \"") + EscapeJSON(Fields[i].first) + "\": ";
+            if (Fields[i].second.second)
+            {
+                Line += "\"" + EscapeJSON(Fields[i].second.first) + "\"";
+            }
+            else
+            {
+                Line += Fields[i].second.first.empty() ? "null" : Fields[i].second.first;
+            }
+        }
+        Line += "}";
+    }
+    fstream ResultFile(FileName, ios::out | ios::binary | ios::app);
+    if (ResultFile.is_open())
+    {
+        ResultFile << Line << endl;
+        ResultFile.close();
+        return true;
+    }
+    return false;
+}
+
+string ResultWriter::GetCSVFile(const string& Columns)
+{
+    // results.csv, results.1.csv, results.2.csv, ...
+    string Stem = cFileName.substr(0, cFileName.size() - 4);
+    for (uint32_t i = 0; ; i++)
+    {
+        string FileName = i == 0 ? cFileName : Stem + "." + to_string(i) + ".csv";
+        ifstream ResultFile(FileName);
+        string Header;
+        if (!ResultFile.is_open() || !getline(ResultFile, Header) || Header == Columns)
+        {
+            return FileName;
+        }
+    }
+}
+
+string ResultWriter::GetTimestamp()
+{
+    time_t Now = time(NULL);
+    struct tm UTC;
+    gmtime_r(&Now, &UTC);
+    char Buffer[32];
+    strftime(Buffer, sizeof(Buffer), "%Y-%m-%dT%H:%M:%SZ", &UTC);
+    return string(Buffer);
+}
+
+string ResultWriter::GetCPUModel()
+{
+    ifstream CPUInfo("/proc/cpuinfo");
+    string Line;
+    while (getline(CPUInfo, Line))
+    {
+        if (Line.compare(0, 10, "model name") == 0)
+        {
+            size_t First = Line.find(':');
+            if (First != string::npos && First + 2 <= Line.size())
+            {
+                return Line.substr(First + 2);
+            }
+        }
+    }
+    return "unknown";
+}
+
+string ResultWriter::EscapeJSON(const string& Value)
+{
+    string Escaped = "";
+    for (unsigned char Char: Value)
+    {
+        if (Char == '"' || Char == '\\')
+        {
+            Escaped += '\\';
+            Escaped += Char;
+        }
+        else if (Char < 0x20)
+        {
+            char Buffer[8];
+            snprintf(Buffer, sizeof(Buffer), "\\u%04x", Char);
+            Escaped += Buffer;
+        }
+        else
+        {
+            Escaped += Char;
+        }
+    }
+    return Escaped;
+}
+
+string ResultWriter::EscapeCSV(const string& Value)
+{
+    if (Value.find_first_of(",\"\n") == string::npos)
+    {
+        return Value;
+    }
+    string Escaped = "\"";
+    for (char Char: Value)
+    {
+        if (Char == '"')
+        {
+            Escaped += '"';
+        }
+        Escaped += Char;
+    }
+    return Escaped + "\"";
+}
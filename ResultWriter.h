@@ -0,0 +1,83 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "Histogram.h"
+
+/// \brief ResultRecord class which collects the fields of one result
+/// \details The fields keep the order in which they were added, which
+/// is also the column order for CSV
+class ResultRecord
+{
+public:
+	/// \brief Construct an empty ResultRecord
+    ResultRecord() {}
+	/// \brief Destruct a ResultRecord
+    ~ResultRecord() {}
+	/// \brief Adds a text field
+	/// \param Name of the field
+	/// \param Value of the field
+    void Add(const std::string& Name, const std::string& Value);
+	/// \brief Adds a number field
+	/// \param Name of the field
+	/// \param Value of the field
+    void Add(const std::string& Name, double Value);
+	/// \brief Adds a number field
+	/// \param Name of the field
+	/// \param Value of the field
+    void Add(const std::string& Name, uint64_t Value);
+	/// \brief Adds the statistics of a phase
+	/// \param Phase prefix for the fields, e.g. "enc"
+	/// \param Samples latencies of the phase in nanoseconds
+	/// \param Cycles added cycles of the phase, 0 if unknown
+	/// \param Bytes processed bytes of one iteration for the cycles per byte
+    void AddPhase(const std::string& Phase, const Histogram& Samples, uint64_t Cycles, uint64_t Bytes);
+    /// \brief Returns the fields as (name, value, is text)
+    const std::vector<std::pair<std::string, std::pair<std::string, bool>>>& GetFields() const;
+
+private:
+    std::vector<std::pair<std::string, std::pair<std::string, bool>>> mFields;
+};
+
+/// \brief ResultWriter class which writes one record per run to a file
+/// \details Writes CSV if the file ends with .csv and JSON lines otherwise.
+/// Every record gets a timestamp, the cpu model and the compiler flags.
+/// A CSV file only gets records of its columns, records of other columns
+/// (another tester) go to results.1.csv, results.2.csv and so on.
+/// Numbers which are not finite are empty in CSV and null in JSON
+class ResultWriter
+{
+public:
+	/// \brief Construct a ResultWriter
+	/// \param FileName path of the result file, the records get appended
+    ResultWriter(const std::string& FileName);
+	/// \brief Destruct a ResultWriter
+    ~ResultWriter() {}
+	/// \brief Appends the record to the result file
+	/// \param Record the result to write
+    bool Write(const ResultRecord& Record);
+
+private:
+	/// \brief Returns the CSV file for records with these columns
+	/// \param Columns the header line of the records
+    std::string GetCSVFile(const std::string& Columns);
+	/// \brief Returns the current time in ISO 8601 format (UTC)
+    static std::string GetTimestamp();
+	/// \brief Returns the cpu model from /proc/cpuinfo
+    static std::string GetCPUModel();
+	/// \brief Escapes a string for JSON
+	/// \param Value the string to escape
+    static std::string EscapeJSON(const std::string& Value);
+	/// \brief Escapes a string for CSV
+	/// \param Value the string to escape
+    static std::string EscapeCSV(const std::string& Value);
+
+    const std::string cFileName;
+    const bool cCSV;
+    const std::string cCPUModel;
+};
+
+#endif
@@ -142,3 +142,46 @@ SymmetricCipher* SchemeFactory::CreatePRG(string& PRG)
     }
     throw runtime_error("Not a valid PRG scheme: " + PRG);
 }
+
+MessageAuthenticationCode* SchemeFactory::CreateMAC(const MessageAuthenticationCode* MAC)
+{
+    if (dynamic_cast<const HMAC<SHA256>*>(MAC))
+    {
+        return new HMAC<SHA256>();
+    }
+    if (dynamic_cast<const HMAC<SHA512>*>(MAC))
+    {
+        return new HMAC<SHA512>();
+    }
+    if (dynamic_cast<const HMAC<SHA3_256>*>(MAC))
+    {
+        return new HMAC<SHA3_256>();
+    }
+    if (dynamic_cast<const HMAC<Whirlpool>*>(MAC))
+    {
+        return new HMAC<Whirlpool>();
+    }
+    throw runtime_error("Can not copy mac scheme: " + MAC->AlgorithmName());
+}
+
+SymmetricCipher* SchemeFactory::CreateCipher(const SymmetricCipher* Cipher)
+{
+    if (dynamic_cast<const CBC_Mode<AES>::Encryption*>(Cipher))
+    {
+        return new CBC_Mode<AES>::Encryption();
+    }
+    if (dynamic_cast<const CBC_Mode<AES>::Decryption*>(Cipher))
+    {
+        return new CBC_Mode<AES>::Decryption();
+    }
+    // The CTR decryption is the same type as the encryption
+    if (dynamic_cast<const CTR_Mode<AES>::Encryption*>(Cipher))
+    {
+        return new CTR_Mode<AES>::Encryption();
+    }
+    if (dynamic_cast<const ChaCha::Encryption*>(Cipher))
+    {
+        return new ChaCha::Encryption();
+    }
+    throw runtime_error("Can not copy cipher scheme: " + Cipher->AlgorithmName());
+}
@@ -54,6 +54,15 @@ public:
 	/// \param PRG name of the PRG scheme
     /// \details Will be used for the PRG in the CEP scheme
     CryptoPP::SymmetricCipher* CreatePRG(string& PRG);
+    /// \brief Creates a new MAC of the same type
+	/// \param MAC the MAC to copy, the key and the state are not copied
+    /// \details Used by the Clone functions of the schemes
+    static CryptoPP::MessageAuthenticationCode* CreateMAC(const CryptoPP::MessageAuthenticationCode* MAC);
+    /// \brief Creates a new cipher of the same type
+	/// \param Cipher the encryption, decryption or PRG to copy,
+    /// the key and the state are not copied
+    /// \details Used by the Clone functions of the schemes
+    static CryptoPP::SymmetricCipher* CreateCipher(const CryptoPP::SymmetricCipher* Cipher);
 };
 
 #endif
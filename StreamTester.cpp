@@ -0,0 +1,236 @@
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+#include "StreamTester.h"
+
+StreamTester::StreamTester(uint32_t Iterations,
+                           string& Logfile,
+                           string& Key,
+                           string& Nonce,
+                           string& Header,
+                           const string& Message,
+                           const string& Cipherfile,
+                           size_t ChunkSize,
+                           ICEScheme* CE):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mNonce(Nonce),
+    mH(Tester::ReadImage(Header)),
+    mMessageFile(Message),
+    mCipherFile(Cipherfile),
+    mChunkSize(ChunkSize),
+    mMessageSize(0),
+    mCipherSize(0),
+    mInput(ChunkSize, 0x00),
+    mOutput(""),
+    mC2(""),
+    mKeyf(""),
+    mCE(CE)
+{
+    if (mChunkSize == 0)
+    {
+        throw runtime_error("Need a chunk size above 0 for the stream test");
+    }
+    if (!filesystem::exists(mMessageFile))
+    {
+        throw runtime_error("Could not open file: " + mMessageFile);
+    }
+    mMessageSize = filesystem::file_size(mMessageFile);
+    // Output of one chunk, the Finish functions get more if the scheme needs it
+    mOutput.resize(mChunkSize + mCE->GetStreamBlockSize());
+    mCE->SetNonce(mNonce);
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Stream scheme: " + mCE->GetClassDecription(), true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(mNonce.size()), false);
+    HandleOutput("Header size: " + to_string(mH.size()), false);
+    HandleOutput("Message file: " + mMessageFile + " (size: " + to_string(mMessageSize) + ")", false);
+    HandleOutput("Chunk size: " + to_string(mChunkSize), false);
+    // Test round to setup the cipher file
+    if (!EncryptFile() || !DecryptFile() || !VerifyFile())
+    {
+        throw runtime_error("Setup round failed.");
+    }
+}
+
+bool StreamTester::TestRound()
+{
+    // Increase Nonce
+    IncreaseString(mNonce);
+    mCE->SetNonce(mNonce);
+    // Encryption
+    StartTime(0);
+    bool Success = EncryptFile();
+    AddTime(0);
+    if (!Success)
+    {
+        return false;
+    }
+    // Decryption
+    StartTime(1);
+    Success = DecryptFile();
+    AddTime(1);
+    if (!Success)
+    {
+        return false;
+    }
+    // Verification
+    StartTime(2);
+    Success = VerifyFile();
+    AddTime(2);
+    return Success;
+}
+
+bool StreamTester::Run()
+{
+    bool Success = Tester::Run();
+    // Throughput of the mean time, the file accesses are included
+    uint64_t Bytes = mH.size() + mMessageSize;
+    const vector<string> Phases = {"Encryption", "Decryption", "Verification"};
+    HandleOutput("");
+    for (uint8_t Phase = 0; Phase < 3; Phase++)
+    {
+        double Seconds = GetHistogram(Phase).GetMean() / 1e9;
+        HandleOutput(Phases[Phase] + " throughput: " +
+                     to_string(Seconds > 0.0 ? Bytes / Seconds / 1e6 : 0.0) + " MB/s");
+    }
+    ResultRecord Record = CreateRecord("stream", mCE, mH.size(), mMessageSize, mKey.size(),
+                                       mNonce.size(), GetHistogram(0).GetCount());
+    Record.Add("chunk_size", (uint64_t)mChunkSize);
+    AddPhases(Record, Bytes);
+    WriteResult(Record);
+    return Success;
+}
+
+bool StreamTester::EncryptFile()
+{
+    ifstream In(mMessageFile, ios::in | ios::binary);
+    ofstream Out(mCipherFile, ios::out | ios::binary | ios::trunc);
+    if (!In.is_open() || !Out.is_open())
+    {
+        HandleOutput("Could not open the message or the cipher file");
+        return false;
+    }
+    mCE->StartEnc(mKey, (const unsigned char*)mH.data(), mH.size());
+    uint64_t Written = 0;
+    for (uint64_t Rest = mMessageSize; Rest > 0;)
+    {
+        size_t Length = ReadChunk(In, Rest);
+        if (Length == 0)
+        {
+            HandleOutput("Could not read the message file");
+            return false;
+        }
+        Rest -= Length;
+        size_t C1Length = mOutput.size();
+        mCE->UpdateEnc((const unsigned char*)mInput.data(), Length, (unsigned char*)&mOutput[0], C1Length);
+        Out.write(mOutput.data(), C1Length);
+        Written += C1Length;
+    }
+    // The rest of C1, schemes which buffer the message write all of C1 here
+    size_t C1Length = mCE->GetCiphertextSize(mH.size(), mMessageSize) - Written;
+    if (mOutput.size() < C1Length)
+    {
+        mOutput.resize(C1Length);
+    }
+    mC2.resize(mCE->GetCommitmentSize());
+    size_t C2Length = mC2.size();
+    mCE->FinishEnc((unsigned char*)&mOutput[0], C1Length, (unsigned char*)&mC2[0], C2Length);
+    mC2.resize(C2Length);
+    Out.write(mOutput.data(), C1Length);
+    mCipherSize = Written + C1Length;
+    if (!Out.good())
+    {
+        HandleOutput("Could not write the cipher file");
+        return false;
+    }
+    return true;
+}
+
+bool StreamTester::DecryptFile()
+{
+    ifstream In(mCipherFile, ios::in | ios::binary);
+    size_t TrailerSize = mCE->GetTrailerSize();
+    if (!In.is_open() || mCipherSize < TrailerSize)
+    {
+        HandleOutput("Could not open the cipher file");
+        return false;
+    }
+    // The trailer is the end of C1 and is needed first
+    string Trailer(TrailerSize, 0x00);
+    In.seekg(mCipherSize - TrailerSize);
+    In.read(&Trailer[0], TrailerSize);
+    In.seekg(0);
+    mCE->StartDec(mKey, (const unsigned char*)mH.data(), mH.size(),
+                  (const unsigned char*)mC2.data(), mC2.size(),
+                  (const unsigned char*)Trailer.data(), Trailer.size());
+    uint64_t Written = 0;
+    for (uint64_t Rest = mCipherSize - TrailerSize; Rest > 0;)
+    {
+        size_t Length = ReadChunk(In, Rest);
+        if (Length == 0)
+        {
+            HandleOutput("Could not read the cipher file");
+            return false;
+        }
+        Rest -= Length;
+        // The message is not kept, the verification reads the message file
+        size_t MessageLength = mOutput.size();
+        mCE->UpdateDec((const unsigned char*)mInput.data(), Length, (unsigned char*)&mOutput[0], MessageLength);
+        Written += MessageLength;
+    }
+    size_t MessageLength = mCE->GetMaxPlaintextSize(mCipherSize) - Written;
+    if (mOutput.size() < MessageLength)
+    {
+        mOutput.resize(MessageLength);
+    }
+    if (!mCE->FinishDec((unsigned char*)&mOutput[0], MessageLength, mKeyf) ||
+        Written + MessageLength != mMessageSize)
+    {
+        HandleOutput("Decryption has failed");
+        return false;
+    }
+    return true;
+}
+
+bool StreamTester::VerifyFile()
+{
+    ifstream In(mMessageFile, ios::in | ios::binary);
+    if (!In.is_open())
+    {
+        HandleOutput("Could not open the message file");
+        return false;
+    }
+    mCE->StartVer((const unsigned char*)mH.data(), mH.size(), mKeyf,
+                  (const unsigned char*)mC2.data(), mC2.size());
+    for (uint64_t Rest = mMessageSize; Rest > 0;)
+    {
+        size_t Length = ReadChunk(In, Rest);
+        if (Length == 0)
+        {
+            HandleOutput("Could not read the message file");
+            return false;
+        }
+        Rest -= Length;
+        mCE->UpdateVer((const unsigned char*)mInput.data(), Length);
+    }
+    if (!mCE->FinishVer())
+    {
+        HandleOutput("Verification has failed");
+        return false;
+    }
+    return true;
+}
+
+size_t StreamTester::ReadChunk(ifstream& In, uint64_t Rest)
+{
+    In.read(&mInput[0], min<uint64_t>(Rest, mChunkSize));
+    return In.gcount();
+}
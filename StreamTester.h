@@ -0,0 +1,75 @@
+#ifndef STREAMTESTER_H
+#define STREAMTESTER_H
+
+#include <string>
+#include <fstream>
+
+#include "Tester.h"
+
+/// \brief StreamTester class which tests the incremental functions of a CE scheme
+/// \details The message is read from a file in chunks and C1 is written to a file,
+/// so the memory does not grow with the message size and messages above 4 GiB
+/// can be tested. The decryption reads the trailer at the end of C1 first and then
+/// C1 in chunks, the verification reads the message file again. The times include
+/// the file accesses, so the throughput shows if the disk or the scheme is the limit.
+class StreamTester: public Tester
+{
+public:
+	/// \brief Construct a StreamTester
+	/// \param Iterations number of enc, dec and ver
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+	/// \param Header for the tester, can be path to image or string
+	/// \param Message path to the message file
+	/// \param Cipherfile path of the file for C1, it is overwritten
+	/// \param ChunkSize bytes of one read from the message or C1 file
+	/// \param CE reference to the scheme to test
+    StreamTester(uint32_t Iterations,
+                 std::string& Logfile,
+                 std::string& Key,
+                 std::string& Nonce,
+                 std::string& Header,
+                 const std::string& Message,
+                 const std::string& Cipherfile,
+                 size_t ChunkSize,
+                 ICEScheme* CE);
+    /// \brief Destruct a StreamTester
+    /// \details Need to delete the scheme provided by the SchemeFactory
+    ~StreamTester()
+    {
+        delete mCE;
+    }
+    /// \brief Streams enc, dec and ver of the scheme and measures time
+    bool TestRound();
+    /// \brief Runs all iterations, logs the throughput and writes the result record
+    bool Run();
+
+private:
+    /// \brief Encrypts the message file into the cipher file
+    bool EncryptFile();
+    /// \brief Decrypts the cipher file, the message is not kept
+    bool DecryptFile();
+    /// \brief Verifies the message file for the commitment
+    bool VerifyFile();
+	/// \brief Reads the next chunk into the input buffer
+	/// \param In the file to read from
+	/// \param Rest bytes left to read
+    size_t ReadChunk(std::ifstream& In, uint64_t Rest);
+
+    std::string mKey;
+    std::string mNonce;
+    std::string mH;
+    std::string mMessageFile;
+    std::string mCipherFile;
+    size_t mChunkSize;
+    uint64_t mMessageSize;
+    uint64_t mCipherSize;
+    std::string mInput;
+    std::string mOutput;
+    std::string mC2;
+    std::string mKeyf;
+    ICEScheme* mCE;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+using namespace std;
+using namespace std::chrono;
+
+#include "SweepTester.h"
+
+SweepTester::SweepTester(uint32_t Iterations,
+                         string& Logfile,
+                         string& Key,
+                         string& Nonce,
+                         vector<uint32_t>& MessageSizes,
+                         vector<uint32_t>& HeaderSizes,
+                         uint64_t BytesPerPoint,
+                         ICEScheme* CE):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mNonce(Nonce),
+    mMessageSizes(MessageSizes),
+    mHeaderSizes(HeaderSizes),
+    mBytesPerPoint(BytesPerPoint),
+    mRandom(""),
+    mCE(CE)
+{
+    if (mMessageSizes.empty() || mHeaderSizes.empty())
+    {
+        throw runtime_error("Empty grid for the sweep");
+    }
+    // Random data for the largest message, smaller messages and
+    // the headers are prefixes of it
+    uint32_t MaxSize = max(*max_element(mMessageSizes.begin(), mMessageSizes.end()),
+                           *max_element(mHeaderSizes.begin(), mHeaderSizes.end()));
+    mRandom = RandomGenerator::Generate(MaxSize);
+    // Set parameters for the scheme to test
+    mCE->SetNonce(mNonce);
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Sweep scheme: " + mCE->GetClassDecription(), true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(mNonce.size()), false);
+    HandleOutput("Message sizes: " + to_string(mMessageSizes.front()) + " to " +
+                 to_string(mMessageSizes.back()) + " (" + to_string(mMessageSizes.size()) + " points)", false);
+    HandleOutput("Header sizes: " + to_string(mHeaderSizes.front()) + " to " +
+                 to_string(mHeaderSizes.back()) + " (" + to_string(mHeaderSizes.size()) + " points)", false);
+}
+
+bool SweepTester::TestRound()
+{
+    // Increase Nonce
+    IncreaseString(mNonce);
+    mCE->SetNonce(mNonce);
+    // Encryption
+    StartTime(0);
+    mCE->Enc(mKey, mH, mM, mC1, mC2);
+    AddTime(0);
+    // Decryption
+    StartTime(1);
+    bool Success = mCE->Dec(mKey, mH, mC1, mC2, mOutput, mKeyf);
+    AddTime(1);
+    if (!Success)
+    {
+        HandleOutput("Decryption has failed");
+        return false;
+    }
+    // Verification
+    StartTime(2);
+    Success = mCE->Ver(mH, mOutput, mKeyf, mC2);
+    AddTime(2);
+    if (!Success)
+    {
+        HandleOutput("Verification has failed");
+        return false;
+    }
+    return true;
+}
+
+bool SweepTester::Run()
+{
+    HandleOutput("");
+    for (uint32_t HeaderSize: mHeaderSizes)
+    {
+        for (uint32_t MessageSize: mMessageSizes)
+        {
+            if (!RunPoint(HeaderSize, MessageSize))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SweepTester::RunPoint(uint32_t HeaderSize, uint32_t MessageSize)
+{
+    mH.assign(mRandom, 0, HeaderSize);
+    mM.assign(mRandom, 0, MessageSize);
+    // Large messages get less iterations to keep the time per point bounded
+    uint64_t PointBytes = max<uint64_t>(HeaderSize + MessageSize, 1);
+    uint32_t Iterations = (uint32_t)min<uint64_t>(GetTestIterations(),
+                                                  max<uint64_t>(cMinPointIterations, mBytesPerPoint / PointBytes));
+    // Rounds to setup the sizes for the members and to warm up, not measured
+    for (uint32_t i = 0; i < max<uint32_t>(GetWarmup(), 1); i++)
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+    }
+    ResetTime();
+    // Like Tester::Run the point stops early when the median converged
+    // or the time budget of the point is used up
+    uint32_t Rounds = 0;
+    steady_clock::time_point Start = steady_clock::now();
+    while (Rounds < Iterations && !IsFinished(Rounds, Start))
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+        Rounds++;
+    }
+    string Output = "Header: " + to_string(HeaderSize) + ", Message: " + to_string(MessageSize) +
+                    ", Iterations: " + to_string(Rounds);
+    const vector<string> Phases = {"Encryption", "Decryption", "Verification"};
+    for (uint8_t Phase = 0; Phase < Phases.size(); Phase++)
+    {
+        const Histogram& Samples = GetHistogram(Phase);
+        double CyclesPerByte = (double)GetCycles(Phase) / ((double)Rounds * PointBytes);
+        Output += " - " + Phases[Phase] +
+                  " mean: " + to_string(Samples.GetMean() / 1000000.0) +
+                  ", p99: " + to_string(Samples.GetPercentile(99.0) / 1000000.0) +
+                  " milliseconds, " + to_string(CyclesPerByte) + " cycles/byte";
+        if (HasPerfCounters())
+        {
+            Output += " (counters " + GetCounterSummary(Phase, PointBytes) + ")";
+        }
+    }
+    HandleOutput(Output);
+    ResultRecord Record = CreateRecord("sweep", mCE, HeaderSize, MessageSize, mKey.size(),
+                                       mNonce.size(), Rounds);
+    AddPhases(Record, PointBytes);
+    WriteResult(Record);
+    return true;
+}
+
+vector<uint32_t> SweepTester::GeometricGrid(uint32_t Min, uint32_t Max, uint32_t Factor)
+{
+    if (Factor < 2)
+    {
+        throw runtime_error("The factor of a grid needs to be at least 2");
+    }
+    vector<uint32_t> Grid;
+    uint64_t Value = Min;
+    if (Value == 0)
+    {
+        Grid.push_back(0);
+        Value = 1;
+    }
+    for (; Value < Max; Value *= Factor)
+    {
+        Grid.push_back((uint32_t)Value);
+    }
+    if (Grid.empty() || Grid.back() != Max)
+    {
+        Grid.push_back(Max);
+    }
+    return Grid;
+}
@@ -0,0 +1,72 @@
+#ifndef SWEEPTESTER_H
+#define SWEEPTESTER_H
+
+#include <string>
+#include <vector>
+
+#include "Tester.h"
+
+/// \brief SweepTester class which tests a CE scheme for a grid of message and header sizes
+/// \details Instead of one fixed message the tester generates random messages and
+/// headers for every point of the grid and logs the latency and the cycles per byte
+/// of encryption, decryption and verification, which gives a throughput curve per scheme
+class SweepTester: public Tester
+{
+public:
+	/// \brief Construct a SweepTester
+	/// \param Iterations maximal number of enc, dec and ver for one point of the grid
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+	/// \param MessageSizes grid of the message sizes in bytes
+	/// \param HeaderSizes grid of the header sizes in bytes
+	/// \param BytesPerPoint the iterations of a point are reduced to process about this many bytes
+	/// \param CE reference to the scheme to test
+    SweepTester(uint32_t Iterations,
+                std::string& Logfile,
+                std::string& Key,
+                std::string& Nonce,
+                std::vector<uint32_t>& MessageSizes,
+                std::vector<uint32_t>& HeaderSizes,
+                uint64_t BytesPerPoint,
+                ICEScheme* CE);
+    /// \brief Destruct a SweepTester
+    /// \details Need to delete the scheme provided by the SchemeFactory
+    ~SweepTester()
+    {
+        delete mCE;
+    }
+    /// \brief Calls enc, dec and ver of the scheme and measures time
+    bool TestRound();
+    /// \brief Tests every point of the grid and logs the results
+    bool Run();
+    /// \brief Returns a geometric grid from Min to Max
+	/// \param Min first value of the grid
+	/// \param Max last value of the grid, always contained
+	/// \param Factor factor between two values of the grid
+    /// \details A Min of 0 adds 0 and continues with 1
+    static std::vector<uint32_t> GeometricGrid(uint32_t Min, uint32_t Max, uint32_t Factor);
+
+private:
+	/// \brief Tests one point of the grid
+	/// \param HeaderSize size of the header for this point
+	/// \param MessageSize size of the message for this point
+    bool RunPoint(uint32_t HeaderSize, uint32_t MessageSize);
+
+    std::string mKey;
+    std::string mNonce;
+    std::vector<uint32_t> mMessageSizes;
+    std::vector<uint32_t> mHeaderSizes;
+    uint64_t mBytesPerPoint;
+    std::string mRandom;
+    std::string mH;
+    std::string mM;
+    std::string mC1;
+    std::string mC2;
+    std::string mOutput;
+    std::string mKeyf;
+    ICEScheme* mCE;
+    const uint32_t cMinPointIterations = 5;
+};
+
+#endif
@@ -3,6 +3,11 @@
 #include <filesystem>
 #include <ctime>
 #include <string.h>
+#include <thread>
+#include <limits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 using namespace std;
 using namespace std::chrono;
 
@@ -12,23 +17,175 @@ void Timer::StartTime(uint8_t VectorPosition)
 {
     if (VectorPosition >= mStartTimes.size())
     {
-        mStartTimes.resize(VectorPosition + 1);
+        Resize(VectorPosition);
+    }
+    // Counters first, so reading them is not part of the time
+    if (mPerf && !mPerf->Read(mStartCounters[VectorPosition].data()))
+    {
+        mUncounted[VectorPosition] = true;
     }
     mStartTimes[VectorPosition] = high_resolution_clock::now();
+    mStartCycles[VectorPosition] = ReadCycles();
 }
 
 void Timer::AddTime(uint8_t VectorPosition)
 {
+    uint64_t StopCycles = ReadCycles();
     high_resolution_clock::time_point StopTime = high_resolution_clock::now();
     if (VectorPosition >= mStartTimes.size())
     {
-        mStartTimes.resize(VectorPosition + 1);
+        Resize(VectorPosition);
     }
-    if (VectorPosition >= mDurations.size())
+    nanoseconds Duration = duration_cast<nanoseconds>(StopTime - mStartTimes[VectorPosition]);
+    mDurations[VectorPosition] += Duration;
+    mCycles[VectorPosition] += StopCycles - mStartCycles[VectorPosition];
+    mHistograms[VectorPosition].Record(Duration.count());
+    if (mPerf)
+    {
+        uint64_t StopCounters[PerfCounters::EventCount];
+        if (!mPerf->Read(StopCounters))
+        {
+            mUncounted[VectorPosition] = true;
+        }
+        for (uint32_t i = 0; i < PerfCounters::EventCount; i++)
+        {
+            mCounters[VectorPosition][i] += StopCounters[i] - mStartCounters[VectorPosition][i];
+        }
+    }
+}
+
+void Timer::ResetTime()
+{
+    for (uint32_t i = 0; i < mDurations.size(); i++)
+    {
+        mDurations[i] = nanoseconds::zero();
+        mCycles[i] = 0;
+        mHistograms[i].Reset();
+        mCounters[i].fill(0);
+        mUncounted[i] = false;
+    }
+}
+
+uint64_t Timer::GetCycles(uint8_t VectorPosition)
+{
+    if (VectorPosition >= mCycles.size())
+    {
+        Resize(VectorPosition);
+    }
+    return mCycles[VectorPosition];
+}
+
+uint64_t Timer::ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+void Timer::Resize(uint8_t VectorPosition)
+{
+    mStartTimes.resize(VectorPosition + 1);
+    mStartCycles.resize(VectorPosition + 1);
+    mDurations.resize(VectorPosition + 1);
+    mCycles.resize(VectorPosition + 1);
+    mHistograms.resize(VectorPosition + 1);
+    mStartCounters.resize(VectorPosition + 1);
+    mCounters.resize(VectorPosition + 1);
+    mUncounted.resize(VectorPosition + 1, false);
+}
+
+bool Timer::EnablePerfCounters()
+{
+    mPerf.reset(new PerfCounters());
+    if (!mPerf->IsAvailable())
+    {
+        // Kept for GetPerfCountersError, the counters are closed
+        mPerfError = mPerf->GetError();
+        mPerf.reset();
+        return false;
+    }
+    mPerfError.clear();
+    return true;
+}
+
+bool Timer::HasPerfCounters()
+{
+    return (bool)mPerf;
+}
+
+string Timer::GetPerfCountersError()
+{
+    return mPerfError;
+}
+
+uint64_t Timer::GetCounter(uint8_t VectorPosition, PerfCounters::Event Counter)
+{
+    if (VectorPosition >= mCounters.size())
+    {
+        Resize(VectorPosition);
+    }
+    return mCounters[VectorPosition][Counter];
+}
+
+bool Timer::HasCounters(uint8_t VectorPosition)
+{
+    if (VectorPosition >= mUncounted.size())
+    {
+        Resize(VectorPosition);
+    }
+    return mPerf && !mUncounted[VectorPosition];
+}
+
+string Timer::GetCounterSummary(uint8_t VectorPosition, uint64_t Bytes)
+{
+    if (!HasCounters(VectorPosition))
     {
-        mDurations.resize(VectorPosition + 1);
+        return "unavailable";
+    }
+    double Iterations = max<uint64_t>(GetHistogram(VectorPosition).GetCount(), 1);
+    double Cycles = GetCounter(VectorPosition, PerfCounters::Cycles);
+    string Summary = "";
+    if (mPerf->IsAvailable(PerfCounters::Instructions) && Cycles > 0)
+    {
+        Summary += "IPC: " + to_string(GetCounter(VectorPosition, PerfCounters::Instructions) / Cycles) + ", ";
+    }
+    Summary += to_string(Cycles / (Iterations * max<uint64_t>(Bytes, 1))) + " cycles/byte";
+    for (uint32_t i = PerfCounters::BranchMisses; i < PerfCounters::EventCount; i++)
+    {
+        PerfCounters::Event Counter = (PerfCounters::Event)i;
+        if (mPerf->IsAvailable(Counter))
+        {
+            Summary += ", " + PerfCounters::GetEventName(Counter) + ": " +
+                       to_string(GetCounter(VectorPosition, Counter) / Iterations);
+        }
     }
-    mDurations[VectorPosition] += duration_cast<nanoseconds>(StopTime - mStartTimes[VectorPosition]);
+    return Summary + " per iteration";
+}
+
+bool Timer::IsConverged(double RelativeError)
+{
+    for (const Histogram& Samples: mHistograms)
+    {
+        if (!IsConverged(Samples, RelativeError))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Timer::IsConverged(const Histogram& Samples, double RelativeError)
+{
+    if (Samples.GetCount() == 0)
+    {
+        return true;
+    }
+    uint64_t Lower = 0;
+    uint64_t Upper = 0;
+    Samples.GetMedianInterval(Lower, Upper);
+    return (Upper - Lower) / 2.0 <= RelativeError * Samples.GetPercentile(50.0);
 }
 
 double Timer::GetTime(uint8_t VectorPosition)
@@ -36,16 +193,44 @@ double Timer::GetTime(uint8_t VectorPosition)
     return mDurations[VectorPosition].count() / 1000000;
 }
 
+const Histogram& Timer::GetHistogram(uint8_t VectorPosition)
+{
+    if (VectorPosition >= mHistograms.size())
+    {
+        Resize(VectorPosition);
+    }
+    return mHistograms[VectorPosition];
+}
+
+string Timer::GetLatencySummary(uint8_t VectorPosition)
+{
+    return GetLatencySummary(GetHistogram(VectorPosition));
+}
+
+string Timer::GetLatencySummary(const Histogram& Samples)
+{
+    // Samples are in nanoseconds, the output in milliseconds
+    string Summary = "p50: " + to_string(Samples.GetPercentile(50.0) / 1000000.0) +
+                     ", p90: " + to_string(Samples.GetPercentile(90.0) / 1000000.0) +
+                     ", p99: " + to_string(Samples.GetPercentile(99.0) / 1000000.0) +
+                     ", p99.9: " + to_string(Samples.GetPercentile(99.9) / 1000000.0) +
+                     ", max: " + to_string(Samples.GetMax() / 1000000.0) +
+                     " milliseconds, standard deviation: " + to_string(Samples.GetStandardDeviation() / 1000000.0) +
+                     " milliseconds";
+    return Summary;
+}
+
 void Timer::PrintTime(uint32_t TestRounds, uint8_t VectorPosition, string Description)
 {
     if (VectorPosition >= mDurations.size())
     {
-        mDurations.resize(VectorPosition + 1);
+        Resize(VectorPosition);
     }
     double Milliseconds = mDurations[VectorPosition].count() / 1000000;
     cout << Description << " - Time taken by crypto: " << to_string((uint32_t)Milliseconds) << " milliseconds" << endl;
     cout << Description << " - Average time taken by crypto: " << to_string(Milliseconds/TestRounds) << " milliseconds" << endl;
     cout << Description << " - Average of " << to_string(TestRounds) << " test rounds" << endl;
+    cout << Description << " - Latency " << GetLatencySummary(VectorPosition) << endl;
 }
 
 /*========================================================================*/
@@ -53,15 +238,67 @@ void Timer::PrintTime(uint32_t TestRounds, uint8_t VectorPosition, string Descri
 Tester::Tester(uint32_t Iterations,
                string& Logfile):
     mIterations(Iterations),
-    cLogFileName(Logfile)
+    mWarmup(0),
+    mRelativeError(0.0),
+    mTimeBudget(0),
+    cLogFileName(Logfile),
+    mLog(Logger::Get(Logfile))
 {}
 
+Tester::~Tester()
+{
+    mLog->Flush();
+}
+
 bool Tester::TestRound()
 {
     cout << "Base function, nothing to do here." << endl;
     return true;
 }
 
+bool Tester::Run()
+{
+    // Warm up caches, branch predictors and the lazy initialisations
+    // of the library, the warmup is not part of the results
+    for (uint32_t i = 0; i < mWarmup; i++)
+    {
+        if (!TestRound())
+        {
+            HandleOutput("Warmup has failed");
+            return false;
+        }
+    }
+    ResetTime();
+    uint32_t i = 0;
+    bool Success = true;
+    steady_clock::time_point Start = steady_clock::now();
+    // Test the scheme with the Tester
+    while (!IsFinished(i, Start))
+    {
+        if (!TestRound())
+        {
+            Success = false;
+            break;
+        }
+        i++;
+    }
+    // Check if every run was successful
+    if (!Success)
+    {
+        string Output = string("Only ") + to_string(i) + " out of "
+                        + to_string(mIterations) + " were successful.";
+        HandleOutput(Output);
+    }
+    // Print the times
+    HandleOutput("");
+    PrintTime(i, 0, "Encryption");
+    HandleOutput("");
+    PrintTime(i, 1, "Decryption");
+    HandleOutput("");
+    PrintTime(i, 2, "Verification");
+    return Success;
+}
+
 string Tester::ReadImage(const string& File)
 {
     if(!filesystem::exists(File))
@@ -104,21 +341,14 @@ bool Tester::HandleOutput(const string& Log, bool PrintOut)
     {
         cout << Log << endl;
     }
-    fstream LogFile(cLogFileName, ios::out | ios::binary | ios::app);
-    if (LogFile.is_open())
-    {
-        LogFile << Log << endl;
-        LogFile.close();
-        return true;
-    }
-    return false;
+    return mLog->Write(Log);
 }
 
 void Tester::PrintTime(uint32_t TestRounds, uint8_t VectorPosition, string Description)
 {
     if (VectorPosition >= mDurations.size())
     {
-        mDurations.resize(VectorPosition + 1);
+        Resize(VectorPosition);
     }
     double Milliseconds = mDurations[VectorPosition].count() / 1000000;
     string Output = "";
@@ -128,6 +358,8 @@ void Tester::PrintTime(uint32_t TestRounds, uint8_t VectorPosition, string Descr
     HandleOutput(Output);
     Output = Description + " - Average of " + to_string(TestRounds) + " test rounds";
     HandleOutput(Output);
+    Output = Description + " - Latency " + GetLatencySummary(VectorPosition);
+    HandleOutput(Output);
 }
 
 void Tester::PrintCommand(int argc, char** argv)
@@ -155,6 +387,143 @@ uint32_t Tester::GetTestIterations()
     return mIterations;
 }
 
+void Tester::SetWarmup(uint32_t Rounds)
+{
+    mWarmup = Rounds;
+}
+
+uint32_t Tester::GetWarmup()
+{
+    return mWarmup;
+}
+
+void Tester::SetConvergence(double RelativeError, uint32_t TimeBudget)
+{
+    mRelativeError = RelativeError;
+    mTimeBudget = TimeBudget;
+}
+
+bool Tester::HasConverged(double RelativeError)
+{
+    return IsConverged(RelativeError);
+}
+
+bool Tester::IsFinished(uint32_t Rounds, steady_clock::time_point Start)
+{
+    if (Rounds >= mIterations)
+    {
+        return true;
+    }
+    // The interval of the median needs some samples, so check only every few rounds
+    if (mRelativeError > 0.0 && Rounds >= cMinConvergenceRounds &&
+        Rounds % cConvergenceInterval == 0 && HasConverged(mRelativeError))
+    {
+        HandleOutput("Median converged after " + to_string(Rounds) + " rounds");
+        return true;
+    }
+    if (mTimeBudget > 0 && steady_clock::now() - Start >= seconds(mTimeBudget))
+    {
+        HandleOutput("Time budget of " + to_string(mTimeBudget) + " seconds used up after " +
+                     to_string(Rounds) + " rounds");
+        return true;
+    }
+    return false;
+}
+
+bool Tester::WaitForWorkers(const atomic<uint32_t>& Running,
+                            const function<uint32_t()>& Snapshot,
+                            steady_clock::time_point Start)
+{
+    if (mRelativeError <= 0.0 && mTimeBudget == 0)
+    {
+        return false;
+    }
+    while (Running.load() > 0)
+    {
+        this_thread::sleep_for(milliseconds(cMonitorInterval));
+        // IsFinished checks the median only at multiples of the interval
+        uint32_t Rounds = Snapshot();
+        if (IsFinished(Rounds - Rounds % cConvergenceInterval, Start))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tester::SetResultWriter(shared_ptr<ResultWriter> Results)
+{
+    mResults = Results;
+}
+
+ResultRecord Tester::CreateRecord(const string& Mode,
+                                  ICEScheme* CE,
+                                  uint64_t HeaderSize,
+                                  uint64_t MessageSize,
+                                  uint64_t KeySize,
+                                  uint64_t NonceSize,
+                                  uint64_t Iterations,
+                                  uint64_t Threads)
+{
+    ResultRecord Record;
+    Record.Add("mode", Mode);
+    Record.Add("scheme", CE->GetClassDecription());
+    Record.Add("header_size", HeaderSize);
+    Record.Add("message_size", MessageSize);
+    Record.Add("key_size", KeySize);
+    Record.Add("nonce_size", NonceSize);
+    Record.Add("iterations", Iterations);
+    Record.Add("warmup", (uint64_t)mWarmup);
+    Record.Add("threads", Threads);
+    return Record;
+}
+
+void Tester::AddPhases(ResultRecord& Record, uint64_t Bytes)
+{
+    const vector<string> Phases = {"enc", "dec", "ver"};
+    for (uint8_t Phase = 0; Phase < Phases.size(); Phase++)
+    {
+        Record.AddPhase(Phases[Phase], GetHistogram(Phase), GetCycles(Phase), Bytes);
+        if (!HasPerfCounters())
+        {
+            continue;
+        }
+        if (!HasCounters(Phase))
+        {
+            // The group was never scheduled, so the counters are unknown (null)
+            for (const string& Counter: {"_ipc", "_core_cycles_per_byte", "_branch_misses",
+                                         "_l1d_misses", "_llc_misses", "_dtlb_misses"})
+            {
+                Record.Add(Phases[Phase] + Counter, numeric_limits<double>::quiet_NaN());
+            }
+            continue;
+        }
+        // Counters per iteration, unavailable counters are 0
+        double Iterations = max<uint64_t>(GetHistogram(Phase).GetCount(), 1);
+        double Cycles = GetCounter(Phase, PerfCounters::Cycles);
+        Record.Add(Phases[Phase] + "_ipc", Cycles > 0 ? GetCounter(Phase, PerfCounters::Instructions) / Cycles : 0.0);
+        Record.Add(Phases[Phase] + "_core_cycles_per_byte", Cycles / (Iterations * max<uint64_t>(Bytes, 1)));
+        Record.Add(Phases[Phase] + "_branch_misses", GetCounter(Phase, PerfCounters::BranchMisses) / Iterations);
+        Record.Add(Phases[Phase] + "_l1d_misses", GetCounter(Phase, PerfCounters::L1DMisses) / Iterations);
+        Record.Add(Phases[Phase] + "_llc_misses", GetCounter(Phase, PerfCounters::LLCMisses) / Iterations);
+        Record.Add(Phases[Phase] + "_dtlb_misses", GetCounter(Phase, PerfCounters::DTLBMisses) / Iterations);
+    }
+}
+
+bool Tester::WriteResult(const ResultRecord& Record)
+{
+    if (!mResults)
+    {
+        return true;
+    }
+    if (!mResults->Write(Record))
+    {
+        HandleOutput("Could not write the result record");
+        return false;
+    }
+    return true;
+}
+
 /*========================================================================*/
 
 SchemeTester::SchemeTester(uint32_t Iterations,
@@ -246,6 +615,28 @@ bool SchemeTester::TestRound()
     return true;
 }
 
+bool SchemeTester::Run()
+{
+    bool Success = Tester::Run();
+    if (HasPerfCounters())
+    {
+        HandleOutput("");
+        HandleOutput("Encryption - Counters " + GetCounterSummary(0, mH.size() + mM.size()));
+        HandleOutput("Decryption - Counters " + GetCounterSummary(1, mH.size() + mM.size()));
+        HandleOutput("Verification - Counters " + GetCounterSummary(2, mH.size() + mM.size()));
+    }
+    WriteResult(CreateResult("single"));
+    return Success;
+}
+
+ResultRecord SchemeTester::CreateResult(const string& Mode)
+{
+    ResultRecord Record = CreateRecord(Mode, mCE, mH.size(), mM.size(), mKey.size(),
+                                       mNonce.size(), GetHistogram(0).GetCount());
+    AddPhases(Record, mH.size() + mM.size());
+    return Record;
+}
+
 bool SchemeTester::Round()
 {
     // Encryption
@@ -271,3 +662,13 @@ uint32_t SchemeTester::GetMessageSize()
 {
     return mM.size();
 }
+
+uint32_t SchemeTester::GetHeaderSize()
+{
+    return mH.size();
+}
+
+ICEScheme* SchemeTester::GetScheme()
+{
+    return mCE;
+}
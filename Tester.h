@@ -4,8 +4,16 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <array>
+#include <atomic>
+#include <functional>
 
 #include "ICEScheme.h"
+#include "Histogram.h"
+#include "ResultWriter.h"
+#include "PerfCounters.h"
+#include "Logger.h"
 
 /// \brief Timer class provides necessary time measurement functions
 class Timer
@@ -25,6 +33,31 @@ public:
     /// \brief Get the time for the specified position
 	/// \param VectorPosition position in vector to get the overall added time
     double GetTime(uint8_t VectorPosition = 0);
+    /// \brief Get the added cycles for the specified position
+	/// \param VectorPosition position in vector to get the overall added cycles
+    /// \details The cycles are read from the time stamp counter, so they are
+    /// reference cycles and do not follow frequency changes of the core
+    uint64_t GetCycles(uint8_t VectorPosition = 0);
+    /// \brief Sets the added times, cycles and latencies of every position to zero
+    void ResetTime();
+    /// \brief Get the latency histogram for the specified position
+	/// \param VectorPosition position in vector to get the recorded samples
+    const Histogram& GetHistogram(uint8_t VectorPosition = 0);
+    /// \brief Get the latency percentiles and the standard deviation as text
+	/// \param VectorPosition position in vector to get the recorded samples
+    /// \details Reports p50, p90, p99, p99.9 and max of every added time in milliseconds
+    std::string GetLatencySummary(uint8_t VectorPosition = 0);
+    /// \brief Get the latency percentiles and the standard deviation as text
+	/// \param Samples histogram with samples in nanoseconds
+    static std::string GetLatencySummary(const Histogram& Samples);
+    /// \brief Returns true if the median of every position is known precisely enough
+	/// \param RelativeError maximal half width of the 95% confidence interval
+    /// of the median relative to the median, e.g. 0.01 for 1%
+    bool IsConverged(double RelativeError);
+    /// \brief Returns true if the median of the samples is known precisely enough
+	/// \param Samples histogram with samples in nanoseconds, empty ones count as converged
+	/// \param RelativeError see IsConverged
+    static bool IsConverged(const Histogram& Samples, double RelativeError);
     /// \brief Prints the time
 	/// \param TestRounds the number of iterations that were successful
 	/// \param VectorPosition the vector position for the time
@@ -32,9 +65,47 @@ public:
     /// \details It calculates the average time and prints results with the description
     virtual void PrintTime(uint32_t TestRounds = 1, uint8_t VectorPosition = 0, std::string Description = "");
 
+    /// \brief Opens the hardware performance counters for the calling thread
+    /// \details From now on StartTime and AddTime also add the counters for every
+    /// position, returns false if the counters are not available
+    virtual bool EnablePerfCounters();
+    /// \brief Returns true if the performance counters are enabled and available
+    bool HasPerfCounters();
+    /// \brief Returns the reason why the performance counters are not available
+    /// \details The error of the last EnablePerfCounters, empty if it succeeded
+    std::string GetPerfCountersError();
+    /// \brief Get the added value of a performance counter for the specified position
+	/// \param VectorPosition position in vector to get the overall added value
+	/// \param Counter the event of the counter
+    uint64_t GetCounter(uint8_t VectorPosition, PerfCounters::Event Counter);
+    /// \brief Returns true if the performance counters of the position were counted
+	/// \param VectorPosition position in vector to check
+    /// \details False if the counters are disabled or the group was not scheduled
+    /// on the PMU for a read since the last ResetTime
+    bool HasCounters(uint8_t VectorPosition);
+    /// \brief Get IPC, cycles per byte and the misses per iteration as text
+	/// \param VectorPosition position in vector to get the counters
+	/// \param Bytes processed bytes of one iteration
+    std::string GetCounterSummary(uint8_t VectorPosition, uint64_t Bytes);
+    /// \brief Reads the time stamp counter, returns 0 if there is none
+    static uint64_t ReadCycles();
+
 protected:
+    /// \brief Resizes every vector to hold the position
+	/// \param VectorPosition the position that needs to exist
+    void Resize(uint8_t VectorPosition);
+
     std::vector<std::chrono::high_resolution_clock::time_point> mStartTimes;
+    std::vector<uint64_t> mStartCycles;
     std::vector<std::chrono::nanoseconds> mDurations;
+    std::vector<uint64_t> mCycles;
+    std::vector<Histogram> mHistograms;
+    std::unique_ptr<PerfCounters> mPerf;
+    std::string mPerfError;
+    std::vector<std::array<uint64_t, PerfCounters::EventCount>> mStartCounters;
+    std::vector<std::array<uint64_t, PerfCounters::EventCount>> mCounters;
+    // True if a read of the position was not counted
+    std::vector<bool> mUncounted;
 };
 
 /// \brief Tester class which has everything to analyse the timing of the provided scheme
@@ -49,10 +120,14 @@ public:
     Tester(uint32_t Iterations,
            std::string& Logfile);
     /// \brief Destruct a Tester
-    /// \details Need to delete the scheme provided by the SchemeFactory
-    virtual ~Tester() {}
+    /// \details Waits until the log lines of the tester are in the logfile
+    virtual ~Tester();
     /// \brief Function to call for testing
     virtual bool TestRound();
+    /// \brief Runs all iterations and logs the results
+    /// \details Calls TestRound until an iteration fails or all iterations
+    /// are done and prints the times for encryption, decryption and verification
+    virtual bool Run();
     /// \brief Read image data to string
 	/// \param File path to an image
     /// \details If the File is not a valid path to an image we will 
@@ -68,6 +143,8 @@ public:
     /// \brief Logs a string to the logfile and prints it if specified
 	/// \param Log data to print
 	/// \param PrintOut when true the logged string will be printed to the console
+    /// \details The console output is immediate, the logfile is written by a
+    /// background thread, see Logger
     bool HandleOutput(const std::string& Log, bool PrintOut = true);
     /// \brief Prints the time
 	/// \param TestRounds the number of iterations that were successful
@@ -81,10 +158,77 @@ public:
     void PrintCommand(int argc, char** argv);
     /// \brief Getter for the iterations
     uint32_t GetTestIterations();
+    /// \brief Sets the number of rounds before the measurement
+	/// \param Rounds the warmup rounds, they are not part of the results
+    void SetWarmup(uint32_t Rounds);
+    /// \brief Getter for the warmup rounds
+    uint32_t GetWarmup();
+    /// \brief Stops the measurement before the iterations are done
+	/// \param RelativeError stop when the median of every phase is converged,
+    /// see Timer::IsConverged, 0 to disable
+	/// \param TimeBudget stop after this many seconds, 0 to disable
+    void SetConvergence(double RelativeError, uint32_t TimeBudget);
+    /// \brief Returns true if the results of the run are converged
+	/// \param RelativeError see Timer::IsConverged
+    virtual bool HasConverged(double RelativeError);
+    /// \brief Sets the writer for the machine readable results
+	/// \param Results writer which gets one record per run
+    void SetResultWriter(std::shared_ptr<ResultWriter> Results);
+    /// \brief Creates a record with the parameters of a run
+	/// \param Mode name of the test mode, e.g. "single" or "sweep"
+	/// \param CE the tested scheme
+	/// \param HeaderSize size of the header in bytes
+	/// \param MessageSize size of the message in bytes
+	/// \param KeySize size of the key in bytes
+	/// \param NonceSize size of the nonce in bytes
+	/// \param Iterations number of measured iterations
+	/// \param Threads number of threads of the run
+    ResultRecord CreateRecord(const std::string& Mode,
+                              ICEScheme* CE,
+                              uint64_t HeaderSize,
+                              uint64_t MessageSize,
+                              uint64_t KeySize,
+                              uint64_t NonceSize,
+                              uint64_t Iterations,
+                              uint64_t Threads = 1);
+    /// \brief Adds the statistics of encryption, decryption and verification to a record
+	/// \param Record the record to extend
+	/// \param Bytes processed bytes of one iteration for the cycles per byte
+    void AddPhases(ResultRecord& Record, uint64_t Bytes);
+    /// \brief Writes the record if a result writer was set
+	/// \param Record the result of a run
+    bool WriteResult(const ResultRecord& Record);
+
+protected:
+    /// \brief Returns true if no more rounds are needed and logs why
+	/// \param Rounds the number of measured rounds so far
+	/// \param Start the time point of the first measured round
+    /// \details Done after all iterations, after the median converged
+    /// or after the time budget is used up
+    bool IsFinished(uint32_t Rounds, std::chrono::steady_clock::time_point Start);
+    /// \brief Waits while worker threads run and checks IsFinished every few milliseconds
+	/// \param Running number of workers which are still running, decremented by the workers
+	/// \param Snapshot merges the histograms of the workers for HasConverged
+    /// and returns the measured rounds
+	/// \param Start the time point of the first measured round
+    /// \details Returns true if the workers have to stop early. Without a relative
+    /// error and a time budget it returns false at once and the caller only joins.
+    bool WaitForWorkers(const std::atomic<uint32_t>& Running,
+                        const std::function<uint32_t()>& Snapshot,
+                        std::chrono::steady_clock::time_point Start);
 
 private:
     uint32_t mIterations;
+    uint32_t mWarmup;
+    double mRelativeError;
+    uint32_t mTimeBudget;
     const std::string cLogFileName;
+    std::shared_ptr<Logger> mLog;
+    std::shared_ptr<ResultWriter> mResults;
+    const uint32_t cMinConvergenceRounds = 20;
+    const uint32_t cConvergenceInterval = 10;
+    // Milliseconds between two checks of running workers
+    const uint32_t cMonitorInterval = 10;
 };
 
 /*=======================================================================================*/
@@ -116,10 +260,19 @@ public:
     }
     /// \brief Calls enc, dec and ver of the scheme and measures time
     bool TestRound();
+    /// \brief Runs all iterations, logs the results and writes the result record
+    bool Run();
     /// \brief Calls enc, dec and ver of the scheme without measuring time
     bool Round();
     /// \brief Get size of the input message
     uint32_t GetMessageSize();
+    /// \brief Get size of the input header
+    uint32_t GetHeaderSize();
+    /// \brief Get the tested scheme
+    ICEScheme* GetScheme();
+    /// \brief Creates the result record with the statistics of every phase
+	/// \param Mode name of the test mode, e.g. "single"
+    ResultRecord CreateResult(const std::string& Mode);
 
 private:
     std::string mKey;
@@ -0,0 +1,229 @@
+#include <iostream>
+#include <thread>
+using namespace std;
+using namespace std::chrono;
+
+#include "ThroughputTester.h"
+
+ThroughputTester::ThroughputTester(uint32_t Iterations,
+                                   string& Logfile,
+                                   string& Key,
+                                   string& Nonce,
+                                   string& Header,
+                                   string& Message,
+                                   ICEScheme* CE,
+                                   uint32_t Threads):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mH(Tester::ReadImage(Header)),
+    mM(Tester::ReadImage(Message)),
+    mNonces(Nonce),
+    mCE(CE),
+    mWorkers(Threads),
+    mReady(0),
+    mRunning(0),
+    mStart(false),
+    mStop(false)
+{
+    if (Threads == 0)
+    {
+        throw runtime_error("Need at least one thread for the throughput test");
+    }
+    for (Worker& State: mWorkers)
+    {
+        State.Context = new CEContext(*mCE, mNonces);
+        State.Success = true;
+    }
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Test scheme: " + mCE->GetClassDecription() +
+                 " with up to " + to_string(mWorkers.size()) + " threads", true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(Nonce.size()), false);
+    HandleOutput("Header size: " + to_string(mH.size()), false);
+    HandleOutput("Message size: " + to_string(mM.size()), false);
+    // Test round to setup the sizes for the members of every worker
+    for (Worker& State: mWorkers)
+    {
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        if (!State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf) ||
+            !State.Context->Ver(mH, State.Message, State.Keyf, State.C2))
+        {
+            throw runtime_error("Setup round failed.");
+        }
+    }
+}
+
+ThroughputTester::~ThroughputTester()
+{
+    for (Worker& State: mWorkers)
+    {
+        delete State.Context;
+    }
+    delete mCE;
+}
+
+bool ThroughputTester::Run()
+{
+    bool Success = true;
+    for (uint32_t ThreadCount = 1; ThreadCount <= mWorkers.size() && Success; ThreadCount++)
+    {
+        Success = RunThreads(ThreadCount);
+    }
+    return Success;
+}
+
+void ThroughputTester::RunWorker(Worker& State)
+{
+    // Warmup rounds of this thread are not measured
+    for (uint32_t i = 0; i < GetWarmup(); i++)
+    {
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf);
+        State.Context->Ver(mH, State.Message, State.Keyf, State.C2);
+    }
+    mReady.fetch_add(1);
+    // Wait until every thread is created and warmed up
+    while (!mStart.load(memory_order_acquire))
+    {
+        this_thread::yield();
+    }
+    uint32_t Iterations = GetTestIterations();
+    for (uint32_t i = 0; i < Iterations && !mStop.load(memory_order_relaxed); i++)
+    {
+        // Encryption with the next nonce of the reservation of the context
+        high_resolution_clock::time_point Start = high_resolution_clock::now();
+        State.Context->Enc(mKey, mH, mM, State.C1, State.C2, State.Nonce);
+        high_resolution_clock::time_point Stop = high_resolution_clock::now();
+        uint64_t EncTime = duration_cast<nanoseconds>(Stop - Start).count();
+        // Decryption
+        Start = Stop;
+        bool Success = State.Context->Dec(mKey, State.Nonce, mH, State.C1, State.C2, State.Message, State.Keyf);
+        Stop = high_resolution_clock::now();
+        uint64_t DecTime = duration_cast<nanoseconds>(Stop - Start).count();
+        // Verification
+        Start = Stop;
+        Success = Success && State.Context->Ver(mH, State.Message, State.Keyf, State.C2);
+        Stop = high_resolution_clock::now();
+        uint64_t VerTime = duration_cast<nanoseconds>(Stop - Start).count();
+        {
+            lock_guard<mutex> Lock(State.Lock);
+            State.Enc.Record(EncTime);
+            State.Dec.Record(DecTime);
+            State.Ver.Record(VerTime);
+        }
+        if (!Success)
+        {
+            State.Success = false;
+            break;
+        }
+    }
+    State.Finish = high_resolution_clock::now();
+    mRunning.fetch_sub(1);
+}
+
+bool ThroughputTester::RunThreads(uint32_t ThreadCount)
+{
+    vector<thread> Threads;
+    mStart.store(false);
+    mStop.store(false);
+    mReady.store(0);
+    mRunning.store(ThreadCount);
+    for (uint32_t i = 0; i < ThreadCount; i++)
+    {
+        mWorkers[i].Enc.Reset();
+        mWorkers[i].Dec.Reset();
+        mWorkers[i].Ver.Reset();
+        Threads.emplace_back(&ThroughputTester::RunWorker, this, ref(mWorkers[i]));
+    }
+    while (mReady.load() < ThreadCount)
+    {
+        this_thread::yield();
+    }
+    high_resolution_clock::time_point Start = high_resolution_clock::now();
+    mStart.store(true, memory_order_release);
+    // Rounds of the slowest thread, as the iterations are per thread
+    auto Snapshot = [this, ThreadCount]()
+    {
+        mEnc.Reset();
+        mDec.Reset();
+        mVer.Reset();
+        uint32_t Rounds = UINT32_MAX;
+        for (uint32_t i = 0; i < ThreadCount; i++)
+        {
+            Worker& State = mWorkers[i];
+            lock_guard<mutex> Lock(State.Lock);
+            mEnc.Merge(State.Enc);
+            mDec.Merge(State.Dec);
+            mVer.Merge(State.Ver);
+            Rounds = min<uint32_t>(Rounds, State.Enc.GetCount());
+        }
+        return Rounds;
+    };
+    if (WaitForWorkers(mRunning, Snapshot, steady_clock::now()))
+    {
+        mStop.store(true);
+    }
+    for (thread& Thread: Threads)
+    {
+        Thread.join();
+    }
+    // Until the last thread is done, the monitor may wake up later
+    high_resolution_clock::time_point Finish = Start;
+    for (uint32_t i = 0; i < ThreadCount; i++)
+    {
+        Finish = max(Finish, mWorkers[i].Finish);
+    }
+    double Seconds = duration_cast<nanoseconds>(Finish - Start).count() / 1e9;
+    // Aggregate the results of all threads
+    bool Success = true;
+    Histogram Enc, Dec, Ver;
+    HandleOutput("");
+    for (uint32_t i = 0; i < ThreadCount; i++)
+    {
+        Worker& State = mWorkers[i];
+        if (!State.Success)
+        {
+            HandleOutput("Thread " + to_string(i) + " - Decryption or verification has failed");
+            Success = false;
+        }
+        Enc.Merge(State.Enc);
+        Dec.Merge(State.Dec);
+        Ver.Merge(State.Ver);
+        HandleOutput("Threads: " + to_string(ThreadCount) + " - Thread " + to_string(i) +
+                     " - Encryption p50: " + to_string(State.Enc.GetPercentile(50.0) / 1000000.0) +
+                     ", p99: " + to_string(State.Enc.GetPercentile(99.0) / 1000000.0) +
+                     " - Decryption p50: " + to_string(State.Dec.GetPercentile(50.0) / 1000000.0) +
+                     ", p99: " + to_string(State.Dec.GetPercentile(99.0) / 1000000.0) +
+                     " - Verification p50: " + to_string(State.Ver.GetPercentile(50.0) / 1000000.0) +
+                     ", p99: " + to_string(State.Ver.GetPercentile(99.0) / 1000000.0) +
+                     " milliseconds", false);
+    }
+    // One message is one round of encryption, decryption and verification
+    double Messages = Enc.GetCount();
+    HandleOutput("Threads: " + to_string(ThreadCount) + " - Throughput: " +
+                 to_string(Messages / Seconds) + " messages/s, " +
+                 to_string(Messages * mM.size() / Seconds / 1e9) + " GB/s");
+    HandleOutput("Threads: " + to_string(ThreadCount) + " - Encryption latency " + GetLatencySummary(Enc));
+    HandleOutput("Threads: " + to_string(ThreadCount) + " - Decryption latency " + GetLatencySummary(Dec));
+    HandleOutput("Threads: " + to_string(ThreadCount) + " - Verification latency " + GetLatencySummary(Ver));
+    ResultRecord Record = CreateRecord("throughput", mCE, mH.size(), mM.size(), mKey.size(),
+                                       mWorkers[0].Nonce.size(), Enc.GetCount() / ThreadCount, ThreadCount);
+    // There are no cycles per thread, so the cycles per byte are left out
+    Record.AddPhase("enc", Enc, 0, 0);
+    Record.AddPhase("dec", Dec, 0, 0);
+    Record.AddPhase("ver", Ver, 0, 0);
+    Record.Add("messages_per_s", Messages / Seconds);
+    Record.Add("gb_per_s", Messages * mM.size() / Seconds / 1e9);
+    WriteResult(Record);
+    return Success;
+}
+
+bool ThroughputTester::HasConverged(double RelativeError)
+{
+    return IsConverged(mEnc, RelativeError) && IsConverged(mDec, RelativeError) &&
+           IsConverged(mVer, RelativeError);
+}
@@ -0,0 +1,92 @@
+#ifndef THROUGHPUTTESTER_H
+#define THROUGHPUTTESTER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "Tester.h"
+#include "Histogram.h"
+#include "NonceSequencer.h"
+#include "CEContext.h"
+
+/// \brief ThroughputTester class which tests a CE scheme on multiple threads
+/// \details Every worker thread franks with its own CEContext of the parsed scheme,
+/// the contexts reserve their nonces from one NonceSequencer. The test is done for 1 up to N
+/// threads and reports the aggregated throughput and the latency per thread.
+/// Every thread runs the warmup rounds before the common start, the convergence
+/// is checked on the histograms merged over all threads.
+class ThroughputTester: public Tester
+{
+public:
+	/// \brief Construct a ThroughputTester
+	/// \param Iterations number of enc, dec and ver per thread
+	/// \param Logfile path of the logfile
+	/// \param Key for the schemes to test
+	/// \param Nonce first nonce of the NonceSequencer which gives every thread unique nonces
+	/// \param Header for the tester, can be path to image or string
+	/// \param Message for the tester, can be path to image or string
+	/// \param CE reference to the scheme to test, every thread gets a context of it
+	/// \param Threads maximal number of threads
+    ThroughputTester(uint32_t Iterations,
+                     std::string& Logfile,
+                     std::string& Key,
+                     std::string& Nonce,
+                     std::string& Header,
+                     std::string& Message,
+                     ICEScheme* CE,
+                     uint32_t Threads);
+    /// \brief Destruct a ThroughputTester
+    /// \details Need to delete the contexts and the scheme provided by the SchemeFactory
+    ~ThroughputTester();
+    /// \brief Runs the test for 1 up to N threads and logs the results
+    bool Run();
+    /// \brief Returns true if the merged histograms of the running threads are converged
+	/// \param RelativeError see Timer::IsConverged
+    bool HasConverged(double RelativeError);
+
+private:
+    /// \brief State of one worker thread
+    /// \details Aligned to a cache line to avoid false sharing between the threads
+    struct alignas(64) Worker
+    {
+        CEContext* Context;
+        // Nonce of the last encryption
+        std::string Nonce;
+        std::string C1;
+        std::string C2;
+        std::string Message;
+        std::string Keyf;
+        Histogram Enc;
+        Histogram Dec;
+        Histogram Ver;
+        // Guards the histograms while the main thread merges them
+        std::mutex Lock;
+        std::chrono::high_resolution_clock::time_point Finish;
+        bool Success;
+    };
+	/// \brief Runs the iterations of one worker
+	/// \param State of the worker thread
+    void RunWorker(Worker& State);
+	/// \brief Runs the test with the given number of threads
+	/// \param ThreadCount number of worker threads
+    bool RunThreads(uint32_t ThreadCount);
+
+    std::string mKey;
+    std::string mH;
+    std::string mM;
+    NonceSequencer mNonces;
+    ICEScheme* mCE;
+    std::vector<Worker> mWorkers;
+    Histogram mEnc;
+    Histogram mDec;
+    Histogram mVer;
+    std::atomic<uint32_t> mReady;
+    std::atomic<uint32_t> mRunning;
+    std::atomic<bool> mStart;
+    std::atomic<bool> mStop;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SCHEMETESTS_H
+#define SCHEMETESTS_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <cryptopp/modes.h>
+#include <cryptopp/aes.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+
+#include "../ICEScheme.h"
+#include "../CEP/CEP.h"
+#include "../CtE/CtE1.h"
+#include "../CtE/CtE2.h"
+#include "../HFC/CETransformation.h"
+#include "../HFC/SHA256_HFC.h"
+#include "../AEAD/EtM.h"
+#include "../AEAD/AES_GCM.h"
+
+/// \brief Returns one scheme of every kind for the unit tests of all schemes
+/// \details The flag is true if the scheme is deterministic for the same key
+/// and nonce, only CEP is. The caller owns the schemes.
+inline std::vector<std::pair<ICEScheme*, bool>> CreateTestSchemes()
+{
+    using namespace CryptoPP;
+    std::vector<std::pair<ICEScheme*, bool>> Schemes;
+    Schemes.push_back(std::make_pair(new CEP(new HMAC<SHA256>(), new HMAC<SHA256>(),
+                                             new CTR_Mode<AES>::Encryption()), true));
+    Schemes.push_back(std::make_pair(new CtE1(new HMAC<SHA256>(),
+                                              new EtM(new HMAC<SHA256>(), new CBC_Mode<AES>::Encryption(),
+                                                      new CBC_Mode<AES>::Decryption())), false));
+    Schemes.push_back(std::make_pair(new CtE1(new HMAC<SHA256>(), new AES_GCM()), false));
+    Schemes.push_back(std::make_pair(new CtE2(new HMAC<SHA256>(),
+                                              new EtM(new HMAC<SHA256>(), new CBC_Mode<AES>::Encryption(),
+                                                      new CBC_Mode<AES>::Decryption())), false));
+    Schemes.push_back(std::make_pair(new CtE2(new HMAC<SHA256>(), new AES_GCM()), false));
+    Schemes.push_back(std::make_pair(new CETransformation(new SHA256_HFC(), new AES_GCM()), false));
+    return Schemes;
+}
+
+/// \brief Runs a Tester for every scheme of CreateTestSchemes and prints the times
+/// \tparam SchemeTest Tester with the constructor (Iterations, Logfile, Header,
+/// Message, CE, Deterministic) which deletes the scheme
+/// \param Iterations number of rounds for every scheme
+/// \param Logfile path of the logfile
+/// \param Header path of the header or the header itself
+/// \param Message path of the message or the message itself
+/// \param Phases names of the measured phases, phase i is printed as "scheme Phases[i]"
+template <class SchemeTest>
+void RunSchemeTests(uint32_t Iterations,
+                    std::string& Logfile,
+                    std::string& Header,
+                    std::string& Message,
+                    const std::vector<std::string>& Phases)
+{
+    for (auto& Scheme: CreateTestSchemes())
+    {
+        std::string Name = Scheme.first->GetClassDecription();
+        SchemeTest Test(Iterations,
+                        Logfile,
+                        Header,
+                        Message,
+                        Scheme.first,
+                        Scheme.second);
+        uint32_t i;
+        for (i = 1;Test.TestRound() && i < Iterations; i++);
+        for (uint8_t Phase = 0; Phase < Phases.size(); Phase++)
+        {
+            Test.PrintTime(i, Phase, Name + " " + Phases[Phase]);
+        }
+        Test.HandleOutput("", false);
+    }
+}
+
+#endif
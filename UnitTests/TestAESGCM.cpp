@@ -19,6 +19,7 @@ public:
         mNonce(Nonce),
         mM(ReadImage(Message)),
         mH(ReadImage(Header)),
+        mM2(mM.rbegin(), mM.rend()),
         mC(mM.size(), '0'),
         mGCM(GCM)
     {}
@@ -35,10 +36,38 @@ public:
         AddTime(0);
         // Decryption
         StartTime(1);
-        bool Success = mGCM->Dec(mKey, mNonce, mH, mC, mM);
+        bool Success = mGCM->Dec(mKey, mNonce, mH, mC, mOutput);
         AddTime(1);
-        if (!Success)
+        if (!Success || mOutput != mM)
         {
+            HandleOutput("Decryption of the first message has failed");
+            return false;
+        }
+        // Second message under the same key, the key is kept and only the nonce is set
+        IncreaseString(mNonce);
+        mGCM->Enc(mKey, mNonce, mH, mM2, mC2);
+        if (!mGCM->Dec(mKey, mNonce, mH, mC2, mOutput) || mOutput != mM2)
+        {
+            HandleOutput("Decryption of the second message has failed");
+            return false;
+        }
+        // The incremental encryption of the second message gives the same cipher
+        size_t Half = mM2.size() / 2;
+        string Stream(mC2.size(), '0');
+        size_t Length = Half;
+        size_t Written = 0;
+        mGCM->StartEnc(mKey, mNonce, (const unsigned char*)mH.data(), mH.size());
+        mGCM->UpdateEnc((const unsigned char*)mM2.data(), Half, (unsigned char*)&Stream[0], Length);
+        Written += Length;
+        Length = Stream.size() - Written;
+        mGCM->UpdateEnc((const unsigned char*)mM2.data() + Half, mM2.size() - Half,
+                        (unsigned char*)&Stream[Written], Length);
+        Written += Length;
+        Length = Stream.size() - Written;
+        mGCM->FinishEnc((unsigned char*)&Stream[Written], Length);
+        if (Stream != mC2)
+        {
+            HandleOutput("Incremental encryption differs from the encryption");
             return false;
         }
         return true;
@@ -49,7 +78,11 @@ private:
     string mNonce;
     string mM;
     string mH;
+    // Second message of the same size for the same key
+    string mM2;
     string mC;
+    string mC2;
+    string mOutput;
     AES_GCM* mGCM;
 };
 
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include <cryptopp/modes.h>
+#include <cryptopp/aes.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+using namespace CryptoPP;
+
+#include "../Tester.h"
+#include "SchemeTests.h"
+
+class TestClone: public Tester
+{
+public:
+    TestClone(uint32_t Iterations,
+              string& Logfile,
+              string& Header,
+              string& Message,
+              ICEScheme* CE,
+              bool Deterministic):
+        Tester(Iterations, Logfile),
+        mCE(CE),
+        mClone(CE->Clone()),
+        mDeterministic(Deterministic),
+        mKey(CE->Kg()),
+        mNonce(RandomGenerator::Generate(CE->GetNonceSize())),
+        mH(ReadImage(Header)),
+        mM(ReadImage(Message))
+    {}
+    ~TestClone()
+    {
+        delete mClone;
+        delete mCE;
+    }
+    bool TestRound()
+    {
+        IncreaseString(mNonce);
+        mCE->SetNonce(mNonce);
+        mClone->SetNonce(mNonce);
+        StartTime(0);
+        mCE->Enc(mKey, mH, mM, mC1, mC2);
+        AddTime(0);
+        string CloneC1, CloneC2;
+        StartTime(1);
+        mClone->Enc(mKey, mH, mM, CloneC1, CloneC2);
+        AddTime(1);
+        if (mDeterministic && (CloneC1 != mC1 || CloneC2 != mC2))
+        {
+            HandleOutput("Encryption of the clone differs from the encryption");
+            return false;
+        }
+        if (CloneC1.size() != mC1.size() || CloneC2.size() != mC2.size())
+        {
+            HandleOutput("Encryption of the clone has other sizes");
+            return false;
+        }
+        // CtE and the CETransformation draw a new opening key, so the clone has to open
+        // the cipher of the scheme to the same message and opening key and the other way round
+        string Keyf, CloneKeyf;
+        if (!mCE->Dec(mKey, mH, mC1, mC2, mOutput, Keyf) || mOutput != mM ||
+            !mClone->Dec(mKey, mH, mC1, mC2, mOutput, CloneKeyf) || mOutput != mM || CloneKeyf != Keyf)
+        {
+            HandleOutput("Decryption of the clone differs from the decryption");
+            return false;
+        }
+        if (!mCE->Dec(mKey, mH, CloneC1, CloneC2, mOutput, Keyf) || mOutput != mM ||
+            !mClone->Ver(mH, mM, Keyf, CloneC2) || !mCE->Ver(mH, mM, Keyf, CloneC2))
+        {
+            HandleOutput("Encryption of the clone is not accepted by the scheme");
+            return false;
+        }
+        string C2 = CloneC2;
+        C2[0] ^= 0x01;
+        if (mClone->Ver(mH, mM, Keyf, C2))
+        {
+            HandleOutput("Verification of the clone has accepted a changed C2");
+            return false;
+        }
+        return true;
+    }
+
+private:
+    ICEScheme* mCE;
+    ICEScheme* mClone;
+    bool mDeterministic;
+    string mKey;
+    string mNonce;
+    string mH;
+    string mM;
+    string mC1;
+    string mC2;
+    string mOutput;
+};
+
+class TestAEADClone: public Tester
+{
+public:
+    TestAEADClone(uint32_t Iterations,
+                  string& Logfile,
+                  string& Header,
+                  string& Message,
+                  IAEADScheme* AEAD):
+        Tester(Iterations, Logfile),
+        mAEAD(AEAD),
+        mClone(AEAD->Clone()),
+        mKey(AEAD->Kg()),
+        mNonce(RandomGenerator::Generate(AEAD->GetBlockSize())),
+        mH(ReadImage(Header)),
+        mM(ReadImage(Message))
+    {}
+    ~TestAEADClone()
+    {
+        delete mClone;
+        delete mAEAD;
+    }
+    bool TestRound()
+    {
+        IncreaseString(mNonce);
+        string C, CloneC;
+        StartTime(0);
+        mAEAD->Enc(mKey, mNonce, mH, mM, C);
+        AddTime(0);
+        StartTime(1);
+        mClone->Enc(mKey, mNonce, mH, mM, CloneC);
+        AddTime(1);
+        if (CloneC != C)
+        {
+            HandleOutput("Encryption of the clone differs from the encryption");
+            return false;
+        }
+        if (!mClone->Dec(mKey, mNonce, mH, C, mOutput) || mOutput != mM)
+        {
+            HandleOutput("Decryption of the clone has failed");
+            return false;
+        }
+        return true;
+    }
+
+private:
+    IAEADScheme* mAEAD;
+    IAEADScheme* mClone;
+    string mKey;
+    string mNonce;
+    string mH;
+    string mM;
+    string mOutput;
+};
+
+int main(int argc, char** argv)
+{
+    uint32_t TestIterations = 20;
+    string Logfile = "LogUnitTests.txt";
+    string TestHeader = "Header of the clone test";
+    string TestImage = "../Images/big.jpg";
+    if (argc > 1)
+    {
+        TestImage = string(argv[1]);
+    }
+    try
+    {
+        // The components of the AEAD schemes are cloned by the SchemeFactory
+        vector<IAEADScheme*> AEADs;
+        AEADs.push_back(new EtM(new HMAC<SHA256>(), new CBC_Mode<AES>::Encryption(),
+                                new CBC_Mode<AES>::Decryption()));
+        AEADs.push_back(new AES_GCM());
+        for (IAEADScheme* AEAD: AEADs)
+        {
+            string Name = AEAD->GetClassDecription();
+            TestAEADClone Test(TestIterations,
+                               Logfile,
+                               TestHeader,
+                               TestImage,
+                               AEAD);
+            uint32_t i;
+            for (i = 1;Test.TestRound() && i < TestIterations; i++);
+            Test.PrintTime(i, 0, Name + " encryption");
+            Test.PrintTime(i, 1, Name + " encryption of the clone");
+            Test.HandleOutput("", false);
+        }
+        RunSchemeTests<TestClone>(TestIterations, Logfile, TestHeader, TestImage,
+                                  {"encryption", "encryption of the clone"});
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
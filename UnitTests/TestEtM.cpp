@@ -46,9 +46,39 @@ public:
         {
             return false;
         }
+        if (!TestKeySeparation())
+        {
+            return false;
+        }
         IncreaseString(mNonce);
         return true;
     }
+    bool TestKeySeparation()
+    {
+        // Key = cipher key || MAC key, the last byte only belongs to the MAC key
+        // and changes the tag but not the cipher, the first byte only belongs to
+        // the cipher key and changes the cipher
+        size_t TagSize = mEtM->GetTagSize();
+        string Key = mKey;
+        string C;
+        Key[Key.size() - 1] ^= 0x01;
+        mEtM->Enc(Key, mNonce, mH, mM, C);
+        if (C.compare(0, C.size() - TagSize, mC, 0, mC.size() - TagSize) != 0 ||
+            C.compare(C.size() - TagSize, TagSize, mC, mC.size() - TagSize, TagSize) == 0)
+        {
+            HandleOutput("The MAC key is not separated from the cipher key");
+            return false;
+        }
+        Key = mKey;
+        Key[0] ^= 0x01;
+        mEtM->Enc(Key, mNonce, mH, mM, C);
+        if (C.compare(0, C.size() - TagSize, mC, 0, mC.size() - TagSize) == 0)
+        {
+            HandleOutput("The cipher key is not separated from the MAC key");
+            return false;
+        }
+        return true;
+    }
 
 private:
     string mKey;
@@ -0,0 +1,372 @@
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "../HFC/SHA256_HFC.h"
+#include "../HFC/SHA512_HFC.h"
+#include "../HFC/SHA3_HFC.h"
+#include "../HFC/Whrlpool_HFC.h"
+#include "../HFC/AltPad_SHA256_HFC.h"
+#include "../Tester.h"
+
+/// \brief Known answer of one EC, header and message are generated from their sizes
+struct Vector
+{
+    size_t HeaderSize;
+    size_t MessageSize;
+    const char* CEC;
+    const char* BEC;
+};
+
+// Key byte i is i * 13 + 5, header byte i is i * 7 + HeaderSize and message
+// byte i is i * 31 + 3 * MessageSize
+
+// SHA256_HFC, StateSize 32 and BlockSize 64
+const vector<Vector> cSHA256Vectors = {
+    {0, 0,
+     "",
+     "3494ff595e2d67eb"},
+    {1, 1,
+     "f5",
+     "59f77e171dcaa78f"},
+    {0, 32,
+     "b376a90054e07cc4313cf9313b74ba826cb82e3a76209572109d52a15b2193a2",
+     "430a97ee070b8057"},
+    {32, 33,
+     "03deb59d7b5c8a5cb02e7bde61d348ad8429f08afcb3bdecb1a872b9470880a4"
+     "56",
+     "54c611fb17dd7e4a"},
+    {33, 64,
+     "779542117c11a9a15b5d5081824bc3c2c01f7e04c13427a03343112981eecb55"
+     "6c601f1f960715114d38b545b65c10d93065f0b9477aa44c3fbc52fec833360e",
+     "04c2031775b93f82"},
+    {64, 32,
+     "a0013e3ab538f49b02d18daf5221c8c70d47448fd11926dcc39a7d52d33de012",
+     "1a5e680fde9a8030"}
+};
+
+// SHA512_HFC, StateSize 64 and BlockSize 128
+const vector<Vector> cSHA512Vectors = {
+    {0, 0,
+     "",
+     "5e5d4633076eca49"},
+    {1, 1,
+     "6a",
+     "6864c772c7ba53c4"},
+    {0, 64,
+     "ae6a7650b132e26d1f035b9489e248018ecf9665d8e9d01b5392c3bda6afb00e"
+     "8f3737622646a04c7045cd414d40ea98fe3451f95871ac7e318f74815d157eb0",
+     "cdc5ee58fb62a25a"},
+    {64, 65,
+     "32fbb9356e97e83ad21f7d1a4cd40026147ab64ff175791a3b5a46a16ee25a57"
+     "604294967562c46298816a4c57e2e7487d824cc5f33a83a654da63df77942cc1"
+     "ca",
+     "519cfd5bc9f4ce13"},
+    {65, 128,
+     "fd77e5cd1022def89e820a73e161a6d9ca32a93615530664d2ebd8366dda68ba"
+     "9828a3338ba4cd2cfa183dccb10f275f7e5ea80f1b4a0ae2165c93acb1b05183"
+     "dfd0ea4e76026825e1e3871bdb9a5745457cb4cf8509cae06f60906f8f54540c"
+     "9d71a92e71665546b6fb42bfc238a027055bd2bb04e26e9dc9fc8ccd46c6055a",
+     "b7dede375fbacd35"},
+    {128, 64,
+     "4200b73706816e3dfb2fbafc5fadc6a3a352815f0820c61f90693dffebdbeb96"
+     "2335fea622f3efcba7790d0a2a6f7857921e26f89d5c73aff5a4d3ddca4c0b18",
+     "3fa058048db423ab"}
+};
+
+// Whrlpool_HFC, StateSize 64 and BlockSize 64
+const vector<Vector> cWhirlpoolVectors = {
+    {0, 0,
+     "",
+     "9da35ac681f1a89b"},
+    {1, 1,
+     "11",
+     "df26cd8859246dea"},
+    {0, 64,
+     "4246d542b4a95f5857d481baa909a322ebed8b123a15b49de470b16ebd8cb149"
+     "ad34e70fe7f009f83d10e617e3b0c3c704a41ae7bd8af1f5c0c5abbd30a4b742",
+     "c9a8888a40515d9d"},
+    {64, 65,
+     "ddea816704d84c01fa5dc2ee7ba5420933f6b459b362aa052942ded3cbb53746"
+     "5f00bd687f0aa1eae88ee250d446ff6e53d15890192b38204490862463d05b21"
+     "c8",
+     "0b831e3afeb9aabd"},
+    {65, 64,
+     "d436520c9a04d8b652fe60ec21ab1d641d4ec9e7b946759e426f07a451801ebc"
+     "ecdeaae937ec663b692338bca6221c92e4fe5c8bf1860d452de52f59539e4b46",
+     "6069d40aeb1d4c5d"},
+    {64, 64,
+     "ded77e5a07dd4b04f950cde378a0450c30ebab44b067ad002a4fd1dec8b03043"
+     "5c7d82957c0fa6efeb83ed5dd743f86b50cc478d1a2e3f25479d892960d55c24",
+     "d9a8ae82b2476e00"}
+};
+
+// SHA3_HFC, StateSize 200 and BlockSize 136
+const vector<Vector> cSHA3Vectors = {
+    {0, 0,
+     "",
+     "cad3f679ae8edc2ff787a3c3e604f833cc3e9a6f3d531ce484"},
+    {1, 1,
+     "f6",
+     "b9c6768407405be55db495fabb084434916a8aa846c2830877"},
+    {0, 200,
+     "075941921676d31fd2f4a504908c17175efd88d120b1c7a1a94df0941a0f3203"
+     "d66b96b92fb03d8a813ea38c902da3072c7a9ed3969bb9e30d8c473d431b1ae8"
+     "8496a0b7c10a8bb4dcc8df603885013f97a3db42e43873e5254e3f3d42604d25"
+     "55fad1794f4a0a8722ce81677f02cc3265c793d5c5bbc0c0be9070aca9990151"
+     "6b4c85079517d568d3fae3521810f5363e1762d9a3aeb33e450dc8144b49013a"
+     "8870e91833f6fc9349e1bab409f1f223ad0b600f2a0b663a79ba122808eddc2a"
+     "d2382023ee3603e1",
+     "dfe45cf3d5ad8dcb623b18773ddeb1800bb18144dc833c4559"},
+    {200, 201,
+     "4e34e69ec0ea30d56d29e1ac444d6e38ad34de329435cce9f5ae50f434a05462"
+     "3032410118d74d96445ef617f0f79f711fd80da66e51857a8af7f6b72b81c391"
+     "2020ab568b85dd08d6f597caf8a0bd625c98350f5939b8d9c5de7b8c00cddbb6"
+     "1a6e75c862e0264770e266f9af2ea08b5138c87fb42bd482ffab4861c59fb9d7"
+     "89b212ba8091198dbee8f2ab430234dea686d6eb4539225f9407c329d777124c"
+     "0c8677d94e50596d750c257581ea5016ea4d5c407bd97b0d12b1090d15f60050"
+     "4bcfc67cb4cafa17d8",
+     "8dc27239902c12b3edc590b11f8833eebcf0640a1874b1105a"},
+    {201, 136,
+     "d82f9027034df7131f0e67eff870472e49b6b4b96a8f7d0df4620d2e88a057b0"
+     "488a0e219b595c56a33432ba723c4f8b2986ab1a67a1edcfa7c2debd94f2d0b4"
+     "1642b631bbf237a82ee91655627a7c848e3f5b5a9f1778f9fc9aac2856e79333"
+     "c081ad5563edcae2280ab5c660417a128bbfb38d72c8448e28f24fb0715858e8"
+     "71eec483e0b2e45e",
+     "c374cc5f80ef2db17632e8a2b4914232846671dba695a4b27f"},
+    {136, 200,
+     "e5087c02f57327b01986f1b9be8a47baee83e59ceec80f35c9eb1a35b49ec974"
+     "d889f23620ce775b4c0825917076e2771ddce11f133e7e4d757c9573c8f05e01"
+     "7a374bc2f4988b3d91ac7fae91527e72374b6e4a573104a3d705d55b736849c2"
+     "a73767bcf0a907b2d50bf199b249d967979faf7496b38f6553772686bf74a082"
+     "3fc501badbf87bd92a7ae6fccd741c807031d03748b1ba16b0dde2d15761819a"
+     "d54441a68c52f2bc4a4c3ed429199137c42f298b23d0ee2e4331efd594c2bead"
+     "e6f3dd14b84dc1b7",
+     "a4214dfbdc229b634ea90abef6e5cf819b1d521e8e93e1531d"}
+};
+
+// AltPad_SHA256_HFC, the last five headers are shorter, as long as and longer than
+// the MessageBlocks * cPadSize bytes of the header which pad the message blocks
+const vector<Vector> cAltPadVectors = {
+    {0, 0,
+     "",
+     "95850c9a7ee55342"},
+    {1, 1,
+     "f5",
+     "59f77e171dcaa78f"},
+    {0, 32,
+     "f4de528f1a784862c9059382330c721bd53cb14ebb89ab0d3ad5ec24115be763",
+     "1763b612829ba97f"},
+    {32, 33,
+     "f7236df2197d4f67ca089c8f3009751ed621ae53b88cac0839d8e329125ee066"
+     "77",
+     "92b8154b05fb773f"},
+    {33, 64,
+     "3656361104d6a87cefba64fd4eba57015be08b617c0608acc5c20f86650f0f28"
+     "2a6d91313eddef658737aa882b3e88e4594039d54a3b5dc24c74570c45062b92",
+     "39a71c2286207a68"},
+    {64, 32,
+     "a0013e3ab538f49b02d18daf5221c8c70d47448fd11926dcc39a7d52d33de012",
+     "1a5e680fde9a8030"},
+    {16, 64,
+     "547e322ffad828c229a5f322d3ac12bb359cd1ee5b29cbadda758c84f1fb87c3"
+     "296da98c0152047103a0098ddcff1af7e503aa616db8d716f63aa2a3a5c48122",
+     "3db8a6c2b5a404d6"},
+    {48, 64,
+     "5340d8314978a172d97cb16f008fd133e05fd10278c81f5fc849e907e184544f"
+     "220d718e53c7a3e124033939f4b09da2d23e2655cec5051a2d4e737e95f0bb04",
+     "a6d2338e661734b0"},
+    {95, 100,
+     "b8eaa6bb6e44b45eb53167b64740bed79968659aefd577d1668138f045172baf"
+     "66b0e02335bb31bb07e341498fea717a17be0728480a2eaf6f8fece15207636f"
+     "e34d4bcbe74b38c77f31f9b133b68bc6831d0a9d26bcbe63b035f59cedeb6579"
+     "884c5efd",
+     "27d84750b5f9515a"},
+    {96, 100,
+     "b8eaa6bb6e44b45eb53167b64740bed79968659aefd577d1668138f045172baf"
+     "eff373cdca05562dde296c3d39e48dc28b850304b254cea00215789d4aed9911"
+     "32076c5de6640c290082e294b13bf80bb998230f5bdba33f24de4238b2bfae28"
+     "b9430523",
+     "66d431dc9e88e2de"},
+    {200, 100,
+     "271a2ee015b7acbbcc436eba6a58af8ed0ea36e52ae88665203bacfe3856093c"
+     "fc5dd2beeb82842cf4d91770cfa5e0f70d21d49382fad690c61da3be3670e6cd"
+     "d20ee6ab6a31e909f44f4f94f03b1115269cd4f4f845fb939a1c2d55d60b51da"
+     "cc61bcb7",
+     "fb0ae08521bbc580"}
+};
+
+class TestHFCKAT: public Tester
+{
+public:
+    TestHFCKAT(uint32_t Iterations,
+               string& Logfile,
+               IHFCScheme* HFC,
+               const vector<Vector>& Vectors):
+        Tester(Iterations, Logfile),
+        mHFC(HFC),
+        mVectors(Vectors),
+        mKey(Generate(HFC->GetBlockSize(), 13, 5))
+    {}
+    ~TestHFCKAT()
+    {
+        delete mHFC;
+    }
+    bool TestRound()
+    {
+        for (const Vector& Known: mVectors)
+        {
+            string Case = "Header size " + to_string(Known.HeaderSize) + ", message size " +
+                          to_string(Known.MessageSize) + " - ";
+            string H = Generate(Known.HeaderSize, 7, Known.HeaderSize);
+            string M = Generate(Known.MessageSize, 31, 3 * Known.MessageSize);
+            string CEC, BEC, Output;
+            StartTime(0);
+            mHFC->EC(mKey, H, (const unsigned char*)M.data(), M.size(), CEC, BEC);
+            AddTime(0);
+            if (ToHex(CEC) != Known.CEC || ToHex(BEC) != Known.BEC)
+            {
+                HandleOutput(Case + "EC differs from the known answer");
+                return false;
+            }
+            StartTime(1);
+            bool Success = mHFC->DO(mKey, H, (const unsigned char*)CEC.data(), CEC.size(), BEC, Output);
+            AddTime(1);
+            if (!Success || Output != M)
+            {
+                HandleOutput(Case + "DO of the known answer has failed");
+                return false;
+            }
+            StartTime(2);
+            Success = mHFC->EVer(H, M, mKey, BEC);
+            AddTime(2);
+            string Wrong = BEC;
+            Wrong[0] ^= 0x01;
+            if (!Success || mHFC->EVer(H, M, mKey, Wrong))
+            {
+                HandleOutput(Case + "EVer of the known answer has failed");
+                return false;
+            }
+            // The chains in odd parts have to give the same answer
+            StartTime(3);
+            string ChainBEC;
+            Chain(IHFCScheme::ChainEC, H, M, Output, ChainBEC);
+            AddTime(3);
+            if (Output != CEC || ChainBEC != BEC)
+            {
+                HandleOutput(Case + "Chain of EC differs from the known answer");
+                return false;
+            }
+            if (!Chain(IHFCScheme::ChainDO, H, CEC, Output, BEC) || Output != M)
+            {
+                HandleOutput(Case + "Chain of DO of the known answer has failed");
+                return false;
+            }
+            if (!Chain(IHFCScheme::ChainEVer, H, M, Output, BEC) ||
+                Chain(IHFCScheme::ChainEVer, H, M, Output, Wrong))
+            {
+                HandleOutput(Case + "Chain of EVer of the known answer has failed");
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+	/// \brief Returns Size bytes with the byte i set to i * Factor + Offset
+	/// \param Size number of bytes
+	/// \param Factor of the index
+	/// \param Offset of every byte
+    static string Generate(size_t Size, uint32_t Factor, uint32_t Offset)
+    {
+        string Output(Size, '0');
+        for (size_t i = 0; i < Size; i++)
+        {
+            Output[i] = (char)(i * Factor + Offset);
+        }
+        return Output;
+    }
+	/// \brief Returns the bytes as lower case hex
+	/// \param Input the bytes
+    static string ToHex(const string& Input)
+    {
+        const char* Digits = "0123456789abcdef";
+        string Output;
+        for (unsigned char Byte: Input)
+        {
+            Output.push_back(Digits[Byte >> 4]);
+            Output.push_back(Digits[Byte & 0x0f]);
+        }
+        return Output;
+    }
+	/// \brief Runs a chain with the input in the odd parts of cParts
+	/// \param Mode function of the chain
+	/// \param Header for the chain
+	/// \param Input the message (EC, EVer) or CEC (DO)
+	/// \param Output outputs CEC (EC) or the message (DO)
+	/// \param BEC reference outputs the commitment (EC) or the commitment to check (DO, EVer)
+    bool Chain(IHFCScheme::ChainMode Mode,
+               const string& Header,
+               const string& Input,
+               string& Output,
+               string& BEC)
+    {
+        mHFC->StartChain(Mode, mKey, (const unsigned char*)Header.data(), Header.size());
+        Output.resize(Input.size() + mHFC->GetStateSize() + mHFC->GetBlockSize());
+        size_t Written = 0;
+        for (size_t Offset = 0, i = 0; Offset < Input.size(); i++)
+        {
+            size_t Length = min(cParts[i % cParts.size()], Input.size() - Offset);
+            size_t OutputSize = Output.size() - Written;
+            mHFC->UpdateChain((const unsigned char*)Input.data() + Offset, Length,
+                              (unsigned char*)&Output[Written], OutputSize);
+            Written += OutputSize;
+            Offset += Length;
+        }
+        size_t OutputSize = Output.size() - Written;
+        bool Success = mHFC->FinishChain((unsigned char*)&Output[Written], OutputSize, BEC);
+        Output.resize(Written + OutputSize);
+        return Success;
+    }
+
+    // Odd part sizes which split the blocks and the state at other offsets every time
+    const vector<size_t> cParts = {1, 3, 7, 13, 61};
+    IHFCScheme* mHFC;
+    const vector<Vector>& mVectors;
+    string mKey;
+};
+
+int main()
+{
+    uint32_t TestIterations = 10;
+    string Logfile = "LogUnitTests.txt";
+    try
+    {
+        vector<pair<IHFCScheme*, const vector<Vector>*>> HFCs;
+        HFCs.push_back(make_pair(new SHA256_HFC(), &cSHA256Vectors));
+        HFCs.push_back(make_pair(new SHA512_HFC(), &cSHA512Vectors));
+        HFCs.push_back(make_pair(new Whrlpool_HFC(), &cWhirlpoolVectors));
+        HFCs.push_back(make_pair(new SHA3_HFC(), &cSHA3Vectors));
+        HFCs.push_back(make_pair(new AltPad_SHA256_HFC(), &cAltPadVectors));
+        for (auto& HFC: HFCs)
+        {
+            string Name = HFC.first->GetClassDecription();
+            TestHFCKAT Test(TestIterations,
+                            Logfile,
+                            HFC.first,
+                            *HFC.second);
+            uint32_t i;
+            for (i = 1;Test.TestRound() && i < TestIterations; i++);
+            Test.PrintTime(i, 0, Name + " known answers of EC");
+            Test.PrintTime(i, 1, Name + " known answers of DO");
+            Test.PrintTime(i, 2, Name + " known answers of EVer");
+            Test.PrintTime(i, 3, Name + " known answers of the EC chain");
+            Test.HandleOutput("", false);
+        }
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
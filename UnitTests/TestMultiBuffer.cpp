@@ -0,0 +1,181 @@
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "../Tester.h"
+#include "../HFC/SHA256_HFC.h"
+#include "../HFC/SHA512_HFC.h"
+#include "../HFC/MultiBuffer_HFC.h"
+
+class TestMultiBuffer: public Tester
+{
+public:
+    TestMultiBuffer(uint32_t Iterations,
+                    string& Logfile,
+                    string& Message,
+                    IHFCScheme* HFC,
+                    uint32_t Lanes):
+        Tester(Iterations, Logfile),
+        mHFC(HFC),
+        mLanes(Lanes),
+        mImage(ReadImage(Message))
+    {
+        // Messages of many sizes, also empty ones and ones shorter than a block
+        for (uint32_t i = 0; i < cCount; i++)
+        {
+            size_t MessageSize = i % 7 == 0 ? 0 : (i * 997) % (mImage.size() < 8192 ? mImage.size() : 8192);
+            size_t HeaderSize = (i * 37) % 300;
+            mKECs.push_back(mHFC->EKg());
+            mH.push_back(mImage.substr(i, HeaderSize));
+            mM.push_back(mImage.substr(mImage.size() - MessageSize, MessageSize));
+            mCEC.push_back(string(MessageSize, '0'));
+            mReference.push_back(string(MessageSize, '0'));
+            mOutput.push_back(string(MessageSize, '0'));
+        }
+        for (uint32_t i = 0; i < cCount; i++)
+        {
+            mHeaders.push_back((const unsigned char*)mH[i].data());
+            mHeaderSizes.push_back(mH[i].size());
+            mMessages.push_back((const unsigned char*)mM[i].data());
+            mSizes.push_back(mM[i].size());
+            mCECs.push_back((unsigned char*)&mCEC[i][0]);
+            mOutputs.push_back((unsigned char*)&mOutput[i][0]);
+        }
+        mBECs.resize(cCount);
+        mReferenceBECs.resize(cCount);
+    }
+    ~TestMultiBuffer()
+    {
+        delete mHFC;
+    }
+    bool TestRound()
+    {
+        // EC of every message with the scalar function
+        StartTime(0);
+        for (uint32_t i = 0; i < cCount; i++)
+        {
+            mHFC->EC(mKECs[i], mHeaders[i], mHeaderSizes[i], mMessages[i], mSizes[i],
+                     (unsigned char*)&mReference[i][0], mReferenceBECs[i]);
+        }
+        AddTime(0);
+        // EC of all messages in the lanes
+        HFCBatch Batch = {IHFCScheme::ChainEC, cCount, mKECs.data(), mHeaders.data(), mHeaderSizes.data(),
+                          mMessages.data(), mSizes.data(), mCECs.data(), NULL, mBECs.data(), mValid};
+        StartTime(1);
+        Run(Batch);
+        AddTime(1);
+        if (mCEC != mReference || mBECs != mReferenceBECs)
+        {
+            HandleOutput("EC of the lanes differs from the scalar EC");
+            return false;
+        }
+        // DO of all ciphers in the lanes
+        vector<const unsigned char*> CECs(mCECs.begin(), mCECs.end());
+        Batch = {IHFCScheme::ChainDO, cCount, mKECs.data(), mHeaders.data(), mHeaderSizes.data(),
+                 CECs.data(), mSizes.data(), mOutputs.data(), mBECs.data(), NULL, mValid};
+        StartTime(2);
+        size_t Valid = Run(Batch);
+        AddTime(2);
+        if (Valid != cCount || mOutput != mM)
+        {
+            HandleOutput("DO of the lanes has failed");
+            return false;
+        }
+        // EVer of all messages in the lanes, one commitment is wrong
+        mBECs[cCount / 2][0] ^= 0x01;
+        Batch = {IHFCScheme::ChainEVer, cCount, mKECs.data(), mHeaders.data(), mHeaderSizes.data(),
+                 mMessages.data(), mSizes.data(), NULL, mBECs.data(), NULL, mValid};
+        StartTime(3);
+        Valid = Run(Batch);
+        AddTime(3);
+        if (Valid != cCount - 1 || mValid[cCount / 2])
+        {
+            HandleOutput("EVer of the lanes has not found the wrong commitment");
+            return false;
+        }
+        return true;
+    }
+
+private:
+	/// \brief Runs a batch on the engine of the scheme
+	/// \param Batch the jobs
+    size_t Run(const HFCBatch& Batch)
+    {
+        string IV(mHFC->GetStateSize(), '0');
+        if (mHFC->GetStateSize() == 32)
+        {
+            return MultiBuffer_HFC::SHA256(Batch, (const uint8_t*)IV.data(), mLanes);
+        }
+        return MultiBuffer_HFC::SHA512(Batch, (const uint8_t*)IV.data(), mLanes);
+    }
+
+    static const uint32_t cCount = 50;
+    IHFCScheme* mHFC;
+    uint32_t mLanes;
+    string mImage;
+    vector<string> mKECs;
+    vector<string> mH;
+    vector<string> mM;
+    vector<string> mCEC;
+    vector<string> mReference;
+    vector<string> mOutput;
+    vector<string> mBECs;
+    vector<string> mReferenceBECs;
+    vector<const unsigned char*> mHeaders;
+    vector<size_t> mHeaderSizes;
+    vector<const unsigned char*> mMessages;
+    vector<size_t> mSizes;
+    vector<unsigned char*> mCECs;
+    vector<unsigned char*> mOutputs;
+    bool mValid[cCount];
+};
+
+int main(int argc, char** argv)
+{
+    uint32_t TestIterations = 20;
+    string Logfile = "LogUnitTests.txt";
+    string TestImage = "../Images/big.jpg";
+    if (argc > 1)
+    {
+        TestImage = string(argv[1]);
+    }
+    try
+    {
+        if (MultiBuffer_HFC::GetSHA256Lanes() == 0)
+        {
+            cout << "The CPU has no AVX2, nothing to test" << endl;
+            return 0;
+        }
+        // Every engine the CPU can run, SHA256 with 8 and 16 lanes, SHA512 with 4 and 8
+        vector<pair<IHFCScheme*, uint32_t>> Engines;
+        for (uint32_t Lanes = 8; Lanes <= MultiBuffer_HFC::GetSHA256Lanes(); Lanes *= 2)
+        {
+            Engines.push_back(make_pair(new SHA256_HFC(), Lanes));
+        }
+        for (uint32_t Lanes = 4; Lanes <= MultiBuffer_HFC::GetSHA512Lanes(); Lanes *= 2)
+        {
+            Engines.push_back(make_pair(new SHA512_HFC(), Lanes));
+        }
+        for (auto& Engine: Engines)
+        {
+            string Name = Engine.first->GetClassDecription() + " " + to_string(Engine.second) + " lanes";
+            TestMultiBuffer Test(TestIterations,
+                                 Logfile,
+                                 TestImage,
+                                 Engine.first,
+                                 Engine.second);
+            uint32_t i;
+            for (i = 1;Test.TestRound() && i < TestIterations; i++);
+            Test.PrintTime(i, 0, "Scalar EC " + Name);
+            Test.PrintTime(i, 1, "Multi-buffer EC " + Name);
+            Test.PrintTime(i, 2, "Multi-buffer DO " + Name);
+            Test.PrintTime(i, 3, "Multi-buffer EVer " + Name);
+            Test.HandleOutput("", false);
+        }
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
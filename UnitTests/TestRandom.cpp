@@ -0,0 +1,118 @@
+#include <iostream>
+using namespace std;
+
+#include <cryptopp/osrng.h>
+using namespace CryptoPP;
+
+#include "../Tester.h"
+#include "../Random.h"
+#include "../HFC/CETransformation.h"
+#include "../HFC/SHA256_HFC.h"
+#include "../AEAD/AES_GCM.h"
+
+class TestRandom: public Tester
+{
+public:
+    TestRandom(uint32_t Iterations,
+               string& Logfile,
+               string& Key,
+               string& Nonce,
+               string& Message,
+               ICEScheme* CE):
+        Tester(Iterations, Logfile),
+        mKey(Key),
+        mHeader(16, 'h'),
+        mM(ReadImage(Message)),
+        mSmallM(64, 'm'),
+        mKeyf(32, '0'),
+        mCE(CE)
+    {
+        mCE->SetNonce(Nonce);
+    }
+    ~TestRandom()
+    {
+        delete mCE;
+    }
+    bool TestRound()
+    {
+        // Opening key with a new pool, like EKg did for every encryption
+        StartTime(0);
+        AutoSeededRandomPool Rnd;
+        Rnd.GenerateBlock((unsigned char*)&mKeyf[0], mKeyf.size());
+        AddTime(0);
+        // Opening key with the generator of the thread
+        StartTime(1);
+        RandomGenerator::Generate((unsigned char*)&mKeyf[0], mKeyf.size());
+        AddTime(1);
+        // Encryption of a small message
+        StartTime(2);
+        mCE->Enc(mKey, mHeader, mSmallM, mC1, mC2);
+        AddTime(2);
+        mCE->IncreaseNonce();
+        // Encryption of the image
+        StartTime(3);
+        mCE->Enc(mKey, mHeader, mM, mC1, mC2);
+        AddTime(3);
+        mCE->IncreaseNonce();
+        return true;
+    }
+    /// \brief Prints the share of the old opening key generation in an encryption
+	/// \param VectorPosition time of the encryption
+	/// \param Description of the encryption
+    void PrintShare(uint8_t VectorPosition, const string& Description)
+    {
+        double Pool = GetHistogram(0).GetMean();
+        double Generator = GetHistogram(1).GetMean();
+        // The measured encryption already uses the generator
+        double OldEnc = GetHistogram(VectorPosition).GetMean() - Generator + Pool;
+        HandleOutput("Share of the pool in the old " + Description + ": " +
+                     to_string(OldEnc > 0.0 ? 100.0 * Pool / OldEnc : 0.0) + " %");
+    }
+
+private:
+    string mKey;
+    string mHeader;
+    string mM;
+    string mSmallM;
+    string mKeyf;
+    string mC1;
+    string mC2;
+    ICEScheme* mCE;
+};
+
+int main(int argc, char** argv)
+{
+    ICEScheme* CE = new CETransformation(new SHA256_HFC(), new AES_GCM());
+    uint32_t TestIterations = 200;
+    string Logfile = "LogUnitTests.txt";
+    string TestKey(CE->GetKeySize(), 'a');
+    string TestNonce(CE->GetNonceSize(), 'b');
+    string TestImage = "../Images/big.jpg";
+    if (argc > 1)
+    {
+        TestImage = string(argv[1]);
+    }
+    try
+    {
+        TestRandom Test(TestIterations,
+                        Logfile,
+                        TestKey,
+                        TestNonce,
+                        TestImage,
+                        CE);
+        uint32_t i;
+        for (i = 1;Test.TestRound() && i < TestIterations; i++);
+        Test.PrintTime(i, 0, "AutoSeededRandomPool for a 32 byte opening key");
+        Test.PrintTime(i, 1, "RandomGenerator for a 32 byte opening key");
+        Test.PrintTime(i, 2, "CETransformation encryption of 64 bytes");
+        Test.PrintTime(i, 3, "CETransformation encryption of the image");
+        Test.PrintShare(2, "encryption of 64 bytes");
+        Test.PrintShare(3, "encryption of the image");
+        Test.HandleOutput("", false);
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
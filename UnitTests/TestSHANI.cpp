@@ -0,0 +1,213 @@
+#include <iostream>
+using namespace std;
+
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/misc.h>
+#include <cryptopp/sha.h>
+using namespace CryptoPP;
+
+#include "../Tester.h"
+#include "../HFC/SHA256_SHANI.h"
+
+class TestSHANI: public Tester
+{
+public:
+    TestSHANI(uint32_t Iterations,
+              string& Logfile,
+              string& Message):
+        Tester(Iterations, Logfile),
+        mM(ReadImage(Message))
+    {
+        // Only full blocks are chained
+        mM.resize(mM.size() / STATESIZE * STATESIZE);
+        // Every chain of the interleaved kernel has its own key
+        for (uint32_t w = 0; w < SHA256_SHANI::cMaxWays; w++)
+        {
+            mKeys[w].resize(BLOCKSIZE);
+            for (uint32_t i = 0; i < BLOCKSIZE; i++)
+            {
+                mKeys[w][i] = (char)(i * 7 + 1 + w);
+            }
+            mOutputs[w].assign(mM.size(), '0');
+            mReferences[w].assign(mM.size(), '0');
+        }
+    }
+    ~TestSHANI()
+    {}
+    bool TestRound()
+    {
+        uint64_t Blocks = mM.size() / STATESIZE;
+        for (uint8_t Mode = 0; Mode < 3; Mode++)
+        {
+            IHFCScheme::ChainMode ChainMode = (IHFCScheme::ChainMode)Mode;
+            word32 State[STATESIZE / sizeof(word32)];
+            word32 ReferenceState[STATESIZE / sizeof(word32)];
+            SHA256::InitState(State);
+            SHA256::InitState(ReferenceState);
+            // Loop with xorbuf and SHA256::Transform
+            StartTime(2 * Mode);
+            Reference(ReferenceState, 0, Blocks, ChainMode);
+            AddTime(2 * Mode);
+            // Kernel with the SHA extensions
+            StartTime(2 * Mode + 1);
+            SHA256_SHANI::Chain(State, (const uint8_t*)mKeys[0].data(), (const uint8_t*)mM.data(),
+                                ChainMode == IHFCScheme::ChainEVer ? NULL : (uint8_t*)&mOutputs[0][0],
+                                Blocks, ChainMode);
+            AddTime(2 * Mode + 1);
+            if (memcmp(State, ReferenceState, STATESIZE) != 0 ||
+                (ChainMode != IHFCScheme::ChainEVer && mOutputs[0] != mReferences[0]))
+            {
+                HandleOutput("Kernel differs from SHA256::Transform in mode " + to_string(Mode));
+                return false;
+            }
+            if (!TestInterleaved(Blocks, ChainMode))
+            {
+                HandleOutput("Interleaved kernel differs from SHA256::Transform in mode " + to_string(Mode));
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /// \brief Chains the blocks of every number of ways with the interleaved kernel
+	/// \param Blocks number of 32 byte blocks
+	/// \param Mode function of the chains
+    /// \details Also times SHA256_SHANI::cWays chains one after the other and interleaved
+    bool TestInterleaved(uint64_t Blocks, IHFCScheme::ChainMode Mode)
+    {
+        word32 States[SHA256_SHANI::cMaxWays][STATESIZE / sizeof(word32)];
+        word32 ReferenceStates[SHA256_SHANI::cMaxWays][STATESIZE / sizeof(word32)];
+        uint32_t* StatePointers[SHA256_SHANI::cMaxWays];
+        const uint8_t* Keys[SHA256_SHANI::cMaxWays];
+        const uint8_t* Inputs[SHA256_SHANI::cMaxWays];
+        uint8_t* Outputs[SHA256_SHANI::cMaxWays];
+        for (uint32_t w = 0; w < SHA256_SHANI::cMaxWays; w++)
+        {
+            SHA256::InitState(ReferenceStates[w]);
+            Reference(ReferenceStates[w], w, Blocks, Mode);
+            StatePointers[w] = States[w];
+            Keys[w] = (const uint8_t*)mKeys[w].data();
+            Inputs[w] = (const uint8_t*)mM.data();
+            Outputs[w] = Mode == IHFCScheme::ChainEVer ? NULL : (uint8_t*)&mOutputs[w][0];
+        }
+        for (uint32_t Ways = 1; Ways <= SHA256_SHANI::cMaxWays; Ways++)
+        {
+            for (uint32_t w = 0; w < Ways; w++)
+            {
+                SHA256::InitState(States[w]);
+            }
+            if (Ways == SHA256_SHANI::cWays)
+            {
+                // The same chains one after the other
+                StartTime(6 + 2 * Mode);
+                for (uint32_t w = 0; w < Ways; w++)
+                {
+                    SHA256_SHANI::Chain(States[w], Keys[w], Inputs[w], Outputs[w], Blocks, Mode);
+                }
+                AddTime(6 + 2 * Mode);
+                for (uint32_t w = 0; w < Ways; w++)
+                {
+                    SHA256::InitState(States[w]);
+                }
+                StartTime(7 + 2 * Mode);
+            }
+            SHA256_SHANI::ChainInterleaved(StatePointers, Keys, Inputs, Outputs, Blocks, Ways, Mode);
+            if (Ways == SHA256_SHANI::cWays)
+            {
+                AddTime(7 + 2 * Mode);
+            }
+            for (uint32_t w = 0; w < Ways; w++)
+            {
+                if (memcmp(States[w], ReferenceStates[w], STATESIZE) != 0 ||
+                    (Mode != IHFCScheme::ChainEVer && mOutputs[w] != mReferences[w]))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    /// \brief Chains the blocks like the loops of SHA256_HFC
+	/// \param State the SHA256 state
+	/// \param Way index of the key and the output
+	/// \param Blocks number of 32 byte blocks
+	/// \param Mode function of the chain
+    void Reference(word32* State, uint32_t Way, uint64_t Blocks, IHFCScheme::ChainMode Mode)
+    {
+        const uint8_t* KeyPointer = (const uint8_t*)mKeys[Way].data();
+        const uint8_t* Input = (const uint8_t*)mM.data();
+        uint8_t* Output = (uint8_t*)&mReferences[Way][0];
+        uint8_t XorBuffer[BLOCKSIZE];
+        memcpy(XorBuffer, KeyPointer, BLOCKSIZE);
+        for (uint64_t i = 0; i < Blocks; i++)
+        {
+            if (Mode == IHFCScheme::ChainDO)
+            {
+                xorbuf(Output, Input, (uint8_t*)State, STATESIZE);
+                xorbuf(XorBuffer, Output, KeyPointer, STATESIZE);
+            }
+            else
+            {
+                xorbuf(XorBuffer, Input, KeyPointer, STATESIZE);
+                if (Mode == IHFCScheme::ChainEC)
+                {
+                    xorbuf(Output, Input, (uint8_t*)State, STATESIZE);
+                }
+            }
+            SHA256::Transform(State, (word32*)XorBuffer);
+            Input += STATESIZE;
+            Output += STATESIZE;
+        }
+    }
+
+    static const uint32_t BLOCKSIZE = 64;
+    static const uint32_t STATESIZE = 32;
+    string mKeys[SHA256_SHANI::cMaxWays];
+    string mM;
+    string mOutputs[SHA256_SHANI::cMaxWays];
+    string mReferences[SHA256_SHANI::cMaxWays];
+};
+
+int main(int argc, char** argv)
+{
+    uint32_t TestIterations = 200;
+    string Logfile = "LogUnitTests.txt";
+    string TestImage = "../Images/big.jpg";
+    if (argc > 1)
+    {
+        TestImage = string(argv[1]);
+    }
+    try
+    {
+        TestSHANI Test(TestIterations,
+                       Logfile,
+                       TestImage);
+        if (!SHA256_SHANI::IsAvailable())
+        {
+            Test.HandleOutput("The CPU has no SHA extensions, nothing to test");
+            return 0;
+        }
+        uint32_t i;
+        for (i = 1;Test.TestRound() && i < TestIterations; i++);
+        Test.PrintTime(i, 0, "SHA256::Transform chain EC");
+        Test.PrintTime(i, 1, "SHA extensions chain EC");
+        Test.PrintTime(i, 2, "SHA256::Transform chain DO");
+        Test.PrintTime(i, 3, "SHA extensions chain DO");
+        Test.PrintTime(i, 4, "SHA256::Transform chain EVer");
+        Test.PrintTime(i, 5, "SHA extensions chain EVer");
+        string Ways = to_string(SHA256_SHANI::cWays);
+        Test.PrintTime(i, 6, "SHA extensions " + Ways + " chains EC");
+        Test.PrintTime(i, 7, "SHA extensions " + Ways + " chains interleaved EC");
+        Test.PrintTime(i, 8, "SHA extensions " + Ways + " chains DO");
+        Test.PrintTime(i, 9, "SHA extensions " + Ways + " chains interleaved DO");
+        Test.PrintTime(i, 10, "SHA extensions " + Ways + " chains EVer");
+        Test.PrintTime(i, 11, "SHA extensions " + Ways + " chains interleaved EVer");
+        Test.HandleOutput("", false);
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "../Tester.h"
+#include "SchemeTests.h"
+
+class TestStream: public Tester
+{
+public:
+    TestStream(uint32_t Iterations,
+               string& Logfile,
+               string& Header,
+               string& Message,
+               ICEScheme* CE,
+               bool Deterministic):
+        Tester(Iterations, Logfile),
+        mCE(CE),
+        mDeterministic(Deterministic),
+        mKey(CE->Kg()),
+        mNonce(RandomGenerator::Generate(CE->GetNonceSize())),
+        mH(ReadImage(Header)),
+        mM(ReadImage(Message))
+    {}
+    ~TestStream()
+    {
+        delete mCE;
+    }
+    bool TestRound()
+    {
+        IncreaseString(mNonce);
+        mCE->SetNonce(mNonce);
+        // Encryption in one call and in uneven parts with the same nonce
+        StartTime(0);
+        mCE->Enc(mKey, mH, mM, mC1, mC2);
+        AddTime(0);
+        string StreamC1, StreamC2;
+        StartTime(1);
+        StreamEnc(StreamC1, StreamC2);
+        AddTime(1);
+        if (mDeterministic && (StreamC1 != mC1 || StreamC2 != mC2))
+        {
+            HandleOutput("Incremental encryption differs from the encryption");
+            return false;
+        }
+        // CtE and the CETransformation draw a new opening key, so their parts are checked by Dec
+        if (!mCE->Dec(mKey, mH, StreamC1, StreamC2, mOutput, mKeyf) || mOutput != mM)
+        {
+            HandleOutput("Decryption of the incremental encryption has failed");
+            return false;
+        }
+        // Decryption and verification of the encryption in uneven parts
+        StartTime(2);
+        bool Success = StreamDec(mC1, mC2, mOutput, mKeyf);
+        AddTime(2);
+        if (!Success || mOutput != mM)
+        {
+            HandleOutput("Incremental decryption has failed");
+            return false;
+        }
+        StartTime(3);
+        Success = StreamVer(mM, mKeyf, mC2);
+        AddTime(3);
+        if (!Success)
+        {
+            HandleOutput("Incremental verification has failed");
+            return false;
+        }
+        // One flipped byte at the start of C1, in T at the end of C1 and in C2
+        string Keyf;
+        string C1 = mC1;
+        C1[0] ^= 0x01;
+        if (StreamDec(C1, mC2, mOutput, Keyf))
+        {
+            HandleOutput("Incremental decryption has accepted a changed C1");
+            return false;
+        }
+        C1 = mC1;
+        C1[C1.size() - 1] ^= 0x01;
+        if (StreamDec(C1, mC2, mOutput, Keyf))
+        {
+            HandleOutput("Incremental decryption has accepted a changed T");
+            return false;
+        }
+        string C2 = mC2;
+        C2[0] ^= 0x01;
+        if (StreamDec(mC1, C2, mOutput, Keyf) || StreamVer(mM, mKeyf, C2))
+        {
+            HandleOutput("Incremental decryption or verification has accepted a changed C2");
+            return false;
+        }
+        string M = mM;
+        M[M.size() / 2] ^= 0x01;
+        if (StreamVer(M, mKeyf, mC2))
+        {
+            HandleOutput("Incremental verification has accepted a changed message");
+            return false;
+        }
+        return true;
+    }
+
+private:
+	/// \brief Encrypts mM in the uneven parts of cParts
+	/// \param C1 outputs the cipher for the message
+	/// \param C2 outputs the commitment
+    void StreamEnc(string& C1, string& C2)
+    {
+        C1.clear();
+        C2.resize(mCE->GetCommitmentSize());
+        string Output;
+        mCE->StartEnc(mKey, (const unsigned char*)mH.data(), mH.size());
+        for (size_t Offset = 0, i = 0; Offset < mM.size(); i++)
+        {
+            size_t Length = min(cParts[i % cParts.size()], mM.size() - Offset);
+            Output.resize(Length + mCE->GetStreamBlockSize());
+            size_t C1Length = Output.size();
+            mCE->UpdateEnc((const unsigned char*)mM.data() + Offset, Length, (unsigned char*)&Output[0], C1Length);
+            C1.append(Output, 0, C1Length);
+            Offset += Length;
+        }
+        Output.resize(mCE->GetCiphertextSize(mH.size(), mM.size()) - C1.size());
+        size_t C1Length = Output.size();
+        size_t C2Length = C2.size();
+        mCE->FinishEnc((unsigned char*)&Output[0], C1Length, (unsigned char*)&C2[0], C2Length);
+        C1.append(Output, 0, C1Length);
+        C2.resize(C2Length);
+    }
+	/// \brief Decrypts C1 in the uneven parts of cParts
+	/// \param C1 the cipher for the message
+	/// \param C2 the commitment
+	/// \param Message outputs the decrypted message
+	/// \param Keyf outputs the opening key
+    bool StreamDec(const string& C1, const string& C2, string& Message, string& Keyf)
+    {
+        // The trailer is given first, the rest of C1 in parts
+        size_t TrailerSize = mCE->GetTrailerSize();
+        size_t BodySize = C1.size() - TrailerSize;
+        Message.clear();
+        string Output;
+        mCE->StartDec(mKey, (const unsigned char*)mH.data(), mH.size(),
+                      (const unsigned char*)C2.data(), C2.size(),
+                      (const unsigned char*)C1.data() + BodySize, TrailerSize);
+        for (size_t Offset = 0, i = 0; Offset < BodySize; i++)
+        {
+            size_t Length = min(cParts[i % cParts.size()], BodySize - Offset);
+            Output.resize(Length + mCE->GetStreamBlockSize());
+            size_t MessageLength = Output.size();
+            mCE->UpdateDec((const unsigned char*)C1.data() + Offset, Length, (unsigned char*)&Output[0], MessageLength);
+            Message.append(Output, 0, MessageLength);
+            Offset += Length;
+        }
+        Output.resize(mCE->GetMaxPlaintextSize(C1.size()) + mCE->GetStreamBlockSize());
+        size_t MessageLength = Output.size();
+        bool Success = mCE->FinishDec((unsigned char*)&Output[0], MessageLength, Keyf);
+        Message.append(Output, 0, MessageLength);
+        return Success;
+    }
+	/// \brief Verifies the message in the uneven parts of cParts
+	/// \param Message the message to verify
+	/// \param Keyf the opening key
+	/// \param C2 the commitment
+    bool StreamVer(const string& Message, const string& Keyf, const string& C2)
+    {
+        mCE->StartVer((const unsigned char*)mH.data(), mH.size(), Keyf,
+                      (const unsigned char*)C2.data(), C2.size());
+        for (size_t Offset = 0, i = 0; Offset < Message.size(); i++)
+        {
+            size_t Length = min(cParts[i % cParts.size()], Message.size() - Offset);
+            mCE->UpdateVer((const unsigned char*)Message.data() + Offset, Length);
+            Offset += Length;
+        }
+        return mCE->FinishVer();
+    }
+
+    // Part sizes which are no multiple of any block size
+    const vector<size_t> cParts = {1, 7, 63, 1000, 4093};
+    ICEScheme* mCE;
+    bool mDeterministic;
+    string mKey;
+    string mNonce;
+    string mH;
+    string mM;
+    string mC1;
+    string mC2;
+    string mOutput;
+    string mKeyf;
+};
+
+int main(int argc, char** argv)
+{
+    uint32_t TestIterations = 20;
+    string Logfile = "LogUnitTests.txt";
+    string TestHeader = "Header of the incremental test";
+    string TestImage = "../Images/big.jpg";
+    if (argc > 1)
+    {
+        TestImage = string(argv[1]);
+    }
+    try
+    {
+        RunSchemeTests<TestStream>(TestIterations, Logfile, TestHeader, TestImage,
+                                   {"encryption", "incremental encryption",
+                                    "incremental decryption", "incremental verification"});
+    }
+    catch (const exception& e)
+    {
+        cout << e.what() << endl;
+        return 0;
+    }
+}
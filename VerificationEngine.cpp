@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+#include "VerificationEngine.h"
+
+VerificationEngine::VerificationEngine(const ICEScheme& Scheme,
+                                       uint32_t Threads):
+    mWorkers(Threads),
+    mHeaders(NULL),
+    mHeaderLengths(NULL),
+    mMessages(NULL),
+    mMessageLengths(NULL),
+    mKeyfs(NULL),
+    mC2(NULL),
+    mValid(NULL),
+    mBurst(0),
+    mStop(false),
+    mFinished(0)
+{
+    if (Threads == 0)
+    {
+        throw runtime_error("Need at least one thread for the verification engine");
+    }
+    for (Worker& State: mWorkers)
+    {
+        State.Context = new CEContext(Scheme);
+        State.Range.store(0);
+        State.ValidCount = 0;
+        State.Steals = 0;
+    }
+    // The calling thread is worker 0
+    for (uint32_t i = 1; i < Threads; i++)
+    {
+        mThreads.emplace_back(&VerificationEngine::RunWorker, this, i);
+    }
+}
+
+VerificationEngine::~VerificationEngine()
+{
+    {
+        lock_guard<mutex> Lock(mLock);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (thread& Thread: mThreads)
+    {
+        Thread.join();
+    }
+    for (Worker& State: mWorkers)
+    {
+        delete State.Context;
+    }
+}
+
+size_t VerificationEngine::Verify(size_t Count,
+                                  const unsigned char* const* Headers,
+                                  const size_t* HeaderLengths,
+                                  const unsigned char* const* Messages,
+                                  const size_t* MessageLengths,
+                                  const string* Keyfs,
+                                  const unsigned char* C2,
+                                  bool* Valid)
+{
+    if (Count == 0)
+    {
+        return 0;
+    }
+    if (Count > numeric_limits<uint32_t>::max())
+    {
+        throw runtime_error("Too many reports for one burst");
+    }
+    mHeaders = Headers;
+    mHeaderLengths = HeaderLengths;
+    mMessages = Messages;
+    mMessageLengths = MessageLengths;
+    mKeyfs = Keyfs;
+    mC2 = C2;
+    mValid = Valid;
+    Plan(Count);
+    mFinished.store(0);
+    // The mutex publishes the plan to the worker threads
+    {
+        lock_guard<mutex> Lock(mLock);
+        mBurst++;
+    }
+    mWake.notify_all();
+    Work(0);
+    while (mFinished.load(memory_order_acquire) < mThreads.size())
+    {
+        this_thread::yield();
+    }
+    size_t ValidCount = 0;
+    for (const Worker& State: mWorkers)
+    {
+        ValidCount += State.ValidCount;
+    }
+    return ValidCount;
+}
+
+uint32_t VerificationEngine::GetThreadCount() const
+{
+    return mWorkers.size();
+}
+
+uint64_t VerificationEngine::GetSteals() const
+{
+    uint64_t Steals = 0;
+    for (const Worker& State: mWorkers)
+    {
+        Steals += State.Steals;
+    }
+    return Steals;
+}
+
+void VerificationEngine::RunWorker(uint32_t Index)
+{
+    uint64_t Burst = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> Lock(mLock);
+            while (!mStop && mBurst == Burst)
+            {
+                mWake.wait(Lock);
+            }
+            if (mStop)
+            {
+                return;
+            }
+            Burst = mBurst;
+        }
+        Work(Index);
+        mFinished.fetch_add(1, memory_order_release);
+    }
+}
+
+void VerificationEngine::Work(uint32_t Index)
+{
+    Worker& State = mWorkers[Index];
+    ICEScheme& CE = State.Context->GetScheme();
+    size_t CommitmentSize = CE.GetCommitmentSize();
+    uint32_t Current = 0;
+    while (true)
+    {
+        if (!PopFront(State.Range, Current))
+        {
+            // Steal from the back, the owners work at the front
+            bool Stolen = false;
+            for (uint32_t i = 1; i < mWorkers.size() && !Stolen; i++)
+            {
+                Stolen = PopBack(mWorkers[(Index + i) % mWorkers.size()].Range, Current);
+            }
+            // No work is added during a burst, so every range is done
+            if (!Stolen)
+            {
+                return;
+            }
+            State.Steals++;
+        }
+        for (uint32_t Position = mDealt[Current].Begin; Position < mDealt[Current].End; Position++)
+        {
+            uint32_t i = mOrder[Position].second;
+            try
+            {
+                mValid[i] = CE.Ver(mHeaders[i], mHeaderLengths[i], mMessages[i], mMessageLengths[i],
+                                   mKeyfs[i], mC2 + i * CommitmentSize, CommitmentSize);
+            }
+            catch (const exception&)
+            {
+                // A malformed report is not valid, the others are still verified
+                mValid[i] = false;
+            }
+            State.ValidCount += mValid[i];
+        }
+    }
+}
+
+void VerificationEngine::Plan(size_t Count)
+{
+    // Largest reports first, so the chunks at the end of the ranges are small
+    mOrder.resize(Count);
+    uint64_t Total = 0;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        mOrder[i] = make_pair((uint64_t)mHeaderLengths[i] + mMessageLengths[i], i);
+        Total += mOrder[i].first + cReportOverhead;
+    }
+    sort(mOrder.rbegin(), mOrder.rend());
+    // Cut chunks of about the same number of bytes
+    uint64_t Target = max<uint64_t>(1, Total / ((uint64_t)mWorkers.size() * cChunksPerWorker));
+    mChunks.clear();
+    uint64_t Bytes = 0;
+    uint32_t Begin = 0;
+    for (uint32_t Position = 0; Position < Count; Position++)
+    {
+        Bytes += mOrder[Position].first + cReportOverhead;
+        if (Bytes >= Target || Position + 1 == Count)
+        {
+            mChunks.push_back({Begin, Position + 1});
+            Begin = Position + 1;
+            Bytes = 0;
+        }
+    }
+    // Deal round robin, so every worker gets large and small chunks
+    mDealt.clear();
+    for (uint32_t w = 0; w < mWorkers.size(); w++)
+    {
+        uint64_t Head = mDealt.size();
+        for (size_t c = w; c < mChunks.size(); c += mWorkers.size())
+        {
+            mDealt.push_back(mChunks[c]);
+        }
+        mWorkers[w].Range.store((Head << 32) | mDealt.size(), memory_order_relaxed);
+        mWorkers[w].ValidCount = 0;
+        mWorkers[w].Steals = 0;
+    }
+}
+
+bool VerificationEngine::PopFront(atomic<uint64_t>& Range, uint32_t& Index)
+{
+    uint64_t Current = Range.load(memory_order_acquire);
+    while (true)
+    {
+        uint32_t Head = Current >> 32;
+        uint32_t End = (uint32_t)Current;
+        if (Head >= End)
+        {
+            return false;
+        }
+        if (Range.compare_exchange_weak(Current, ((uint64_t)(Head + 1) << 32) | End, memory_order_acq_rel))
+        {
+            Index = Head;
+            return true;
+        }
+    }
+}
+
+bool VerificationEngine::PopBack(atomic<uint64_t>& Range, uint32_t& Index)
+{
+    uint64_t Current = Range.load(memory_order_acquire);
+    while (true)
+    {
+        uint32_t Head = Current >> 32;
+        uint32_t End = (uint32_t)Current;
+        if (Head >= End)
+        {
+            return false;
+        }
+        if (Range.compare_exchange_weak(Current, ((uint64_t)Head << 32) | (End - 1), memory_order_acq_rel))
+        {
+            Index = End - 1;
+            return true;
+        }
+    }
+}
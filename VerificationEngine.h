@@ -0,0 +1,122 @@
+#ifndef VERIFICATIONENGINE_H
+#define VERIFICATIONENGINE_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <cstdint>
+
+#include "ICEScheme.h"
+#include "CEContext.h"
+
+/// \brief VerificationEngine class which verifies bursts of reports on a pool of threads
+/// \details A report is the header, message, opening key and commitment of one
+/// reported message, the reports are independent. Verify sorts the reports by size
+/// and cuts the order into chunks of about the same number of bytes, so one chunk
+/// holds reports of similar size. The chunks are dealt round robin to the workers,
+/// every worker takes chunks from the front of its own range and steals from the
+/// back of the other ranges when its range is empty, both with one compare-exchange.
+/// Every worker verifies with its own CEContext of the scheme, the calling thread is
+/// worker 0. One engine verifies one burst at a time.
+class VerificationEngine
+{
+public:
+	/// \brief Construct a VerificationEngine and start the worker threads
+	/// \param Scheme the scheme of the reports, every worker gets a context of it
+	/// \param Threads number of workers including the calling thread
+    VerificationEngine(const ICEScheme& Scheme,
+                       uint32_t Threads);
+	/// \brief Destruct a VerificationEngine and stop the worker threads
+    ~VerificationEngine();
+    VerificationEngine(const VerificationEngine&) = delete;
+    VerificationEngine& operator=(const VerificationEngine&) = delete;
+    /// \brief Verifies a burst of reports, same layout as ICEScheme::VerBatch
+	/// \param Count number of reports
+	/// \param Headers pointers to the headers
+	/// \param HeaderLengths lengths of the headers
+	/// \param Messages pointers to the messages
+	/// \param MessageLengths lengths of the messages
+	/// \param Keyfs the opening key of every report
+	/// \param C2 the commitments, GetCommitmentSize bytes each
+	/// \param Valid outputs if every report was verified
+    /// \details Returns the number of valid reports. A report
+    ///          for which the scheme throws is not valid
+    size_t Verify(size_t Count,
+                  const unsigned char* const* Headers,
+                  const size_t* HeaderLengths,
+                  const unsigned char* const* Messages,
+                  const size_t* MessageLengths,
+                  const std::string* Keyfs,
+                  const unsigned char* C2,
+                  bool* Valid);
+	/// \brief Returns the number of workers including the calling thread
+    uint32_t GetThreadCount() const;
+	/// \brief Returns the number of chunks stolen during the last Verify
+    uint64_t GetSteals() const;
+
+private:
+    /// \brief State of one worker
+    /// \details Aligned to a cache line to avoid false sharing between the threads
+    struct alignas(64) Worker
+    {
+        CEContext* Context;
+        // Head in the upper and end in the lower 32 bits, indices into mDealt
+        std::atomic<uint64_t> Range;
+        size_t ValidCount;
+        uint64_t Steals;
+    };
+    /// \brief Reports of one chunk, positions in mOrder
+    struct Chunk
+    {
+        uint32_t Begin;
+        uint32_t End;
+    };
+	/// \brief Loop of a worker thread, waits for the next burst
+	/// \param Index of the worker
+    void RunWorker(uint32_t Index);
+	/// \brief Verifies chunks until no worker has one left
+	/// \param Index of the worker
+    void Work(uint32_t Index);
+	/// \brief Sorts the reports by size and deals the chunks to the workers
+	/// \param Count number of reports
+    void Plan(size_t Count);
+	/// \brief Takes the first chunk of a range, returns false if it is empty
+	/// \param Range of a worker
+	/// \param Index outputs the chunk
+    static bool PopFront(std::atomic<uint64_t>& Range, uint32_t& Index);
+	/// \brief Takes the last chunk of a range, returns false if it is empty
+	/// \param Range of another worker
+	/// \param Index outputs the chunk
+    static bool PopBack(std::atomic<uint64_t>& Range, uint32_t& Index);
+
+    std::vector<Worker> mWorkers;
+    std::vector<std::thread> mThreads;
+    // Size and index of the reports, largest first
+    std::vector<std::pair<uint64_t, uint32_t>> mOrder;
+    // Chunks of the order and the same chunks grouped by worker
+    std::vector<Chunk> mChunks;
+    std::vector<Chunk> mDealt;
+    // Reports of the running burst
+    const unsigned char* const* mHeaders;
+    const size_t* mHeaderLengths;
+    const unsigned char* const* mMessages;
+    const size_t* mMessageLengths;
+    const std::string* mKeyfs;
+    const unsigned char* mC2;
+    bool* mValid;
+    // Start of a burst and stop of the pool
+    std::mutex mLock;
+    std::condition_variable mWake;
+    uint64_t mBurst;
+    bool mStop;
+    std::atomic<uint32_t> mFinished;
+    // Fixed cost of one report in bytes when the chunks are cut
+    static const size_t cReportOverhead = 256;
+    static const uint32_t cChunksPerWorker = 8;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <algorithm>
+#include <random>
+using namespace std;
+
+#include "VerificationTester.h"
+#include "SweepTester.h"
+#include "Random.h"
+
+VerificationTester::VerificationTester(uint32_t Iterations,
+                                       string& Logfile,
+                                       string& Key,
+                                       string& Nonce,
+                                       uint32_t HeaderSize,
+                                       uint32_t MinMessageSize,
+                                       uint32_t MaxMessageSize,
+                                       uint32_t Reports,
+                                       uint32_t Threads,
+                                       ICEScheme* CE):
+    Tester(Iterations, Logfile),
+    mKey(Key),
+    mNonce(Nonce),
+    mHeaderSize(HeaderSize),
+    mThreads(Threads),
+    mReportBytes(0),
+    mRandom(""),
+    mCE(CE)
+{
+    if (Reports == 0 || mThreads == 0)
+    {
+        throw runtime_error("Need reports and threads above 0 for the verification test");
+    }
+    // Mixed message sizes in a random order, the engine groups them by size
+    vector<uint32_t> Sizes = SweepTester::GeometricGrid(MinMessageSize, MaxMessageSize, 2);
+    vector<uint32_t> ReportSizes(Reports);
+    for (uint32_t i = 0; i < Reports; i++)
+    {
+        ReportSizes[i] = Sizes[i % Sizes.size()];
+    }
+    random_device Device;
+    mt19937_64 Generator(((uint64_t)Device() << 32) | Device());
+    shuffle(ReportSizes.begin(), ReportSizes.end(), Generator);
+    mRandom = RandomGenerator::Generate(max(MaxMessageSize, mHeaderSize));
+    // Frank every report once, the opening key comes from the decryption
+    mKeyfs.resize(Reports);
+    mC2.resize((size_t)Reports * mCE->GetCommitmentSize());
+    mValid.reset(new bool[Reports]);
+    string C1, C2, Message;
+    mCE->SetNonce(mNonce);
+    for (uint32_t i = 0; i < Reports; i++)
+    {
+        string Header(mRandom, 0, mHeaderSize);
+        string Input(mRandom, 0, ReportSizes[i]);
+        mCE->Enc(mKey, Header, Input, C1, C2);
+        if (!mCE->Dec(mKey, Header, C1, C2, Message, mKeyfs[i]) || C2.size() != mCE->GetCommitmentSize())
+        {
+            throw runtime_error("Setup of the reports failed.");
+        }
+        mC2.replace((size_t)i * C2.size(), C2.size(), C2);
+        mHeaders.push_back((const unsigned char*)mRandom.data());
+        mHeaderLengths.push_back(mHeaderSize);
+        mMessages.push_back((const unsigned char*)mRandom.data());
+        mMessageLengths.push_back(ReportSizes[i]);
+        mReportBytes += mHeaderSize + ReportSizes[i];
+        IncreaseString(mNonce);
+        mCE->SetNonce(mNonce);
+    }
+    // Make gap for the Log
+    HandleOutput("", false);
+    HandleOutput("", false);
+    // Log the class description for the scheme to test
+    HandleOutput("Verification scheme: " + mCE->GetClassDecription() +
+                 " with up to " + to_string(mThreads) + " threads", true);
+    // Log the given parameter sizes
+    HandleOutput("Key size: " + to_string(mKey.size()), false);
+    HandleOutput("None size: " + to_string(mNonce.size()), false);
+    HandleOutput("Header size: " + to_string(mHeaderSize), false);
+    HandleOutput("Message sizes: " + to_string(Sizes.front()) + " to " +
+                 to_string(Sizes.back()) + " (" + to_string(Sizes.size()) + " sizes)", false);
+    HandleOutput("Reports per burst: " + to_string(Reports), false);
+}
+
+bool VerificationTester::TestRound()
+{
+    size_t Reports = mKeyfs.size();
+    StartTime(0);
+    size_t Valid = mEngine->Verify(Reports, mHeaders.data(), mHeaderLengths.data(),
+                                   mMessages.data(), mMessageLengths.data(), mKeyfs.data(),
+                                   (const unsigned char*)mC2.data(), mValid.get());
+    AddTime(0);
+    if (Valid != Reports)
+    {
+        HandleOutput("Verification has failed for " + to_string(Reports - Valid) + " reports");
+        return false;
+    }
+    return true;
+}
+
+bool VerificationTester::Run()
+{
+    HandleOutput("");
+    double BaseRate = 0.0;
+    for (uint32_t Threads = 1; Threads <= mThreads; Threads++)
+    {
+        if (!RunThreads(Threads, BaseRate))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VerificationTester::RunThreads(uint32_t Threads, double& BaseRate)
+{
+    mEngine.reset(new VerificationEngine(*mCE, Threads));
+    // Rounds to warm up, not measured
+    for (uint32_t i = 0; i < max<uint32_t>(GetWarmup(), 1); i++)
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+    }
+    ResetTime();
+    uint64_t Steals = 0;
+    for (uint32_t i = 0; i < GetTestIterations(); i++)
+    {
+        if (!TestRound())
+        {
+            return false;
+        }
+        Steals += mEngine->GetSteals();
+    }
+    // The mean time is for a whole burst
+    double Seconds = GetHistogram(0).GetMean() / 1e9;
+    double ReportsPerSecond = Seconds > 0.0 ? mKeyfs.size() / Seconds : 0.0;
+    if (BaseRate == 0.0)
+    {
+        BaseRate = ReportsPerSecond;
+    }
+    double Speedup = BaseRate > 0.0 ? ReportsPerSecond / BaseRate : 0.0;
+    HandleOutput("Threads: " + to_string(Threads) + " - Verification: " + to_string(ReportsPerSecond) +
+                 " reports/s, " + to_string(Seconds > 0.0 ? mReportBytes / Seconds / 1e9 : 0.0) +
+                 " GB/s, speedup: " + to_string(Speedup) + ", steals per burst: " +
+                 to_string((double)Steals / max<uint32_t>(GetTestIterations(), 1)));
+    ResultRecord Record = CreateRecord("verify", mCE, mHeaderSize, mReportBytes / mKeyfs.size() - mHeaderSize,
+                                       mKey.size(), mNonce.size(), GetTestIterations(), Threads);
+    Record.Add("reports", (uint64_t)mKeyfs.size());
+    Record.AddPhase("ver", GetHistogram(0), 0, 0);
+    Record.Add("reports_per_s", ReportsPerSecond);
+    Record.Add("speedup", Speedup);
+    WriteResult(Record);
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef VERIFICATIONTESTER_H
+#define VERIFICATIONTESTER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Tester.h"
+#include "VerificationEngine.h"
+
+/// \brief VerificationTester class which tests the VerificationEngine with bursts of reports
+/// \details The reports are franked once with random messages of mixed sizes, the
+/// sizes are a geometric grid from the minimal to the maximal message size in a
+/// random order. Every burst verifies all reports with the engine, which is tested
+/// on 1 up to N threads. The reports per second and the speedup over one thread
+/// show how the verification scales across cores.
+class VerificationTester: public Tester
+{
+public:
+	/// \brief Construct a VerificationTester
+	/// \param Iterations number of bursts for one thread count
+	/// \param Logfile path of the logfile
+	/// \param Key for the scheme to test
+	/// \param Nonce for the scheme to test
+	/// \param HeaderSize size of every header in bytes
+	/// \param MinMessageSize size of the smallest message in bytes
+	/// \param MaxMessageSize size of the largest message in bytes
+	/// \param Reports number of reports of one burst
+	/// \param Threads the test is done for 1 up to this many threads
+	/// \param CE reference to the scheme to test
+    VerificationTester(uint32_t Iterations,
+                       std::string& Logfile,
+                       std::string& Key,
+                       std::string& Nonce,
+                       uint32_t HeaderSize,
+                       uint32_t MinMessageSize,
+                       uint32_t MaxMessageSize,
+                       uint32_t Reports,
+                       uint32_t Threads,
+                       ICEScheme* CE);
+    /// \brief Destruct a VerificationTester
+    /// \details Need to delete the scheme provided by the SchemeFactory
+    ~VerificationTester()
+    {
+        mEngine.reset();
+        delete mCE;
+    }
+    /// \brief Verifies one burst with the engine and measures time
+    bool TestRound();
+    /// \brief Tests 1 up to N threads and logs the reports per second
+    bool Run();
+
+private:
+	/// \brief Tests one thread count
+	/// \param Threads number of threads of the engine
+	/// \param BaseRate reports per second of one thread, 0 for the first run
+    bool RunThreads(uint32_t Threads, double& BaseRate);
+
+    std::string mKey;
+    std::string mNonce;
+    uint32_t mHeaderSize;
+    uint32_t mThreads;
+    uint64_t mReportBytes;
+    // Random data, the messages and headers are prefixes of it
+    std::string mRandom;
+    std::vector<const unsigned char*> mHeaders;
+    std::vector<size_t> mHeaderLengths;
+    std::vector<const unsigned char*> mMessages;
+    std::vector<size_t> mMessageLengths;
+    std::vector<std::string> mKeyfs;
+    std::string mC2;
+    std::unique_ptr<bool[]> mValid;
+    std::unique_ptr<VerificationEngine> mEngine;
+    ICEScheme* mCE;
+};
+
+#endif
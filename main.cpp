@@ -3,6 +3,7 @@ using namespace std;
 
 #include "ConfigParser.h"
 #include "Tester.h"
+#include "RandomBuffer.h"
 
 int main(int argc, char** argv)
 {
@@ -20,29 +21,15 @@ int main(int argc, char** argv)
         string InputFile(argv[1]);
         // Parse the second argument
         ConfigParser Parser;
-        SchemeTester* Test = NULL;
+        Tester* Test = NULL;
         Test = Parser.ReadConfig(InputFile);
         Test->PrintCommand(argc, argv);
-        // Get the number of iterations from the Tester
-        uint32_t Iterations = Test->GetTestIterations();
-        uint32_t i = 0;
-        // Test the scheme with the Tester
-        for (i = 1; Test->TestRound() && i < Iterations; i++);
-        // Check if every run was successful
-        if (i != Iterations)
+        // Test the scheme and print the times from the tester
+        Test->Run();
+        if (RandomBuffer::IsRunning())
         {
-            string Output = string("Only ") + to_string(i) + " out of " 
-                            + to_string(Iterations) + " were successful.";
-            Test->HandleOutput(Output);
+            Test->HandleOutput(RandomBuffer::GetReport());
         }
-        // Print the times from the tester
-        // ToDo: Put the handling into the tester
-        Test->HandleOutput("");
-        Test->PrintTime(i, 0, "Encryption");
-        Test->HandleOutput("");
-        Test->PrintTime(i, 1, "Decryption");
-        Test->HandleOutput("");
-        Test->PrintTime(i, 2, "Verification");
         delete Test;
     }
     catch (const exception& e)